@@ -1,6 +1,8 @@
 % FILTERS
 %
 % Files
+%   apodbank     - F = apodbank(type, dims, p1, p2, echopos)
+%   apodize      - k = apodize(k, F)
 %   csihamming2d - kh = csihamming2d(dims, Rf)
 %   fermi        - H = fermi(n, fr, fw, tails)
 %   fermi2       - H = fermi2(dims, fr, fw, echopos)
@@ -20,3 +22,4 @@
 %   lorentz2     - H = lorentz2(dims, Rf)
 %   medianfilt   - y = medianfilt(x, w)
 %   movmed       - SYNTAX: sm = movmed(s,k)
+%   nlmeans      - [B, sigma] = nlmeans(A, sigma, opts)
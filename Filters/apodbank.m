@@ -0,0 +1,213 @@
+function F = apodbank(type, dims, p1, p2, echopos)
+% F = apodbank(type, dims, p1, p2, echopos)
+%
+% Return a cached k-space apodization kernel for use with apodize().
+%
+% Separable windows (gauss, fermi) are held as one 1D factor per
+% dimension, shaped for broadcasting, so the full window is never
+% formed. Radial windows with a clamped radius (hamming, hanning,
+% csihamming) are not separable and are built once as a full real
+% array from the 1D coordinate vectors. Kernels are memoized by type,
+% dimensions and parameters in a bounded LRU, so repeated scans with
+% the same matrix size reuse the same kernel.
+%
+% apodbank('clear') empties the bank.
+%
+% ARGS:
+% type    = 'gauss', 'fermi', 'hamming', 'hanning' or 'csihamming'
+% dims    = k-space dimensions (2D or 3D), [nf nx ny] for 'csihamming'
+% p1      = gauss   : PSF FWHM in voxels [1.0]
+%           fermi   : fractional filter radius in each dimension [0.5]
+%           hamming : fractional filter radius in each dimension [0.5]
+%           hanning : filter radius in each dimension in voxels [dims/2]
+% p2      = fermi   : fractional transition width in each dimension [0.05]
+% echopos = fractional echo position in each dimension, scalar for the
+%           first dimension only [0.5]. Unused by hanning and csihamming
+%
+% RETURNS:
+% F = kernel structure
+%     .type = window type
+%     .dims = k-space dimensions
+%     .sep  = 1D factors for each dimension (separable windows) or {}
+%     .H    = full real window (radial windows) or []
+%
+% AUTHOR : Mike Tyszka, Ph.D.
+% PLACE  : Caltech BIC
+% DATES  : 10/19/2026 JMT From scratch
+%
+% The MIT License (MIT)
+%
+% Copyright (c) 2016 Mike Tyszka
+%
+%   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+%   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+%   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+%   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+%
+%   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+%   Software.
+%
+%   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+%   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+%   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+%   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+persistent cache tick
+
+% Bank limits
+maxn     = 16;     % Maximum number of cached kernels (LRU)
+maxbytes = 2^28;   % Maximum total size of cached kernels
+
+if isempty(cache)
+  cache = struct('key', {}, 'F', {}, 'bytes', {}, 'used', {});
+  tick = 0;
+end
+
+if nargin == 1 && ischar(type)
+  switch lower(type)
+    case 'clear'
+      cache = [];
+    otherwise
+      fprintf('apodbank: unknown command %s\n', type);
+  end
+  F = [];
+  return
+end
+
+if nargin < 3; p1 = []; end
+if nargin < 4; p2 = []; end
+if nargin < 5; echopos = []; end
+
+type = lower(type);
+dims = dims(:)';
+
+key = sprintf('%s:%s', type, sprintf('%.17g,', dims, NaN, p1, NaN, p2, NaN, echopos));
+
+% Look up kernel, building it if necessary
+k = find(strcmp({cache.key}, key), 1);
+
+if isempty(k)
+
+  F = build_kernel(type, dims, p1, p2, echopos);
+
+  s = whos('F');
+  bytes = s.bytes;
+
+  % Evict least recently used kernels until this one fits
+  while ~isempty(cache) && (length(cache) >= maxn || sum([cache.bytes]) + bytes > maxbytes)
+    [~, j] = min([cache.used]);
+    cache(j) = [];
+  end
+
+  k = length(cache) + 1;
+  cache(k).key   = key;
+  cache(k).F     = F;
+  cache(k).bytes = bytes;
+
+end
+
+tick = tick + 1;
+cache(k).used = tick;
+
+F = cache(k).F;
+
+%------------------------------------------------------------
+% Construct a kernel from its 1D coordinate vectors
+%------------------------------------------------------------
+function F = build_kernel(type, dims, p1, p2, echopos)
+
+nd = length(dims);
+
+F.type = type;
+F.dims = dims;
+F.sep  = {};
+F.H    = [];
+
+% Fractional echo position in each dimension
+ep = 0.5 * ones(1, nd);
+if ~isempty(echopos)
+  ep(1:length(echopos)) = echopos;
+end
+
+switch type
+
+  case 'gauss'
+
+    if isempty(p1); p1 = 1.0; end
+
+    % Radial Gaussian is the product of 1D Gaussians
+    Rf = 2 * pi * p1 / sqrt(8 * log(2));
+    for d = 1:nd
+      F.sep{d} = shape_dim(exp(-0.5 * (kcoord(dims(d), ep(d)) * Rf).^2), d);
+    end
+
+  case 'fermi'
+
+    if isempty(p1); p1 = 0.5; end
+    if isempty(p2); p2 = 0.05; end
+    fr = p1 .* ones(1, nd);
+    fw = p2 .* ones(1, nd);
+
+    % Adjust the filter radius for the echo position
+    fr(1) = 2 * (0.5 + abs(ep(1) - 0.5)) * fr(1);
+
+    for d = 1:nd
+      F.sep{d} = shape_dim(1 ./ (1 + exp((abs(kcoord(dims(d), ep(d))) - fr(d)) / fw(d))), d);
+    end
+
+  case 'hamming'
+
+    if isempty(p1); p1 = 0.5; end
+    Rf = p1 .* ones(1, nd);
+
+    r = radius(dims, @(d) kcoord(dims(d), ep(d)) / Rf(d));
+    F.H = 0.54 + 0.46 * cos(pi * r);
+
+  case 'hanning'
+
+    if isempty(p1); p1 = dims / 2; end
+    radii = p1 .* ones(1, nd);
+
+    r = radius(dims, @(d) kcoord(dims(d), 0.5) * dims(d) / radii(d));
+    F.H = 0.5 * (1 + cos(pi * r));
+
+  case 'csihamming'
+
+    % Radial Hamming over the spatial dimensions, broadcast over frequency
+    sdims = dims(2:end);
+    r = radius(sdims, @(d) kcoord(sdims(d), 0.5));
+    F.H = reshape(0.54 + 0.46 * cos(pi * r), [1 sdims]);
+
+  otherwise
+
+    error('apodbank: unknown window type %s', type);
+
+end
+
+%------------------------------------------------------------
+% Normalized voxel center coordinates (as voxelgrid, unit FOV)
+%------------------------------------------------------------
+function x = kcoord(n, echopos)
+
+x = ((1:n) - 0.5) / n - echopos;
+
+%------------------------------------------------------------
+% Reshape a 1D factor to lie along dimension d
+%------------------------------------------------------------
+function v = shape_dim(v, d)
+
+sz = ones(1, max(d, 2));
+sz(d) = length(v);
+v = reshape(v, sz);
+
+%------------------------------------------------------------
+% Radius clamped to 1 from scaled coordinate vectors
+%------------------------------------------------------------
+function r = radius(dims, coordfn)
+
+r2 = 0;
+for d = 1:length(dims)
+  r2 = bsxfun(@plus, r2, shape_dim(coordfn(d).^2, d));
+end
+
+r = min(sqrt(r2), 1);
@@ -0,0 +1,52 @@
+function k = apodize(k, F)
+% k = apodize(k, F)
+%
+% Apply a cached apodization kernel from apodbank() to k-space data.
+%
+% Separable kernels are applied as one broadcast multiply per 1D factor
+% and radial kernels as a single broadcast multiply, so neither the full
+% window nor a replicated copy is formed. Trailing dimensions of k beyond
+% the kernel dimensions (slices, echoes, coils) share the same window.
+%
+% With k empty the full real window is returned, for callers that need
+% the window itself.
+%
+% ARGS:
+% k = k-space data
+% F = kernel structure from apodbank
+%
+% RETURNS:
+% k = apodized k-space data, or the full window if k is empty
+%
+% AUTHOR : Mike Tyszka, Ph.D.
+% PLACE  : Caltech BIC
+% DATES  : 10/19/2026 JMT From scratch
+%
+% The MIT License (MIT)
+%
+% Copyright (c) 2016 Mike Tyszka
+%
+%   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+%   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+%   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+%   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+%
+%   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+%   Software.
+%
+%   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+%   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+%   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+%   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+if isempty(k)
+  k = ones([F.dims 1]);
+end
+
+if isempty(F.sep)
+  k = bsxfun(@times, k, F.H);
+else
+  for d = 1:length(F.sep)
+    k = bsxfun(@times, k, F.sep{d});
+  end
+end
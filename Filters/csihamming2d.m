@@ -10,6 +10,7 @@ function kh = csihamming2d(k)
 % AUTHOR : Mike Tyszka, Ph.D.
 % PLACE  : Caltech Biological Imaging Center
 % DATES  : 01/29/2004 JMT 
+%          10/19/2026 JMT Build from the cached apodbank kernel
 %
 % The MIT License (MIT)
 %
@@ -33,25 +34,6 @@ if nargin < 1
   return;
 end
 
-% Copy k-space
-kh = k;
-
-% Construct a spatial radius matrix
+% Cached radial Hamming over the spatial dimensions, broadcast over frequency
 [nf,nx,ny] = size(k);
-FOV        = [1 1];
-Offset     = -FOV/2; 
-[xc,yc] = voxelgrid2([nx ny], [1 1], [-0.5 -0.5]);
-
-r = sqrt(xc.*xc + yc.*yc);
-
-% Clamp radius to <= 1
-r(r > 1) = 1;
-
-% Construct 3D Hamming filter matrix
-H = 0.54 + 0.46 * cos(pi * r);
-
-% Replicate in f dimension
-H = repmat(reshape(H,[1 nx ny]),[nf 1 1]);
-
-% Apply filter
-kh = k .* H;
+kh = apodize(k, apodbank('csihamming', [nf nx ny]));
@@ -12,6 +12,7 @@ function H = gauss3(dims, FWHM, echopos)
 % PLACE  : Caltech Biological Imaging Center
 % DATES  : 06/24/2003 JMT Adapt from hamming2.m (JMT)
 %          03/12/2009 JMT Switch to PSF FWHM specification
+%          10/19/2026 JMT Build from the cached apodbank kernel
 %
 % The MIT License (MIT)
 %
@@ -41,18 +42,5 @@ switch length(echopos)
   otherwise
 end
 
-% Calculate the fractional radius of the k-space Gaussian filter function
-% corresponding to the PSF FWHM provided.
-% Assumes normalized k-space coordinates run from -0.5 to 0.5
-Rf = 2 * pi * FWHM / sqrt(8 * log(2));
-
-% Construct a spatial radius matrix
-% Note that if x-space has voxel dimension, then k-space has a FOV of 1 in
-% each dimension
-FOV = [1 1 1];
-Offset = -echopos; 
-[xc,yc,zc] = voxelgrid(dims, FOV, Offset);
-k = sqrt(xc.*xc + yc.*yc + zc.*zc);
-
-% Construct 3D Gaussian filter
-H = exp(-0.5 * (k * Rf).^2);
+% Cached separable Gaussian, expanded to the full window
+H = apodize([], apodbank('gauss', dims, FWHM, [], echopos));
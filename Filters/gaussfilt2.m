@@ -1,15 +1,23 @@
-function b = gaussfilt2(a,FWHM)
-% b = gaussfilt2(a,fwhm)
+function b = gaussfilt2(a,FWHM,method,nthreads)
+% b = gaussfilt2(a,fwhm,method,nthreads)
 %
-% Apply a Gaussian spatial filter in the Fourier domain
+% Apply a Gaussian spatial filter
+%
+% The default recursive filter (gaussfilt_mex) smooths each dimension
+% in turn in O(N) time for any FWHM, replicating edge pixels. The
+% Fourier domain filter treats the image as periodic and is used if
+% the MEX is not compiled.
 %
 % ARGS:
 % a = original 2D image
-% w = FWHM of gaussian blur in pixels
+% FWHM = FWHM of gaussian blur in pixels [1.0]
+% method = 'recursive' or 'fft' ['recursive']
+% nthreads = number of threads for gaussfilt_mex, 0 for all processors [0]
 %
 % AUTHOR : Mike Tyszka, Ph.D.
 % PLACE  : Caltech Biological Imaging Center
 % DATES  : 11/28/2006 JMT From scratch
+%          10/19/2026 JMT Add separable recursive filter
 %
 % The MIT License (MIT)
 %
@@ -30,7 +38,19 @@ function b = gaussfilt2(a,FWHM)
 
 verbose = 0;
 
-if nargin < 2;  w = 1; end
+if nargin < 2; FWHM = 1.0; end
+if nargin < 3; method = 'recursive'; end
+if nargin < 4; nthreads = 0; end
+
+if strcmp(method, 'recursive') && exist('gaussfilt_mex','file') == 3
+
+  % Separable recursive filter in single or double precision
+  if ~isa(a,'single'), a = double(a); end
+  sigma = FWHM / sqrt(8 * log(2));
+  b = gaussfilt_mex(real(a), sigma * [1 1], nthreads);
+  return
+
+end
 
 Rf = 2 * pi * FWHM / sqrt(8 * log(2));
 
@@ -0,0 +1,375 @@
+/************************************************************
+ * C source for gaussfilt_mex MEX object
+ *
+ * SYNTAX: b = gaussfilt_mex(a, sigma)
+ *         b = gaussfilt_mex(a, sigma, nthreads)
+ *
+ * Separable Gaussian smoothing of an N-D array along each dimension
+ * d with sigma(d) > 0. Each 1D pass is the fourth order recursive
+ * (IIR) Gaussian of Deriche, the sum of a causal and an anticausal
+ * filter, so the cost per sample is independent of sigma. Both
+ * filters start from the steady state for a constant extension, which
+ * replicates the edge samples exactly. The recursive approximation
+ * degrades below sigma = 0.5, so narrower kernels use a direct sampled
+ * Gaussian (radius 4 sigma) with the same edge replication.
+ *
+ * Lines along the strided dimensions are filtered in blocks of
+ * neighboring lines, which are contiguous in memory, and blocks are
+ * distributed over POSIX threads. Arithmetic is in double precision
+ * for both single and double data.
+ *
+ * a        = real single or double N-D array
+ * sigma    = Gaussian standard deviation in samples for each
+ *            dimension, 0 to leave a dimension unfiltered
+ * nthreads = number of threads, 0 for all processors [0]
+ *
+ * b        = filtered array, same size and class as a
+ *
+ * BUILD  : mex -I../RelaxFit gaussfilt_mex.c
+ *
+ * AUTHOR : Mike Tyszka, Ph.D.
+ * PLACE  : Caltech BIC
+ * DATES  : 10/19/2026 JMT From scratch
+ * REFS   : Deriche R. INRIA Research Report 1893, 1993
+ *          Farneback G, Westin CF. Technical Report LiTH-ISY-R-2742, 2006
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Mike Tyszka
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ *   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ *   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ *   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ *   Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ *   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ *   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ************************************************************/
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include "mex.h"
+
+#include "voxthreads.h"
+
+/* Input Arguments */
+
+#define	A_IN        prhs[0]
+#define	SIGMA_IN    prhs[1]
+#define	NTHREADS_IN prhs[2]
+
+/* Output Arguments */
+
+#define	B_OUT       plhs[0]
+
+/* Lines per block along strided dimensions */
+#define GF_BLOCK    32
+
+/* Smallest sigma for the recursive filter */
+#define GF_SIGMA_IIR 0.5
+
+typedef struct {
+  void *b;
+  int single;
+  size_t inner;        /* stride of the filtered dimension */
+  int n;               /* samples per line */
+  size_t outer;        /* product of later dimensions */
+  int nblk;            /* blocks of lines per outer index */
+  int iir;
+  double np[4];        /* causal feedforward coefficients */
+  double nm[4];        /* anticausal feedforward coefficients */
+  double d[4];         /* shared feedback coefficients */
+  double sp, sm;       /* causal and anticausal steady state gains */
+  int r;               /* direct kernel radius */
+  double *h;           /* direct kernel, 2r+1 taps */
+  double *work[VOX_MAXTHREADS];
+} gf_context;
+
+static void gf_coeffs(gf_context *, double);
+static void gf_worker(void *, int, int, int);
+
+/************************************************************
+ * Entry point for MEX call
+ ************************************************************/
+void mexFunction(int nlhs, mxArray *plhs[],
+		 int nrhs, const mxArray *prhs[])
+{
+  gf_context ctx;
+  const mwSize *dims;
+  const double *sigma;
+  size_t nel;
+  int ndims, nsig, d, t, nthreads, npass, ntask, ok;
+
+  /* Check for proper number of arguments */
+
+  if (nrhs < 2 || nrhs > 3 || nlhs > 1) {
+    mexErrMsgTxt("SYNTAX: b = gaussfilt_mex(a,sigma[,nthreads])");
+  }
+
+  if (mxIsComplex(A_IN) || !(mxIsDouble(A_IN) || mxIsSingle(A_IN)))
+    mexErrMsgTxt("gaussfilt_mex : a must be real single or double");
+
+  if (!mxIsDouble(SIGMA_IN))
+    mexErrMsgTxt("gaussfilt_mex : sigma must be double");
+
+  ndims = (int)mxGetNumberOfDimensions(A_IN);
+  dims = mxGetDimensions(A_IN);
+  nel = mxGetNumberOfElements(A_IN);
+  sigma = mxGetPr(SIGMA_IN);
+  nsig = (int)mxGetNumberOfElements(SIGMA_IN);
+
+  ctx.single = mxIsSingle(A_IN);
+  B_OUT = mxCreateNumericArray(ndims, dims, mxGetClassID(A_IN), mxREAL);
+  ctx.b = mxGetData(B_OUT);
+  memcpy(ctx.b, mxGetData(A_IN), nel * (ctx.single ? sizeof(float) : sizeof(double)));
+
+  if (nel < 1) return;
+
+  nthreads = vox_nthreads((nrhs > 2) ? (int)mxGetScalar(NTHREADS_IN) : 0);
+
+  /* In place separable passes */
+  ctx.inner = 1;
+  for (d = 0; d < ndims; d++) {
+
+    ctx.n = (int)dims[d];
+    ctx.outer = nel / (ctx.inner * dims[d]);
+
+    if (d < nsig && sigma[d] > 0.0 && ctx.n > 1) {
+
+      gf_coeffs(&ctx, sigma[d]);
+      if (!ctx.iir && ctx.h == NULL) mexErrMsgTxt("gaussfilt_mex : out of memory");
+
+      ctx.nblk = (int)((ctx.inner + GF_BLOCK - 1) / GF_BLOCK);
+      ntask = ctx.nblk * (int)ctx.outer;
+
+      npass = nthreads;
+      if (npass > (ntask + VOX_MINCHUNK - 1) / VOX_MINCHUNK)
+	npass = (ntask + VOX_MINCHUNK - 1) / VOX_MINCHUNK;
+
+      /* Per-thread line block, padded for the direct kernel, and result */
+      ok = 1;
+      for (t = 0; t < npass; t++) {
+	ctx.work[t] = (double *)malloc((size_t)(2 * ctx.n + 2 * ctx.r) * GF_BLOCK * sizeof(double));
+	if (ctx.work[t] == NULL) ok = 0;
+      }
+
+      if (ok) vox_parallel(ntask, npass, gf_worker, &ctx);
+
+      for (t = 0; t < npass; t++) free(ctx.work[t]);
+      free(ctx.h);
+
+      if (!ok) mexErrMsgTxt("gaussfilt_mex : out of memory");
+    }
+
+    ctx.inner *= dims[d];
+  }
+
+  return;
+}
+
+/************************************************************
+ * Filter coefficients for standard deviation sigma
+ ************************************************************/
+static void gf_coeffs(gf_context *ctx, double sigma)
+{
+  /* Deriche fit of exp(-x^2/2) by two damped cosine pairs */
+  const double a1 = 1.6800, b1 = 3.7350, w1 = 0.6318, l1 = 1.7830;
+  const double a2 = -0.6803, b2 = -0.2598, w2 = 1.9970, l2 = 1.7230;
+  double e1, e2, c1, s1, c2, s2, *n, *m, *d, sn, sm, sd, sum;
+  int i;
+
+  ctx->h = NULL;
+  ctx->r = 0;
+  ctx->iir = (sigma >= GF_SIGMA_IIR);
+
+  if (ctx->iir) {
+
+    n = ctx->np;
+    m = ctx->nm;
+    d = ctx->d;
+
+    e1 = exp(-l1 / sigma);
+    e2 = exp(-l2 / sigma);
+    c1 = cos(w1 / sigma);
+    s1 = sin(w1 / sigma);
+    c2 = cos(w2 / sigma);
+    s2 = sin(w2 / sigma);
+
+    n[0] = a1 + a2;
+    n[1] = e2 * (b2 * s2 - (a2 + 2.0 * a1) * c2) + e1 * (b1 * s1 - (a1 + 2.0 * a2) * c1);
+    n[2] = 2.0 * e1 * e2 * ((a1 + a2) * c2 * c1 - b1 * c2 * s1 - b2 * c1 * s2)
+      + a2 * e1 * e1 + a1 * e2 * e2;
+    n[3] = e2 * e1 * e1 * (b2 * s2 - a2 * c2) + e1 * e2 * e2 * (b1 * s1 - a1 * c1);
+
+    d[0] = -2.0 * e2 * c2 - 2.0 * e1 * c1;
+    d[1] = 4.0 * c2 * c1 * e1 * e2 + e2 * e2 + e1 * e1;
+    d[2] = -2.0 * c1 * e1 * e2 * e2 - 2.0 * c2 * e2 * e1 * e1;
+    d[3] = e1 * e1 * e2 * e2;
+
+    /* Anticausal coefficients from the symmetry of the kernel */
+    for (i = 0; i < 3; i++) m[i] = n[i+1] - d[i] * n[0];
+    m[3] = -d[3] * n[0];
+
+    /* Unit DC gain */
+    sn = sm = 0.0;
+    sd = 1.0;
+    for (i = 0; i < 4; i++) {
+      sn += n[i];
+      sm += m[i];
+      sd += d[i];
+    }
+    sum = (sn + sm) / sd;
+    for (i = 0; i < 4; i++) {
+      n[i] /= sum;
+      m[i] /= sum;
+    }
+    ctx->sp = sn / sum / sd;
+    ctx->sm = sm / sum / sd;
+
+  } else {
+
+    /* Normalized sampled Gaussian */
+    ctx->r = (int)ceil(4.0 * sigma);
+    ctx->h = (double *)malloc((2 * ctx->r + 1) * sizeof(double));
+    if (ctx->h == NULL) return;
+    sum = 0.0;
+    for (i = -ctx->r; i <= ctx->r; i++) {
+      ctx->h[i + ctx->r] = exp(-0.5 * i * i / (sigma * sigma));
+      sum += ctx->h[i + ctx->r];
+    }
+    for (i = 0; i <= 2 * ctx->r; i++) ctx->h[i] /= sum;
+  }
+}
+
+/************************************************************
+ * Recursive filter over nl interleaved lines of x, x[i * nl + j]
+ * is sample i of line j, with the inner loops running across
+ * lines. Samples beyond either end repeat the edge sample.
+ * Result in y, which must not overlap x.
+ ************************************************************/
+static void gf_iir(const gf_context *ctx, const double *x, double *y, int n, int nl)
+{
+  const double *np = ctx->np, *nm = ctx->nm, *d = ctx->d;
+  double hp[4][GF_BLOCK], *h[4], *t;
+  const double *xr[4], *yr[4];
+  int i, j, k;
+
+  /* Anticausal pass into y from the steady state after the last sample */
+  for (j = 0; j < nl; j++) hp[0][j] = ctx->sm * x[(size_t)(n - 1) * nl + j];
+
+  for (i = n - 1; i >= 0; i--) {
+    for (k = 0; k < 4; k++) {
+      xr[k] = x + (size_t)((i + k + 1 < n) ? i + k + 1 : n - 1) * nl;
+      yr[k] = (i + k + 1 < n) ? y + (size_t)(i + k + 1) * nl : hp[0];
+    }
+    t = y + (size_t)i * nl;
+    for (j = 0; j < nl; j++)
+      t[j] = nm[0] * xr[0][j] + nm[1] * xr[1][j] + nm[2] * xr[2][j] + nm[3] * xr[3][j]
+	- d[0] * yr[0][j] - d[1] * yr[1][j] - d[2] * yr[2][j] - d[3] * yr[3][j];
+  }
+
+  /* Causal pass added to y, history in a ring of four rows */
+  for (k = 0; k < 4; k++)
+    for (j = 0; j < nl; j++) hp[k][j] = ctx->sp * x[j];
+
+  for (i = 0; i < n; i++) {
+    for (k = 0; k < 4; k++) {
+      xr[k] = x + (size_t)((i - k > 0) ? i - k : 0) * nl;
+      h[k] = hp[(i - 1 - k + 4 * n) % 4];
+    }
+    t = h[3];
+    for (j = 0; j < nl; j++) {
+      double v = np[0] * xr[0][j] + np[1] * xr[1][j] + np[2] * xr[2][j] + np[3] * xr[3][j]
+	- d[0] * h[0][j] - d[1] * h[1][j] - d[2] * h[2][j] - d[3] * h[3][j];
+      t[j] = v;
+      y[(size_t)i * nl + j] += v;
+    }
+  }
+}
+
+/************************************************************
+ * Direct sampled Gaussian over nl interleaved lines, with r
+ * replicated samples at each end of the block buffer w
+ ************************************************************/
+static void gf_fir(const gf_context *ctx, double *w, int n, int nl)
+{
+  const double *h = ctx->h;
+  double *x = w + (size_t)ctx->r * nl, *y = w, acc[GF_BLOCK];
+  int r = ctx->r, i, j, t;
+
+  /* Replicate edges into the padding */
+  for (i = 1; i <= r; i++) {
+    for (j = 0; j < nl; j++) {
+      x[-(ptrdiff_t)i * nl + j] = x[j];
+      x[(size_t)(n - 1 + i) * nl + j] = x[(size_t)(n - 1) * nl + j];
+    }
+  }
+
+  /* Output overwrites samples no longer needed */
+  for (i = 0; i < n; i++) {
+    for (j = 0; j < nl; j++) acc[j] = 0.0;
+    for (t = -r; t <= r; t++) {
+      const double *q = x + (ptrdiff_t)(i + t) * nl;
+      for (j = 0; j < nl; j++) acc[j] += h[t + r] * q[j];
+    }
+    for (j = 0; j < nl; j++) y[(size_t)i * nl + j] = acc[j];
+  }
+}
+
+/************************************************************
+ * Filter line blocks [k0, k1) on thread tid. Block k covers
+ * outer index k / nblk and up to GF_BLOCK consecutive inner
+ * indices, contiguous in memory for every sample
+ ************************************************************/
+static void gf_worker(void *arg, int k0, int k1, int tid)
+{
+  gf_context *ctx = (gf_context *)arg;
+  double *w = ctx->work[tid], *x, *y;
+  size_t inner = ctx->inner, base, i0;
+  int n = ctx->n, k, i, j, nl;
+
+  for (k = k0; k < k1; k++) {
+
+    i0 = (size_t)(k % ctx->nblk) * GF_BLOCK;
+    nl = (inner - i0 < GF_BLOCK) ? (int)(inner - i0) : GF_BLOCK;
+    base = (size_t)(k / ctx->nblk) * inner * n + i0;
+
+    /* Gather past the direct kernel padding */
+    x = w + (size_t)ctx->r * nl;
+    if (ctx->single) {
+      const float *b = (const float *)ctx->b + base;
+      for (i = 0; i < n; i++)
+	for (j = 0; j < nl; j++) x[(size_t)i * nl + j] = b[(size_t)i * inner + j];
+    } else {
+      const double *b = (const double *)ctx->b + base;
+      for (i = 0; i < n; i++)
+	for (j = 0; j < nl; j++) x[(size_t)i * nl + j] = b[(size_t)i * inner + j];
+    }
+
+    if (ctx->iir) {
+      y = w + (size_t)n * nl;
+      gf_iir(ctx, w, y, n, nl);
+    } else {
+      y = w;
+      gf_fir(ctx, w, n, nl);
+    }
+
+    /* Scatter */
+    if (ctx->single) {
+      float *b = (float *)ctx->b + base;
+      for (i = 0; i < n; i++)
+	for (j = 0; j < nl; j++) b[(size_t)i * inner + j] = (float)y[(size_t)i * nl + j];
+    } else {
+      double *b = (double *)ctx->b + base;
+      for (i = 0; i < n; i++)
+	for (j = 0; j < nl; j++) b[(size_t)i * inner + j] = y[(size_t)i * nl + j];
+    }
+  }
+}
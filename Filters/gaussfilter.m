@@ -1,16 +1,22 @@
-function b = gaussfilter(a,FWHM)
-% Apply a 1D Gaussian spatial filter in the Fourier domain
+function b = gaussfilter(a,FWHM,method)
+% Apply a 1D Gaussian spatial filter
 %
-% SYNTAX: b = gaussfilter(a,FWHM)
+% SYNTAX: b = gaussfilter(a,FWHM,method)
+%
+% The default recursive filter (gaussfilt_mex) runs in O(n) time for any
+% FWHM, replicating the end samples. The Fourier domain filter treats
+% the data as periodic and is used if the MEX is not compiled.
 %
 % ARGS:
 % a = original 1D data
 % w = FWHM of PSF in samples [1.0]
+% method = 'recursive' or 'fft' ['recursive']
 %
 % AUTHOR : Mike Tyszka, Ph.D.
 % PLACE  : Caltech Biological Imaging Center
 % DATES  : 11/28/2006 JMT From scratch
 %          03/12/2009 JMT Tidy up commenting
+%          10/19/2026 JMT Add recursive filter
 %
 % The MIT License (MIT)
 %
@@ -30,6 +36,7 @@ function b = gaussfilter(a,FWHM)
 %   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 if nargin < 2;  FWHM = 1.0; end
+if nargin < 3; method = 'recursive'; end
 
 % Remember original dimensions of a
 adim = size(a);
@@ -37,6 +44,12 @@ adim = size(a);
 % Force a to column vector
 a = a(:);
 
+if strcmp(method, 'recursive') && exist('gaussfilt_mex','file') == 3
+  if ~isa(a,'single'), a = double(a); end
+  b = reshape(gaussfilt_mex(real(a), FWHM / sqrt(8 * log(2))), adim);
+  return
+end
+
 % Calculate the fractional radius of the k-space Gaussian filter function
 % corresponding to the PSF FWHM provided
 Rf = 2 * pi * FWHM / sqrt(8 * log(2));
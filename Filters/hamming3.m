@@ -12,6 +12,7 @@ function H = hamming3(dims, Rf, echopos)
 % PLACE  : Caltech Biological Imaging Center
 % DATES  : 07/26/2001 JMT Adapt from shim_hamming
 %          04/15/2004 JMT Add echopos argument
+%          10/19/2026 JMT Build from the cached apodbank kernel
 %
 % The MIT License (MIT)
 %
@@ -33,14 +34,6 @@ function H = hamming3(dims, Rf, echopos)
 if nargin < 2 Rf = [0.5 0.5 0.5]; end
 if nargin < 3 echopos = 0.5; end
 
-% Construct a spatial radius matrix
-FOV = [1 1 1] ./ Rf;
-Offset = [-echopos -0.5 -0.5] ./ Rf; 
-[xc,yc,zc] = voxelgrid(dims, FOV, Offset);
-r = sqrt(xc.*xc + yc.*yc + zc.*zc);
-
-% Clamp radius to <= 1
-r(r > 1) = 1;
-
-% Construct 3D Hamming filter matrix
-H = 0.54 + 0.46 * cos(pi * r);
+% Cached radial Hamming window
+H = apodbank('hamming', dims, Rf, [], echopos);
+H = H.H;
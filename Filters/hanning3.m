@@ -10,6 +10,7 @@ function H = hanning3(dims, radii)
 % AUTHOR : Mike Tyszka, Ph.D.
 % PLACE  : Caltech Biological Imaging Center
 % DATES  : 07/26/2001 Adapt from shim_hamming
+%          10/19/2026 JMT Build from the cached apodbank kernel
 %
 % The MIT License (MIT)
 %
@@ -28,13 +29,6 @@ function H = hanning3(dims, radii)
 %   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
 %   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
-% Construct a spatial radius matrix
-FOV = dims ./ radii;
-[xc,yc,zc] = voxelgrid(dims, FOV, -FOV/2);
-r = sqrt(xc.*xc + yc.*yc + zc.*zc);
-
-% Clamp radius to <= 1
-r(r > 1) = 1;
-
-% Construct 3D Hanning filter matrix
-H = 0.5 * (1 + cos(pi * r));
+% Cached radial Hanning window
+H = apodbank('hanning', dims, radii);
+H = H.H;
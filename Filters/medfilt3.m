@@ -1,19 +1,29 @@
-function b = medfilt3(a, k)
-% Perform a hybrid 2D-3D median filter of a 3D dataset
+function b = medfilt3(a, k, method, nthreads)
+% Perform a true 3D median filter of a 3D dataset
 %
-% b = medfilt3(a, k)
+% b = medfilt3(a, k, method, nthreads)
 %
-% Run the conventional 2D median filter over the data in
-% the XY, XZ and YZ planes.
+% Median over k x k x k neighborhoods with zero padding at the volume
+% edges, as medfilt2 pads in 2D. Uses the threaded medfilt3_mex when
+% compiled (sliding histograms for 8 and 16-bit integer data, selection
+% for others), otherwise an exact slice-wise sort. The original hybrid
+% filter, running medfilt2 over the XY, XZ and YZ planes in turn, is
+% still available as method 'hybrid'.
 %
 % ARGS:
-% b = 3D matrix of any type
-% k = kernel dimension
+% a = 3D matrix of any type
+% k = kernel dimension [3]
+% method = 'exact' or 'hybrid' ['exact']
+% nthreads = number of threads for medfilt3_mex, 0 for all processors [0]
+%
+% RETURNS:
+% b = filtered 3D matrix, same size and class as a
 %
 % AUTHOR : Mike Tyszka, Ph.D.
 % PLACE  : Caltech BIC
 % DATES  : 07/19/2001 JMT From scratch
 %          01/17/2006 JMT M-Lint corrections
+%          10/19/2026 JMT True 3D median with threaded medfilt3_mex
 %
 % The MIT License (MIT)
 %
@@ -32,12 +42,78 @@ function b = medfilt3(a, k)
 %   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
 %   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
+
 if nargin < 2; k = 3; end
+if nargin < 3; method = 'exact'; end
+if nargin < 4; nthreads = 0; end
 if ndims(k) > 1; k = k(1); end
 
 % Make k next equal or larger odd number
 k = fix(k/2)*2+1;
-fprintf('Using a %d x %d kernel\n', k, k);
+
+switch method
+
+  case 'hybrid'
+
+    fprintf('Using a %d x %d kernel\n', k, k);
+    b = medfilt3_hybrid(a, k);
+
+  otherwise
+
+    fprintf('Using a %d x %d x %d kernel\n', k, k, k);
+
+    if exist('medfilt3_mex','file') == 3
+
+      % 64-bit integer and char data are filtered as double
+      if isa(a,'int64') || isa(a,'uint64') || ischar(a)
+        b = cast(medfilt3_mex(double(a), k, nthreads), class(a));
+      else
+        b = medfilt3_mex(a, k, nthreads);
+      end
+
+    elseif islogical(a)
+      b = logical(medfilt3_exact(uint8(a), k));
+    else
+      b = medfilt3_exact(a, k);
+    end
+
+end
+
+%------------------------------------------------------------
+% Exact 3D median, one sorted neighborhood stack per slice
+% sort places NaN last, matching medfilt3_mex
+%------------------------------------------------------------
+function b = medfilt3_exact(a, k)
+
+h = (k-1)/2;
+[nx,ny,nz] = size(a);
+
+% Zero padded copy
+p = zeros(nx+2*h, ny+2*h, nz+2*h, 'like', a);
+p(h+(1:nx), h+(1:ny), h+(1:nz)) = a;
+
+b = a;
+s = zeros(nx, ny, k^3, 'like', a);
+m = (k^3+1)/2;
+
+for z = 1:nz
+  n = 0;
+  for dz = 0:k-1
+    for dy = 0:k-1
+      for dx = 0:k-1
+        n = n + 1;
+        s(:,:,n) = p(dx+(1:nx), dy+(1:ny), z+dz);
+      end
+    end
+  end
+  s = sort(s, 3);
+  b(:,:,z) = s(:,:,m);
+end
+
+%------------------------------------------------------------
+% Hybrid 2D median over the XY, XZ and YZ planes in turn
+%------------------------------------------------------------
+function b = medfilt3_hybrid(a, k)
 
 % Grab data dimensions
 [nx,ny,nz] = size(a);
@@ -0,0 +1,458 @@
+/************************************************************
+ * C source for medfilt3_mex MEX object
+ *
+ * SYNTAX: b = medfilt3_mex(a, k)
+ *         b = medfilt3_mex(a, k, nthreads)
+ *
+ * Exact 3D median filter over k x k x k neighborhoods (k odd) with
+ * zero padding outside the volume, as medfilt2 pads in 2D.
+ *
+ * Integer data up to 16 bits slide a two-level cube histogram
+ * along x (Huang), updating k^2 voxels per step. For 8-bit data
+ * (logical, int8, uint8) and k >= 11 this gives way to the constant
+ * time histogram of Perreault and Hebert extended to 3D: each x
+ * keeps the histogram of its k x k (y, z) plane, updated by k voxels
+ * per step in y, and the kernel histogram slides along x by adding
+ * and removing whole plane histograms. int32, uint32, single and double
+ * data use selection (quickselect) on the k^3 neighborhood, with
+ * NaN ordered last as sort does.
+ *
+ * Rows of the volume are distributed over POSIX threads.
+ *
+ * a        = 3D array (logical, int8-32, uint8-32, single or double)
+ * k        = kernel size (odd)
+ * nthreads = number of threads, 0 for all processors [0]
+ *
+ * b        = filtered array, same size and class as a
+ *
+ * BUILD  : mex -I../RelaxFit medfilt3_mex.c
+ *
+ * AUTHOR : Mike Tyszka, Ph.D.
+ * PLACE  : Caltech BIC
+ * DATES  : 10/19/2026 JMT From scratch
+ * REFS   : Perreault S, Hebert P. IEEE Trans Image Proc 2007; 16:2389-2394
+ *          Huang TS et al. IEEE Trans Acoust Speech 1979; 27:13-18
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Mike Tyszka
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ *   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ *   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ *   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ *   Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ *   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ *   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "mex.h"
+
+#include "voxthreads.h"
+
+/* Input Arguments */
+
+#define	A_IN        prhs[0]
+#define	K_IN        prhs[1]
+#define	NTHREADS_IN prhs[2]
+
+/* Output Arguments */
+
+#define	B_OUT       plhs[0]
+
+/* Filter methods */
+#define MF_PLANE8   1
+#define MF_CUBE8    2
+#define MF_CUBE16   3
+#define MF_SELECT   4
+
+typedef struct {
+  const void *a;
+  void *b;
+  mxClassID cls;
+  int method;
+  int nx, ny, nz;
+  int h;
+  void *work[VOX_MAXTHREADS];
+} mf_context;
+
+static void mf_worker(void *, int, int, int);
+
+/************************************************************
+ * Entry point for MEX call
+ ************************************************************/
+void mexFunction(int nlhs, mxArray *plhs[],
+		 int nrhs, const mxArray *prhs[])
+{
+  mf_context ctx;
+  const mwSize *dims;
+  size_t wsize = 0;
+  int ndims, nrows, nthreads, k, t, ok;
+
+  /* Check for proper number of arguments */
+
+  if (nrhs < 2 || nrhs > 3 || nlhs > 1) {
+    mexErrMsgTxt("SYNTAX: b = medfilt3_mex(a,k[,nthreads])");
+  }
+
+  if (mxIsComplex(A_IN))
+    mexErrMsgTxt("medfilt3_mex : a must be real");
+
+  ndims = (int)mxGetNumberOfDimensions(A_IN);
+  dims = mxGetDimensions(A_IN);
+  if (ndims > 3)
+    mexErrMsgTxt("medfilt3_mex : a must be 3D");
+
+  ctx.nx = (int)dims[0];
+  ctx.ny = (int)dims[1];
+  ctx.nz = (ndims > 2) ? (int)dims[2] : 1;
+
+  k = (int)mxGetScalar(K_IN);
+  if (k < 1 || k % 2 == 0)
+    mexErrMsgTxt("medfilt3_mex : k must be odd and positive");
+  ctx.h = k / 2;
+
+  ctx.cls = mxGetClassID(A_IN);
+  switch (ctx.cls) {
+  case mxLOGICAL_CLASS:
+  case mxINT8_CLASS:
+  case mxUINT8_CLASS:
+    /* Plane histograms win once k^2 voxel updates cost more than a histogram add */
+    if (k >= 11) {
+      ctx.method = MF_PLANE8;
+      wsize = (size_t)ctx.nx * (256 + 16 + 1) * sizeof(unsigned) + (256 + 16) * sizeof(unsigned);
+    } else {
+      ctx.method = MF_CUBE8;
+      wsize = (256 + 16) * sizeof(unsigned);
+    }
+    break;
+  case mxINT16_CLASS:
+  case mxUINT16_CLASS:
+    ctx.method = MF_CUBE16;
+    wsize = (65536 + 256) * sizeof(unsigned);
+    break;
+  case mxINT32_CLASS:
+  case mxUINT32_CLASS:
+  case mxSINGLE_CLASS:
+  case mxDOUBLE_CLASS:
+    ctx.method = MF_SELECT;
+    wsize = (size_t)k * k * k * sizeof(double);
+    break;
+  default:
+    mexErrMsgTxt("medfilt3_mex : unsupported class");
+  }
+
+  ctx.a = mxGetData(A_IN);
+  B_OUT = mxCreateNumericArray(ndims, dims, ctx.cls, mxREAL);
+  ctx.b = mxGetData(B_OUT);
+
+  nrows = ctx.ny * ctx.nz;
+  if (ctx.nx < 1 || nrows < 1) return;
+
+  nthreads = vox_nthreads((nrhs > 2) ? (int)mxGetScalar(NTHREADS_IN) : 0);
+  if (nthreads > (nrows + VOX_MINCHUNK - 1) / VOX_MINCHUNK)
+    nthreads = (nrows + VOX_MINCHUNK - 1) / VOX_MINCHUNK;
+
+  /* Per-thread histograms or neighborhood buffer */
+  ok = 1;
+  for (t = 0; t < nthreads; t++) {
+    ctx.work[t] = calloc(wsize, 1);
+    if (ctx.work[t] == NULL) ok = 0;
+  }
+
+  if (ok) vox_parallel(nrows, nthreads, mf_worker, &ctx);
+
+  for (t = 0; t < nthreads; t++) free(ctx.work[t]);
+
+  if (!ok) mexErrMsgTxt("medfilt3_mex : out of memory");
+
+  return;
+}
+
+/************************************************************
+ * Histogram bin of voxel i, and the bin holding zero
+ ************************************************************/
+static int mf_bin(const mf_context *ctx, size_t i)
+{
+  switch (ctx->cls) {
+  case mxINT8_CLASS:   return ((const signed char *)ctx->a)[i] + 128;
+  case mxINT16_CLASS:  return ((const short *)ctx->a)[i] + 32768;
+  case mxUINT16_CLASS: return ((const unsigned short *)ctx->a)[i];
+  default:             return ((const unsigned char *)ctx->a)[i];
+  }
+}
+
+static int mf_zero_bin(const mf_context *ctx)
+{
+  return (ctx->cls == mxINT8_CLASS) ? 128 : (ctx->cls == mxINT16_CLASS) ? 32768 : 0;
+}
+
+static void mf_store_bin(const mf_context *ctx, size_t i, int bin)
+{
+  switch (ctx->cls) {
+  case mxINT8_CLASS:   ((signed char *)ctx->b)[i] = (signed char)(bin - 128); break;
+  case mxINT16_CLASS:  ((short *)ctx->b)[i] = (short)(bin - 32768); break;
+  case mxUINT16_CLASS: ((unsigned short *)ctx->b)[i] = (unsigned short)bin; break;
+  default:             ((unsigned char *)ctx->b)[i] = (unsigned char)bin; break;
+  }
+}
+
+/************************************************************
+ * Bin of rank r (0-based) in a two-level histogram with coarse
+ * bins of 2^S fine bins. nz padding zeros are counted in zbin.
+ ************************************************************/
+static int mf_hist_rank(const unsigned *fine, const unsigned *coarse, int S,
+			int r, int zbin, int nz)
+{
+  int c = 0, b, cum = 0, cnt;
+
+  for (;;) {
+    cnt = coarse[c] + ((zbin >> S) == c ? nz : 0);
+    if (cum + cnt > r) break;
+    cum += cnt;
+    c++;
+  }
+
+  for (b = c << S; ; b++) {
+    cnt = fine[b] + (b == zbin ? nz : 0);
+    if (cum + cnt > r) break;
+    cum += cnt;
+  }
+
+  return b;
+}
+
+/************************************************************
+ * 8-bit rows : Perreault-Hebert plane and kernel histograms
+ * Plane histogram P[x] covers a[x, y-h..y+h, z-h..z+h]
+ ************************************************************/
+static void mf_plane(const mf_context *ctx, unsigned *P, unsigned *Pc, unsigned *Pn,
+		     int x, int y, int z, int sgn)
+{
+  int nx = ctx->nx, ny = ctx->ny, zz, bin;
+
+  if (y < 0 || y >= ny) return;
+
+  for (zz = z - ctx->h; zz <= z + ctx->h; zz++) {
+    if (zz < 0 || zz >= ctx->nz) continue;
+    bin = mf_bin(ctx, x + (size_t)nx * (y + (size_t)ny * zz));
+    P[(size_t)x * 256 + bin] += sgn;
+    Pc[x * 16 + (bin >> 4)] += sgn;
+    Pn[x] += sgn;
+  }
+}
+
+static void mf_rows_plane(const mf_context *ctx, int r0, int r1, void *work)
+{
+  int nx = ctx->nx, ny = ctx->ny, h = ctx->h, k = 2 * h + 1;
+  unsigned *P = (unsigned *)work;              /* nx x 256 */
+  unsigned *Pc = P + (size_t)nx * 256;         /* nx x 16 */
+  unsigned *Pn = Pc + (size_t)nx * 16;         /* nx */
+  unsigned *H = Pn + nx;                       /* 256 */
+  unsigned *Hc = H + 256;                      /* 16 */
+  int zbin = mf_zero_bin(ctx), rank = (k * k * k) / 2;
+  int r, x, y, z, yy, xx, i, n, xa, xr;
+
+  for (r = r0; r < r1; r++) {
+
+    y = r % ny;
+    z = r / ny;
+
+    /* Build plane histograms at the start of a chunk or plane, else step y */
+    if (r == r0 || y == 0) {
+      memset(P, 0, (size_t)nx * (256 + 16 + 1) * sizeof(unsigned));
+      for (x = 0; x < nx; x++)
+	for (yy = y - h; yy <= y + h; yy++) mf_plane(ctx, P, Pc, Pn, x, yy, z, 1);
+    } else {
+      for (x = 0; x < nx; x++) {
+	mf_plane(ctx, P, Pc, Pn, x, y - h - 1, z, -1);
+	mf_plane(ctx, P, Pc, Pn, x, y + h, z, 1);
+      }
+    }
+
+    /* Kernel histogram for x = 0 */
+    memset(H, 0, (256 + 16) * sizeof(unsigned));
+    n = 0;
+    for (xx = 0; xx <= h && xx < nx; xx++) {
+      for (i = 0; i < 256; i++) H[i] += P[(size_t)xx * 256 + i];
+      for (i = 0; i < 16; i++) Hc[i] += Pc[xx * 16 + i];
+      n += Pn[xx];
+    }
+
+    for (x = 0; x < nx; x++) {
+
+      mf_store_bin(ctx, x + (size_t)nx * (y + (size_t)ny * z),
+		   mf_hist_rank(H, Hc, 4, rank, zbin, k * k * k - n));
+
+      /* Slide : add plane x + h + 1, drop plane x - h */
+      xa = x + h + 1;
+      xr = x - h;
+      if (xa < nx) {
+	for (i = 0; i < 256; i++) H[i] += P[(size_t)xa * 256 + i];
+	for (i = 0; i < 16; i++) Hc[i] += Pc[xa * 16 + i];
+	n += Pn[xa];
+      }
+      if (xr >= 0) {
+	for (i = 0; i < 256; i++) H[i] -= P[(size_t)xr * 256 + i];
+	for (i = 0; i < 16; i++) Hc[i] -= Pc[xr * 16 + i];
+	n -= Pn[xr];
+      }
+    }
+  }
+}
+
+/************************************************************
+ * 8 and 16-bit rows : cube histogram sliding along x, with
+ * coarse bins of 2^S fine bins
+ ************************************************************/
+static int mf_cube_plane(const mf_context *ctx, unsigned *H, unsigned *Hc, int S,
+			 int x, int y, int z, int sgn)
+{
+  int nx = ctx->nx, ny = ctx->ny, h = ctx->h, yy, zz, bin, n = 0;
+
+  if (x < 0 || x >= nx) return 0;
+
+  for (zz = z - h; zz <= z + h; zz++) {
+    if (zz < 0 || zz >= ctx->nz) continue;
+    for (yy = y - h; yy <= y + h; yy++) {
+      if (yy < 0 || yy >= ny) continue;
+      bin = mf_bin(ctx, x + (size_t)nx * (yy + (size_t)ny * zz));
+      H[bin] += sgn;
+      Hc[bin >> S] += sgn;
+      n++;
+    }
+  }
+
+  return sgn * n;
+}
+
+static void mf_rows_cube(const mf_context *ctx, int r0, int r1, int S, void *work)
+{
+  int nx = ctx->nx, ny = ctx->ny, h = ctx->h, k = 2 * h + 1;
+  unsigned *H = (unsigned *)work;    /* 2^(2S), left empty after each row */
+  unsigned *Hc = H + (1 << (2 * S)); /* 2^S */
+  int zbin = mf_zero_bin(ctx), rank = (k * k * k) / 2;
+  int r, x, y, z, n;
+
+  for (r = r0; r < r1; r++) {
+
+    y = r % ny;
+    z = r / ny;
+
+    n = 0;
+    for (x = 0; x <= h; x++) n += mf_cube_plane(ctx, H, Hc, S, x, y, z, 1);
+
+    for (x = 0; x < nx; x++) {
+      mf_store_bin(ctx, x + (size_t)nx * (y + (size_t)ny * z),
+		   mf_hist_rank(H, Hc, S, rank, zbin, k * k * k - n));
+      n += mf_cube_plane(ctx, H, Hc, S, x + h + 1, y, z, 1);
+      n += mf_cube_plane(ctx, H, Hc, S, x - h, y, z, -1);
+    }
+
+    /* Empty the histogram for the next row */
+    for (x = nx - h; x < nx; x++) mf_cube_plane(ctx, H, Hc, S, x, y, z, -1);
+  }
+}
+
+/************************************************************
+ * Selection for 32-bit and floating point data
+ ************************************************************/
+static double mf_get(const mf_context *ctx, size_t i)
+{
+  switch (ctx->cls) {
+  case mxINT32_CLASS:  return ((const int *)ctx->a)[i];
+  case mxUINT32_CLASS: return ((const unsigned *)ctx->a)[i];
+  case mxSINGLE_CLASS: return ((const float *)ctx->a)[i];
+  default:             return ((const double *)ctx->a)[i];
+  }
+}
+
+static void mf_put(const mf_context *ctx, size_t i, double v)
+{
+  switch (ctx->cls) {
+  case mxINT32_CLASS:  ((int *)ctx->b)[i] = (int)v; break;
+  case mxUINT32_CLASS: ((unsigned *)ctx->b)[i] = (unsigned)v; break;
+  case mxSINGLE_CLASS: ((float *)ctx->b)[i] = (float)v; break;
+  default:             ((double *)ctx->b)[i] = v; break;
+  }
+}
+
+/* a before b, NaN last */
+#define MF_LT(a, b) ((a) < (b) || (isnan(b) && !isnan(a)))
+
+static double mf_select(double *v, int n, int r)
+{
+  int lo = 0, hi = n - 1, i, j;
+  double p, t;
+
+  while (lo < hi) {
+    p = v[lo + (hi - lo) / 2];
+    i = lo;
+    j = hi;
+    while (i <= j) {
+      while (MF_LT(v[i], p)) i++;
+      while (MF_LT(p, v[j])) j--;
+      if (i <= j) {
+	t = v[i]; v[i] = v[j]; v[j] = t;
+	i++;
+	j--;
+      }
+    }
+    if (r <= j) hi = j;
+    else if (r >= i) lo = i;
+    else break;
+  }
+
+  return v[r];
+}
+
+static void mf_rows_select(const mf_context *ctx, int r0, int r1, void *work)
+{
+  int nx = ctx->nx, ny = ctx->ny, nz = ctx->nz, h = ctx->h, k = 2 * h + 1;
+  double *v = (double *)work;
+  int r, x, y, z, xx, yy, zz, n;
+
+  for (r = r0; r < r1; r++) {
+
+    y = r % ny;
+    z = r / ny;
+
+    for (x = 0; x < nx; x++) {
+      n = 0;
+      for (zz = z - h; zz <= z + h; zz++) {
+	for (yy = y - h; yy <= y + h; yy++) {
+	  for (xx = x - h; xx <= x + h; xx++) {
+	    if (xx < 0 || xx >= nx || yy < 0 || yy >= ny || zz < 0 || zz >= nz)
+	      v[n++] = 0.0;
+	    else
+	      v[n++] = mf_get(ctx, xx + (size_t)nx * (yy + (size_t)ny * zz));
+	  }
+	}
+      }
+      mf_put(ctx, x + (size_t)nx * (y + (size_t)ny * z), mf_select(v, n, (k * k * k) / 2));
+    }
+  }
+}
+
+/************************************************************
+ * Filter rows [r0, r1) (row r is y = r % ny, z = r / ny)
+ ************************************************************/
+static void mf_worker(void *arg, int r0, int r1, int tid)
+{
+  mf_context *ctx = (mf_context *)arg;
+
+  switch (ctx->method) {
+  case MF_PLANE8: mf_rows_plane(ctx, r0, r1, ctx->work[tid]); break;
+  case MF_CUBE8:  mf_rows_cube(ctx, r0, r1, 4, ctx->work[tid]); break;
+  case MF_CUBE16: mf_rows_cube(ctx, r0, r1, 8, ctx->work[tid]); break;
+  default:        mf_rows_select(ctx, r0, r1, ctx->work[tid]); break;
+  }
+}
@@ -5,14 +5,17 @@ function y = medianfilt(x, w)
 % Median filter x using a w sample kernel
 %
 % ARGS:
-% x = vector of uniformly sampled values
+% x = vector of uniformly sampled values, or array filtered down each column
 % w = filter kernel width [3]
 %
+% Uses the compiled O(log w) runmed_mex engine when available.
+%
 % AUTHOR : Mike Tyszka, Ph.D.
 % PLACE  : City of Hope, Duarte, CA
 % DATES  : 05/31/00 Add index range
 %          06/01/00 Remove index range
 %          08/09/00 Add defaults and syntax message
+%          10/19/2026 JMT Compiled running median engine, column-wise arrays
 %
 % The MIT License (MIT)
 %
@@ -41,18 +44,41 @@ if nargin < 2
    w = 3;
 end
 
-nx = length(x);
-
 % Half the kernel width rounded down
 hk = floor(w/2);
 
-p0 = (1:nx) - hk;
-p1 = (1:nx) + hk;
+% Vectors are returned as rows, arrays are filtered down each column
+isvec = isvector(x);
+if isvec
+   x = x(:);
+end
+
+if exist('runmed_mex','file') == 3
+
+   y = runmed_mex(double(x), hk);
+
+else
+
+   nx = size(x,1);
 
-% Keep start and end points within bounds
-p0(p0 < 1) = 1;
-p1(p1 > nx) = nx;
+   p0 = (1:nx) - hk;
+   p1 = (1:nx) + hk;
+
+   % Keep start and end points within bounds
+   p0(p0 < 1) = 1;
+   p1(p1 > nx) = nx;
+
+   y = zeros(size(x));
+   for p = 1:nx
+      y(p,:) = median(x(p0(p):p1(p),:), 1);
+   end
+
+end
+
+if isa(x, 'single')
+   y = single(y);
+end
 
-for p = 1:nx
-   y(p) = median(x(p0(p):p1(p)));
+if isvec
+   y = y';
 end
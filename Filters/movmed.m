@@ -1,9 +1,15 @@
 function sm = movmed(s,k)
 % SYNTAX: sm = movmed(s,k)
 %
+% Running median over a k sample window (rounded up to odd),
+% truncated at the ends of the data. Vectors return a row vector,
+% arrays are filtered down each column. Uses the compiled O(log k)
+% runmed_mex engine when available.
+%
 % AUTHOR : Mike Tyszka, Ph.D.
 % PLACE  : Caltech
 % DATES  : 10/08/2007 JMT Rewrite from memory
+%          10/19/2026 JMT Compiled running median engine, column-wise arrays
 %
 % The MIT License (MIT)
 %
@@ -22,13 +28,6 @@ function sm = movmed(s,k)
 %   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
 %   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
-% Force row vector
-s = s(:)';
-
-% Get size and make space for filtered vector
-n = length(s);
-sm = zeros(size(s));
-
 % Round up to next odd number
 kk = fix(k/2)*2+1;
 if kk ~= k
@@ -38,8 +37,35 @@ end
 % Half-size of filter
 hk = fix(kk/2);
 
+% Vectors are returned as rows, arrays are filtered down each column
+isvec = isvector(s);
+if isvec
+  s = s(:);
+end
+
+% Compiled O(log k) running median when available
+if exist('runmed_mex','file') == 3
+  sm = runmed_mex(double(s), hk);
+else
+  sm = movmed_cols(double(s(:,:)), hk);
+  sm = reshape(sm, size(s));
+end
+
+if isvec
+  sm = sm';
+end
+
+%------------------------------------------------------------
+% Reference running median of each column of s
+%------------------------------------------------------------
+function sm = movmed_cols(s, hk)
+
+% Get size and make space for filtered columns
+[n, nc] = size(s);
+sm = zeros(n, nc);
+
 for xc = 1:n
-  
+
   % Start and end points of kernel
   m0 = xc-hk;
   m1 = xc+hk;
@@ -47,8 +73,8 @@ for xc = 1:n
   % Clamp to vector limits
   if m0 < 1; m0 = 1; end
   if m1 > n; m1 = n; end
-  
+
   % Add median of kernel to return vector
-  sm(xc) = median(s(m0:m1));
-  
+  sm(xc,:) = median(s(m0:m1,:), 1);
+
 end
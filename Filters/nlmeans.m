@@ -0,0 +1,87 @@
+function [B, sigma] = nlmeans(A, sigma, opts)
+% [B, sigma] = nlmeans(A, sigma, opts)
+%
+% Non-local means denoising of a 2D or 3D magnitude image
+%
+% Voxelwise NLM with integral image patch distances, or the blockwise
+% scheme of Coupe et al for 3D volumes (opts.block > 0), with optional
+% Rician bias correction of the squared magnitude. Requires the
+% threaded nlmeans_mex (mex -I../RelaxFit nlmeans_mex.c).
+%
+% ARGS:
+% A     = 2D or 3D magnitude image
+% sigma = Gaussian noise SD of the underlying complex data, estimated
+%         from A if empty or omitted []
+% opts  = options structure
+%   .beta     = smoothing strength, h^2 = 2 beta sigma^2 [1.0]
+%   .search   = search radius in voxels [3]
+%   .patch    = patch radius in voxels [1]
+%   .block    = block centre spacing for blockwise NLM, at most
+%               .patch + 1, 0 for voxelwise NLM [0]
+%   .rician   = correct Rician bias [true]
+%   .noise    = noise estimator for empty sigma: 'noisesd' (wavelet
+%               MAD) or 'mrmad' (MAD of neighboring voxel differences)
+%               ['noisesd']
+%   .nthreads = number of threads, 0 for all processors [0]
+%
+% RETURNS:
+% B     = denoised image, same size and class as A
+% sigma = noise SD used
+%
+% AUTHOR : Mike Tyszka, Ph.D.
+% PLACE  : Caltech BIC
+% DATES  : 10/19/2026 JMT From scratch
+% REFS   : Buades A et al. Multiscale Model Simul 2005; 4:490-530
+%          Coupe P et al. IEEE Trans Med Imaging 2008; 27:425-441
+%          Manjon JV et al. Magn Reson Imaging 2008; 26:1113-1124
+%
+% The MIT License (MIT)
+%
+% Copyright (c) 2016 Mike Tyszka
+%
+%   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+%   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+%   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+%   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+%
+%   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+%   Software.
+%
+%   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+%   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+%   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+%   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+if nargin < 2; sigma = []; end
+if nargin < 3; opts = struct(); end
+
+if ~isfield(opts,'beta');     opts.beta = 1.0;        end
+if ~isfield(opts,'search');   opts.search = 3;        end
+if ~isfield(opts,'patch');    opts.patch = 1;         end
+if ~isfield(opts,'block');    opts.block = 0;         end
+if ~isfield(opts,'rician');   opts.rician = true;     end
+if ~isfield(opts,'noise');    opts.noise = 'noisesd'; end
+if ~isfield(opts,'nthreads'); opts.nthreads = 0;      end
+
+if exist('nlmeans_mex','file') ~= 3
+  error('nlmeans : compile nlmeans_mex first (mex -I../RelaxFit nlmeans_mex.c)');
+end
+
+Ad = double(A);
+
+% Noise SD from the image
+if isempty(sigma)
+  switch lower(opts.noise)
+    case 'mrmad'
+      % Differences of neighboring voxels have twice the noise variance
+      [~, sigma] = mrmad(diff(Ad, 1, 1));
+      sigma = sigma / sqrt(2);
+    otherwise
+      sigma = noisesd(Ad);
+  end
+end
+
+B = nlmeans_mex(Ad, sigma, opts.beta, opts.search, opts.patch, ...
+  opts.block, double(opts.rician), opts.nthreads);
+
+B = cast(B, class(A));
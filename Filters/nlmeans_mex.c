@@ -0,0 +1,428 @@
+/************************************************************
+ * C source for nlmeans_mex MEX object
+ *
+ * SYNTAX: B = nlmeans_mex(A, sigma, beta, sr, pr, step, rician)
+ *         B = nlmeans_mex(A, sigma, beta, sr, pr, step, rician, nthreads)
+ *
+ * Non-local means denoising of a 3D magnitude volume. Each voxel is
+ * the weighted mean of the voxels in its (2sr+1)^3 search window,
+ * weighted by the similarity of the (2pr+1)^3 patches around them:
+ *
+ *   w = exp(-d / (2 beta sigma^2)),  d = mean squared patch difference
+ *
+ * The search offsets are taken in turn, and for each offset the
+ * squared difference volume is summed into an integral image, so
+ * every patch distance costs eight lookups whatever the patch size.
+ * The centre voxel takes the largest weight of its neighbours.
+ *
+ * With step > 0 the blockwise scheme is used: weights are computed
+ * only for block centres on a grid of spacing step, each weight is
+ * applied to the whole (2pr+1)^3 block, and the overlapping block
+ * estimates are pooled: the weighted sums and the weights of all
+ * blocks covering a voxel are accumulated before one division.
+ * The block sums are also taken from an integral image of the
+ * centre weights, so the cost per offset is again independent of
+ * the patch size.
+ *
+ * With rician set the squared magnitude is averaged and the Rician
+ * bias 2 sigma^2 is removed before the square root.
+ *
+ * Patch distances near the volume edges use the voxels inside the
+ * volume, and search offsets falling outside it are skipped. The
+ * volume is processed in slabs of slices, with patch and block
+ * halos, which are distributed over POSIX threads.
+ *
+ * A        = 3D magnitude volume (double)
+ * sigma    = noise SD
+ * beta     = smoothing strength, 1 for the nominal h^2 = 2 sigma^2
+ * sr       = search radius in voxels
+ * pr       = patch radius in voxels
+ * step     = block centre spacing (at most pr + 1), 0 for voxelwise NLM
+ * rician   = 1 to correct Rician bias, 0 otherwise
+ * nthreads = number of threads, 0 for all processors [0]
+ *
+ * B        = denoised volume
+ *
+ * BUILD  : mex -I../RelaxFit nlmeans_mex.c
+ *
+ * AUTHOR : Mike Tyszka, Ph.D.
+ * PLACE  : Caltech BIC
+ * DATES  : 10/19/2026 JMT From scratch
+ *          10/19/2026 JMT Clamp search offsets to the volume extent
+ * REFS   : Buades A et al. Multiscale Model Simul 2005; 4:490-530
+ *          Darbon J et al. IEEE ISBI 2008; 1331-1334
+ *          Coupe P et al. IEEE Trans Med Imaging 2008; 27:425-441
+ *          Manjon JV et al. Magn Reson Imaging 2008; 26:1113-1124
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Mike Tyszka
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ *   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ *   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ *   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ *   Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ *   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ *   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "mex.h"
+
+#include "voxthreads.h"
+
+/* Input Arguments */
+
+#define	A_IN        prhs[0]
+#define	SIGMA_IN    prhs[1]
+#define	BETA_IN     prhs[2]
+#define	SR_IN       prhs[3]
+#define	PR_IN       prhs[4]
+#define	STEP_IN     prhs[5]
+#define	RICIAN_IN   prhs[6]
+#define	NTHREADS_IN prhs[7]
+
+/* Output Arguments */
+
+#define	B_OUT       plhs[0]
+
+/* Output slices per slab */
+#define NLM_SLAB    16
+
+/* Weights below exp(-NLM_DMAX) are skipped */
+#define NLM_DMAX    30.0
+
+typedef struct {
+  const double *A;
+  double *B;
+  int nx, ny, nz;
+  double h2;           /* 2 beta sigma^2 */
+  double bias;         /* 2 sigma^2 for Rician correction, else 0 */
+  int sr, pr, ra, step;
+  int rician;
+  size_t nwork;        /* doubles of workspace per thread */
+  double *work[VOX_MAXTHREADS];
+} nlm_context;
+
+static void nlm_worker(void *, int, int, int);
+
+/************************************************************
+ * Entry point for MEX call
+ ************************************************************/
+void mexFunction(int nlhs, mxArray *plhs[],
+		 int nrhs, const mxArray *prhs[])
+{
+  nlm_context ctx;
+  const mwSize *dims;
+  double sigma, beta;
+  size_t nxy, nsz, nez, ncz;
+  int ndims, nslab, nthreads, t, ok;
+
+  /* Check for proper number of arguments */
+
+  if (nrhs < 7 || nrhs > 8 || nlhs > 1) {
+    mexErrMsgTxt("SYNTAX: B = nlmeans_mex(A,sigma,beta,sr,pr,step,rician[,nthreads])");
+  }
+
+  if (!mxIsDouble(A_IN) || mxIsComplex(A_IN))
+    mexErrMsgTxt("nlmeans_mex : A must be real double");
+
+  ndims = (int)mxGetNumberOfDimensions(A_IN);
+  dims = mxGetDimensions(A_IN);
+  if (ndims > 3)
+    mexErrMsgTxt("nlmeans_mex : A must be 3D");
+
+  ctx.nx = (int)dims[0];
+  ctx.ny = (int)dims[1];
+  ctx.nz = (ndims > 2) ? (int)dims[2] : 1;
+
+  sigma      = mxGetScalar(SIGMA_IN);
+  beta       = mxGetScalar(BETA_IN);
+  ctx.sr     = (int)mxGetScalar(SR_IN);
+  ctx.pr     = (int)mxGetScalar(PR_IN);
+  ctx.step   = (int)mxGetScalar(STEP_IN);
+  ctx.rician = (int)mxGetScalar(RICIAN_IN);
+
+  if (sigma <= 0.0 || beta <= 0.0 || ctx.sr < 0 || ctx.pr < 0 || ctx.step < 0)
+    mexErrMsgTxt("nlmeans_mex : sigma and beta must be positive, sr, pr and step non-negative");
+
+  /* Blocks must cover every voxel, including the last in each dimension */
+  if (ctx.step > ctx.pr + 1)
+    mexErrMsgTxt("nlmeans_mex : step must not exceed pr + 1");
+
+  ctx.h2   = 2.0 * beta * sigma * sigma;
+  ctx.bias = ctx.rician ? 2.0 * sigma * sigma : 0.0;
+
+  /* Voxelwise NLM is the blockwise scheme with single voxel blocks */
+  if (ctx.step > 0) {
+    ctx.ra = ctx.pr;
+  } else {
+    ctx.ra = 0;
+    ctx.step = 1;
+  }
+
+  ctx.A = mxGetPr(A_IN);
+  B_OUT = mxCreateNumericArray(ndims, dims, mxDOUBLE_CLASS, mxREAL);
+  ctx.B = mxGetPr(B_OUT);
+
+  if (ctx.nx < 1 || ctx.ny < 1 || ctx.nz < 1) return;
+
+  /* Slab workspace : difference and weight integral images over the
+     patch and block halos, centre weights, accumulators */
+  nxy = (size_t)ctx.nx * ctx.ny;
+  nsz = NLM_SLAB;
+  ncz = nsz + 2 * ctx.ra;
+  nez = ncz + 2 * ctx.pr;
+  ctx.nwork = (size_t)(ctx.nx + 1) * (ctx.ny + 1) * (nez + 1)   /* difference integral */
+    + (size_t)(ctx.nx + 1) * (ctx.ny + 1) * (ncz + 1)           /* weight integral */
+    + 2 * nxy * ncz                                             /* centre and maximum weights */
+    + 2 * nxy * nsz;                                            /* accumulators */
+
+  nslab = (ctx.nz + NLM_SLAB - 1) / NLM_SLAB;
+
+  nthreads = vox_nthreads((nrhs > 7) ? (int)mxGetScalar(NTHREADS_IN) : 0);
+  if (nthreads > nslab) nthreads = nslab;
+
+  ok = 1;
+  for (t = 0; t < nthreads; t++) {
+    ctx.work[t] = (double *)malloc(ctx.nwork * sizeof(double));
+    if (ctx.work[t] == NULL) ok = 0;
+  }
+
+  if (ok) vox_parallel(nslab, nthreads, nlm_worker, &ctx);
+
+  for (t = 0; t < nthreads; t++) free(ctx.work[t]);
+
+  if (!ok) mexErrMsgTxt("nlmeans_mex : out of memory");
+
+  return;
+}
+
+/************************************************************
+ * In place integral image of an nx x ny x nz volume held in an
+ * (nx+1) x (ny+1) x (nz+1) array with zero leading planes
+ ************************************************************/
+static void nlm_integral(double *I, int nx, int ny, int nz)
+{
+  size_t sy = nx + 1, sz = (size_t)(nx + 1) * (ny + 1);
+  int x, y, z;
+  double *p;
+
+  for (z = 1; z <= nz; z++)
+    for (y = 1; y <= ny; y++) {
+      p = I + y * sy + z * sz;
+      for (x = 1; x <= nx; x++) p[x] += p[x - 1];
+    }
+
+  for (z = 1; z <= nz; z++)
+    for (y = 1; y <= ny; y++) {
+      p = I + y * sy + z * sz;
+      for (x = 1; x <= nx; x++) p[x] += p[x - sy];
+    }
+
+  for (z = 1; z <= nz; z++)
+    for (y = 1; y <= ny; y++) {
+      p = I + y * sy + z * sz;
+      for (x = 1; x <= nx; x++) p[x] += p[x - sz];
+    }
+}
+
+/************************************************************
+ * Sum over the inclusive box [x0,x1] x [y0,y1] x [z0,z1]
+ ************************************************************/
+static double nlm_box(const double *I, int nx, int ny,
+		      int x0, int x1, int y0, int y1, int z0, int z1)
+{
+  size_t sy = nx + 1, sz = (size_t)(nx + 1) * (ny + 1);
+  size_t a0 = x0, a1 = x1 + 1, b0 = y0 * sy, b1 = (y1 + 1) * sy, c0 = z0 * sz, c1 = (z1 + 1) * sz;
+
+
+  return I[a1 + b1 + c1] - I[a0 + b1 + c1] - I[a1 + b0 + c1] - I[a1 + b1 + c0]
+    + I[a0 + b0 + c1] + I[a0 + b1 + c0] + I[a1 + b0 + c0] - I[a0 + b0 + c0];
+}
+
+static int nlm_min(int a, int b) { return a < b ? a : b; }
+static int nlm_max(int a, int b) { return a > b ? a : b; }
+
+/************************************************************
+ * Denoise slabs [s0, s1) on thread tid
+ ************************************************************/
+static void nlm_worker(void *arg, int s0, int s1, int tid)
+{
+  nlm_context *ctx = (nlm_context *)arg;
+  const double *A = ctx->A;
+  int nx = ctx->nx, ny = ctx->ny, nz = ctx->nz;
+  int sr = ctx->sr, pr = ctx->pr, ra = ctx->ra, step = ctx->step;
+  size_t nxy = (size_t)nx * ny, sy1 = nx + 1, sz1 = (size_t)(nx + 1) * (ny + 1);
+  double *ID, *IW, *W, *Wmax, *acc, *wsum;
+  double d, w, v, s;
+  int slab, z0, z1, zc0, zc1, ze0, ze1, ncz, nez, nsz;
+  int dx, dy, dz, x, y, z, xn, yn, zn;
+  size_t i, j;
+
+  /* Offsets spanning the whole volume find no neighbours (eg dz for 2D) */
+  int srx = nlm_min(sr, nx - 1), sry = nlm_min(sr, ny - 1), srz = nlm_min(sr, nz - 1);
+
+  for (slab = s0; slab < s1; slab++) {
+
+    /* Output slices, block centre slices and patch slices */
+    z0 = slab * NLM_SLAB;
+    z1 = nlm_min(z0 + NLM_SLAB, nz);
+    zc0 = nlm_max(z0 - ra, 0);
+    zc1 = nlm_min(z1 + ra, nz);
+    ze0 = nlm_max(zc0 - pr, 0);
+    ze1 = nlm_min(zc1 + pr, nz);
+    nsz = z1 - z0;
+    ncz = zc1 - zc0;
+    nez = ze1 - ze0;
+
+    ID   = ctx->work[tid];
+    IW   = ID + sz1 * (nez + 1);
+    W    = IW + sz1 * (ncz + 1);
+    Wmax = W + nxy * ncz;
+    acc  = Wmax + nxy * ncz;
+    wsum = acc + nxy * nsz;
+
+    /* Leading planes of the integral images stay zero */
+    memset(ID, 0, sz1 * (nez + 1) * sizeof(double));
+    memset(IW, 0, sz1 * (ncz + 1) * sizeof(double));
+    memset(Wmax, 0, nxy * ncz * sizeof(double));
+    memset(acc, 0, nxy * nsz * sizeof(double));
+    memset(wsum, 0, nxy * nsz * sizeof(double));
+
+    for (dz = -srz; dz <= srz; dz++)
+      for (dy = -sry; dy <= sry; dy++)
+	for (dx = -srx; dx <= srx; dx++) {
+
+	  if (dx == 0 && dy == 0 && dz == 0) continue;
+
+	  /* Squared differences to the offset volume, edge voxels replicated */
+	  for (z = ze0; z < ze1; z++) {
+	    zn = nlm_min(nlm_max(z + dz, 0), nz - 1);
+	    for (y = 0; y < ny; y++) {
+	      yn = nlm_min(nlm_max(y + dy, 0), ny - 1);
+	      double *p = ID + 1 + (y + 1) * sy1 + (z - ze0 + 1) * sz1;
+	      const double *a = A + nx * (y + (size_t)ny * z);
+	      const double *an = A + nx * (yn + (size_t)ny * zn);
+	      for (x = 0; x < nx; x++) {
+		xn = x + dx;
+		if (xn < 0) xn = 0;
+		else if (xn >= nx) xn = nx - 1;
+		d = a[x] - an[xn];
+		p[x] = d * d;
+	      }
+	    }
+	  }
+	  nlm_integral(ID, nx, ny, nez);
+
+	  /* Patch weights at the block centres whose neighbor is inside */
+	  memset(W, 0, nxy * ncz * sizeof(double));
+	  for (z = zc0; z < zc1; z++) {
+	    if (z % step || z + dz < 0 || z + dz >= nz) continue;
+	    for (y = 0; y < ny; y += step) {
+	      if (y + dy < 0 || y + dy >= ny) continue;
+	      for (x = 0; x < nx; x += step) {
+		if (x + dx < 0 || x + dx >= nx) continue;
+		int px0 = nlm_max(x - pr, 0), px1 = nlm_min(x + pr, nx - 1);
+		int py0 = nlm_max(y - pr, 0), py1 = nlm_min(y + pr, ny - 1);
+		int pz0 = nlm_max(z - pr, 0), pz1 = nlm_min(z + pr, nz - 1);
+		d = nlm_box(ID, nx, ny, px0, px1, py0, py1, pz0 - ze0, pz1 - ze0)
+		  / ((double)(px1 - px0 + 1) * (py1 - py0 + 1) * (pz1 - pz0 + 1));
+		d /= ctx->h2;
+		if (d > NLM_DMAX) continue;
+		w = exp(-d);
+		i = x + nx * (y + (size_t)ny * (z - zc0));
+		W[i] = w;
+		if (w > Wmax[i]) Wmax[i] = w;
+	      }
+	    }
+	  }
+
+	  /* Block sums of the centre weights */
+	  if (ra > 0) {
+	    for (z = 0; z < ncz; z++)
+	      for (y = 0; y < ny; y++)
+		memcpy(IW + 1 + (y + 1) * sy1 + (z + 1) * sz1, W + nx * (y + (size_t)ny * z), nx * sizeof(double));
+	    nlm_integral(IW, nx, ny, ncz);
+	  }
+
+	  /* Accumulate the weighted offset voxels */
+	  for (z = z0; z < z1; z++) {
+	    zn = z + dz;
+	    if (zn < 0 || zn >= nz) continue;
+	    for (y = 0; y < ny; y++) {
+	      yn = y + dy;
+	      if (yn < 0 || yn >= ny) continue;
+	      for (x = 0; x < nx; x++) {
+		xn = x + dx;
+		if (xn < 0 || xn >= nx) continue;
+		if (ra > 0) {
+		  s = nlm_box(IW, nx, ny, nlm_max(x - ra, 0), nlm_min(x + ra, nx - 1),
+			      nlm_max(y - ra, 0), nlm_min(y + ra, ny - 1),
+			      nlm_max(z - ra, zc0) - zc0, nlm_min(z + ra, zc1 - 1) - zc0);
+		} else {
+		  s = W[x + nx * (y + (size_t)ny * (z - zc0))];
+		}
+		if (s <= 0.0) continue;
+		v = A[xn + nx * (yn + (size_t)ny * zn)];
+		if (ctx->rician) v *= v;
+		j = x + nx * (y + (size_t)ny * (z - z0));
+		acc[j] += s * v;
+		wsum[j] += s;
+	      }
+	    }
+	  }
+	}
+
+    /* Centre voxels take the largest neighbor weight, or 1 if none */
+    for (z = zc0; z < zc1; z++) {
+      for (y = 0; y < ny; y++) {
+	for (x = 0; x < nx; x++) {
+	  i = x + nx * (y + (size_t)ny * (z - zc0));
+	  if (z % step || y % step || x % step) W[i] = 0.0;
+	  else W[i] = (Wmax[i] > 0.0) ? Wmax[i] : 1.0;
+	}
+      }
+    }
+
+    if (ra > 0) {
+      for (z = 0; z < ncz; z++)
+	for (y = 0; y < ny; y++)
+	  memcpy(IW + 1 + (y + 1) * sy1 + (z + 1) * sz1, W + nx * (y + (size_t)ny * z), nx * sizeof(double));
+      nlm_integral(IW, nx, ny, ncz);
+    }
+
+    for (z = z0; z < z1; z++) {
+      for (y = 0; y < ny; y++) {
+	for (x = 0; x < nx; x++) {
+	  if (ra > 0) {
+	    s = nlm_box(IW, nx, ny, nlm_max(x - ra, 0), nlm_min(x + ra, nx - 1),
+			nlm_max(y - ra, 0), nlm_min(y + ra, ny - 1),
+			nlm_max(z - ra, zc0) - zc0, nlm_min(z + ra, zc1 - 1) - zc0);
+	  } else {
+	    s = W[x + nx * (y + (size_t)ny * (z - zc0))];
+	  }
+	  i = x + nx * (y + (size_t)ny * z);
+	  v = A[i];
+	  if (ctx->rician) v *= v;
+	  j = x + nx * (y + (size_t)ny * (z - z0));
+	  acc[j] += s * v;
+	  wsum[j] += s;
+
+	  /* Weighted mean, less the Rician bias */
+	  v = acc[j] / wsum[j];
+	  if (ctx->rician) v = sqrt(v > ctx->bias ? v - ctx->bias : 0.0);
+	  ctx->B[i] = v;
+	}
+      }
+    }
+  }
+}
@@ -0,0 +1,299 @@
+/************************************************************
+ * C source for runmed_mex MEX object
+ *
+ * SYNTAX: Y = runmed_mex(X, hk)
+ *         Y = runmed_mex(X, hk, nthreads)
+ *
+ * Running median down each column of X over the window
+ * [p-hk, p+hk], truncated at the ends of the column exactly as
+ * movmed and medianfilt. The window is held in a pair of indexed
+ * heaps (a max-heap below the median and a min-heap above it) so
+ * each sample costs O(log k) to insert and to remove. Even sized
+ * windows at the ends average the two middle values as median
+ * does, and any NaN in the window gives NaN. Columns are
+ * distributed over POSIX threads.
+ *
+ * X        = real double data, one series per column (n x ncol)
+ * hk       = window half-width (samples)
+ * nthreads = number of threads, 0 for all processors [0]
+ *
+ * Y        = running median (n x ncol)
+ *
+ * BUILD  : mex -I../RelaxFit runmed_mex.c
+ *
+ * AUTHOR : Mike Tyszka, Ph.D.
+ * PLACE  : Caltech BIC
+ * DATES  : 10/19/2026 JMT From scratch
+ * REFS   : Hardle W, Steiger W. Appl Stat 1995; 44:258-264
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Mike Tyszka
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ *   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ *   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ *   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ *   Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ *   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ *   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ************************************************************/
+
+#include <stdlib.h>
+#include <math.h>
+#include "mex.h"
+
+#include "voxthreads.h"
+
+/* Input Arguments */
+
+#define	X_IN        prhs[0]
+#define	HK_IN       prhs[1]
+#define	NTHREADS_IN prhs[2]
+
+/* Output Arguments */
+
+#define	Y_OUT       plhs[0]
+
+/* Window of at most nw samples in slots 0..nw-1
+ * lo is a max-heap of the smaller half, hi a min-heap of the rest
+ * pos[slot] is k+1 for lo[k], -(k+1) for hi[k], 0 if not held */
+typedef struct {
+  double *val;
+  int *lo, *hi, *pos;
+  int nlo, nhi;
+} rm_heaps;
+
+typedef struct {
+  const double *X;
+  double *Y;
+  int n;
+  int hk;
+  double nan;
+  void *work[VOX_MAXTHREADS];
+} rm_context;
+
+static void rm_insert(rm_heaps *, int);
+static void rm_remove(rm_heaps *, int);
+static double rm_median(const rm_heaps *);
+static void rm_worker(void *, int, int, int);
+
+/************************************************************
+ * Entry point for MEX call
+ ************************************************************/
+void mexFunction(int nlhs, mxArray *plhs[],
+		 int nrhs, const mxArray *prhs[])
+{
+  rm_context ctx;
+  int ncol, nw, nthreads, t, ok;
+
+  /* Check for proper number of arguments */
+
+  if (nrhs < 2 || nrhs > 3 || nlhs > 1) {
+    mexErrMsgTxt("SYNTAX: Y = runmed_mex(X,hk[,nthreads])");
+  }
+
+  if (!mxIsDouble(X_IN) || mxIsComplex(X_IN))
+    mexErrMsgTxt("runmed_mex : X must be real double");
+
+  ctx.n = (int)mxGetM(X_IN);
+  ncol = (int)(mxGetNumberOfElements(X_IN) / (ctx.n > 0 ? ctx.n : 1));
+  ctx.hk = (int)mxGetScalar(HK_IN);
+  if (ctx.hk < 0) ctx.hk = 0;
+  if (ctx.hk > ctx.n) ctx.hk = ctx.n;
+
+  ctx.X = mxGetPr(X_IN);
+  ctx.nan = mxGetNaN();
+  Y_OUT = mxCreateNumericArray(mxGetNumberOfDimensions(X_IN), mxGetDimensions(X_IN),
+			       mxDOUBLE_CLASS, mxREAL);
+  ctx.Y = mxGetPr(Y_OUT);
+
+  if (ctx.n < 1 || ncol < 1) return;
+
+  nthreads = vox_nthreads((nrhs > 2) ? (int)mxGetScalar(NTHREADS_IN) : 0);
+  if (nthreads > ncol) nthreads = ncol;
+
+  /* Per-thread heaps for a window of up to 2 hk + 1 samples */
+  nw = 2 * ctx.hk + 1;
+  ok = 1;
+  for (t = 0; t < nthreads; t++) {
+    ctx.work[t] = malloc((size_t)nw * (sizeof(double) + 3 * sizeof(int)));
+    if (ctx.work[t] == NULL) ok = 0;
+  }
+
+  if (ok) vox_parallel(ncol, nthreads, rm_worker, &ctx);
+
+  for (t = 0; t < nthreads; t++) free(ctx.work[t]);
+
+  if (!ok) mexErrMsgTxt("runmed_mex : out of memory");
+
+  return;
+}
+
+/************************************************************
+ * Heap helpers. Order: lo by descending value, hi ascending
+ ************************************************************/
+static void rm_place(rm_heaps *h, int *heap, int k, int slot, int sgn)
+{
+  heap[k] = slot;
+  h->pos[slot] = sgn * (k + 1);
+}
+
+static int rm_before(const rm_heaps *h, int sgn, int a, int b)
+{
+  return (sgn > 0) ? (h->val[a] > h->val[b]) : (h->val[a] < h->val[b]);
+}
+
+static void rm_sift(rm_heaps *h, int sgn, int k)
+{
+  int *heap = (sgn > 0) ? h->lo : h->hi;
+  int n = (sgn > 0) ? h->nlo : h->nhi;
+  int slot = heap[k], c, p;
+
+  /* Up */
+  while (k > 0) {
+    p = (k - 1) / 2;
+    if (!rm_before(h, sgn, slot, heap[p])) break;
+    rm_place(h, heap, k, heap[p], sgn);
+    k = p;
+  }
+
+  /* Down */
+  for (;;) {
+    c = 2 * k + 1;
+    if (c >= n) break;
+    if (c + 1 < n && rm_before(h, sgn, heap[c+1], heap[c])) c++;
+    if (!rm_before(h, sgn, heap[c], slot)) break;
+    rm_place(h, heap, k, heap[c], sgn);
+    k = c;
+  }
+
+  rm_place(h, heap, k, slot, sgn);
+}
+
+static void rm_push(rm_heaps *h, int sgn, int slot)
+{
+  if (sgn > 0) {
+    rm_place(h, h->lo, h->nlo, slot, 1);
+    rm_sift(h, 1, h->nlo++);
+  } else {
+    rm_place(h, h->hi, h->nhi, slot, -1);
+    rm_sift(h, -1, h->nhi++);
+  }
+}
+
+/* Remove and return the slot at position k of heap sgn */
+static int rm_take(rm_heaps *h, int sgn, int k)
+{
+  int *heap = (sgn > 0) ? h->lo : h->hi;
+  int *n = (sgn > 0) ? &h->nlo : &h->nhi;
+  int slot = heap[k];
+
+  h->pos[slot] = 0;
+  (*n)--;
+  if (k < *n) {
+    rm_place(h, heap, k, heap[*n], sgn);
+    rm_sift(h, sgn, k);
+  }
+
+  return slot;
+}
+
+/* Keep nlo == nhi or nlo == nhi + 1 */
+static void rm_balance(rm_heaps *h)
+{
+  if (h->nlo > h->nhi + 1) rm_push(h, -1, rm_take(h, 1, 0));
+  else if (h->nhi > h->nlo) rm_push(h, 1, rm_take(h, -1, 0));
+}
+
+/************************************************************
+ * Add or drop the (non-NaN) value held in slot
+ ************************************************************/
+static void rm_insert(rm_heaps *h, int slot)
+{
+  if (h->nlo == 0 || h->val[slot] <= h->val[h->lo[0]]) rm_push(h, 1, slot);
+  else rm_push(h, -1, slot);
+  rm_balance(h);
+}
+
+static void rm_remove(rm_heaps *h, int slot)
+{
+  int p = h->pos[slot];
+
+  if (p > 0) rm_take(h, 1, p - 1);
+  else if (p < 0) rm_take(h, -1, -p - 1);
+  rm_balance(h);
+}
+
+/************************************************************
+ * Median of the held values, averaging the middle pair as
+ * MATLAB median does
+ ************************************************************/
+static double rm_median(const rm_heaps *h)
+{
+  double a, b;
+
+  if (h->nlo > h->nhi) return h->val[h->lo[0]];
+
+  a = h->val[h->lo[0]];
+  b = h->val[h->hi[0]];
+  if ((a < 0.0) != (b < 0.0) || isinf(a) || isinf(b)) return (a + b) / 2.0;
+  return a + (b - a) / 2.0;
+}
+
+/************************************************************
+ * Filter columns [c0, c1) on thread tid
+ ************************************************************/
+static void rm_worker(void *arg, int c0, int c1, int tid)
+{
+  rm_context *ctx = (rm_context *)arg;
+  int n = ctx->n, hk = ctx->hk, nw = 2 * hk + 1;
+  const double *x;
+  double *y;
+  rm_heaps h;
+  int c, p, k, nnan;
+
+  h.val = (double *)ctx->work[tid];
+  h.lo = (int *)(h.val + nw);
+  h.hi = h.lo + nw;
+  h.pos = h.hi + nw;
+
+  for (c = c0; c < c1; c++) {
+
+    x = ctx->X + (size_t)c * n;
+    y = ctx->Y + (size_t)c * n;
+
+    h.nlo = h.nhi = 0;
+    nnan = 0;
+    for (k = 0; k < nw; k++) h.pos[k] = 0;
+
+    /* Sample k lives in slot k % nw while in the window */
+    for (k = 0; k < hk && k < n; k++) {
+      h.val[k % nw] = x[k];
+      if (isnan(x[k])) nnan++; else rm_insert(&h, k % nw);
+    }
+
+    for (p = 0; p < n; p++) {
+
+      /* Window [p-hk, p+hk] : add the leading sample */
+      k = p + hk;
+      if (k < n) {
+	h.val[k % nw] = x[k];
+	if (isnan(x[k])) nnan++; else rm_insert(&h, k % nw);
+      }
+
+      y[p] = (nnan > 0) ? ctx->nan : rm_median(&h);
+
+      /* Drop the trailing sample */
+      k = p - hk;
+      if (k >= 0) {
+	if (isnan(x[k])) nnan--; else rm_remove(&h, k % nw);
+      }
+    }
+  }
+}
@@ -0,0 +1,181 @@
+function pr = fitprogress(action, varargin)
+% Throttled progress and timing reports for long voxelwise loops
+%
+% pr = fitprogress('start', label, ntotal, opts)
+% pr = fitprogress('update', pr, count, msg)
+% pr = fitprogress('stage', pr, name)
+% pr = fitprogress('done', pr)
+%
+% Reports are time based rather than per item. The caller tests
+%
+%   if count >= pr.next, pr = fitprogress('update', pr, count); end
+%
+% inside the loop, so a disabled monitor (pr.next = Inf) costs one
+% scalar comparison per item and no function calls. When enabled,
+% pr.next is extrapolated from the measured rate so that the clock is
+% only read about once per report interval. Each report gives the
+% percentage done, items/s and ETA. 'stage' switches the running timer
+% to a named stage, so repeated stages (eg read, fit, write per slab)
+% accumulate, and 'done' summarizes the stage totals.
+%
+% ARGS:
+% label  = report prefix, eg 'irfitn'
+% ntotal = total number of items (voxels)
+% opts   = logical enable flag or structure of settings
+%   .on       = enable reporting [true]
+%   .interval = minimum seconds between reports [5]
+%   .out      = output file id or function handle called as
+%               fcn(msg, pr) [1 (command window)]
+%   .unit     = item name used in rates, eg 'vol' ['vox']
+% count  = items completed so far
+% msg    = optional text appended to the report, eg current fit values
+% name   = stage name
+%
+% RETURNS:
+% pr     = progress state structure. pr.reported is true if the last
+%          update issued a report (eg to refresh a plot alongside)
+%
+% AUTHOR : Mike Tyszka, Ph.D.
+% PLACE  : Caltech BIC
+% DATES  : 10/19/2026 JMT From scratch
+%
+% The MIT License (MIT)
+%
+% Copyright (c) 2016 Mike Tyszka
+%
+%   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+%   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+%   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+%   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+%
+%   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+%   Software.
+%
+%   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+%   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+%   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+%   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+switch action
+
+  case 'start'
+
+    label = varargin{1};
+    ntotal = varargin{2};
+    if nargin < 4 opts = true; else opts = varargin{3}; end
+    if ~isstruct(opts) opts = struct('on', logical(opts)); end
+    if ~isfield(opts, 'on') opts.on = true; end
+    if ~isfield(opts, 'interval') opts.interval = 5; end
+    if ~isfield(opts, 'out') opts.out = 1; end
+    if ~isfield(opts, 'unit') opts.unit = 'vox'; end
+
+    pr.on = opts.on && ntotal > 0;
+    pr.label = label;
+    pr.ntotal = ntotal;
+    pr.interval = opts.interval;
+    pr.out = opts.out;
+    pr.unit = opts.unit;
+    pr.t0 = tic;
+    pr.tlast = 0;
+    pr.count = 0;
+    pr.reported = false;
+    pr.stages = {};
+    pr.stime = [];
+    pr.cur = 0;
+    pr.tstage = 0;
+
+    % First check after a handful of items to measure the rate
+    if pr.on
+      pr.next = min(ntotal, 16);
+    else
+      pr.next = Inf;
+    end
+
+  case 'update'
+
+    pr = varargin{1};
+    count = varargin{2};
+    if nargin < 4 msg = ''; else msg = varargin{3}; end
+
+    pr.reported = false;
+    if ~pr.on return; end
+
+    pr.count = count;
+    t = toc(pr.t0);
+    rate = count / max(t, eps);
+
+    if t - pr.tlast >= pr.interval || count >= pr.ntotal
+      eta = (pr.ntotal - count) / max(rate, eps);
+      [h,m,s] = hms(round(eta));
+      str = sprintf('%s : %5.1f%% done (%d/%d) %0.1f %s/s ETA %d:%02d:%02.0f', ...
+        pr.label, 100 * count / pr.ntotal, count, pr.ntotal, rate, pr.unit, h, m, s);
+      if ~isempty(msg) str = [str ' : ' msg]; end
+      pr = fp_send(pr, str);
+      pr.tlast = t;
+      pr.reported = true;
+    end
+
+    % Extrapolate the count at the next report time
+    if count >= pr.ntotal
+      pr.next = Inf;
+    else
+      dt = max(pr.interval - (t - pr.tlast), 0.1 * pr.interval);
+      pr.next = min(pr.ntotal, count + max(1, round(rate * dt)));
+    end
+
+  case 'stage'
+
+    pr = varargin{1};
+    if ~pr.on return; end
+
+    pr = fp_stage(pr);
+    pr.cur = find(strcmp(pr.stages, varargin{2}), 1);
+    if isempty(pr.cur)
+      pr.stages{end+1} = varargin{2};
+      pr.stime(end+1) = 0;
+      pr.cur = length(pr.stime);
+    end
+
+  case 'done'
+
+    pr = varargin{1};
+    if ~pr.on return; end
+
+    pr = fp_stage(pr);
+    t = toc(pr.t0);
+    [h,m,s] = hms(t);
+    str = sprintf('%s : %d items in %d:%02d:%04.1f (%0.1f %s/s)', ...
+      pr.label, pr.ntotal, h, m, s, pr.ntotal / max(t, eps), pr.unit);
+    for k = 1:length(pr.stages)
+      str = sprintf('%s\n  %-16s %8.2f s', str, pr.stages{k}, pr.stime(k));
+    end
+    pr = fp_send(pr, str);
+    pr.next = Inf;
+
+  otherwise
+
+    error('fitprogress : unknown action %s', action);
+
+end
+
+%------------------------------------------------------------
+% Close the timing of the current stage
+%------------------------------------------------------------
+function pr = fp_stage(pr)
+
+t = toc(pr.t0);
+if pr.cur > 0
+  pr.stime(pr.cur) = pr.stime(pr.cur) + t - pr.tstage;
+end
+pr.tstage = t;
+
+%------------------------------------------------------------
+% Write a report line to the file id or callback
+%------------------------------------------------------------
+function pr = fp_send(pr, str)
+
+if isa(pr.out, 'function_handle')
+  pr.out(str, pr);
+else
+  fprintf(pr.out, '%s\n', str);
+end
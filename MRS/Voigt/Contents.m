@@ -6,10 +6,13 @@
 %   cerf2           - Approximation 2 to the complex error function
 %   cerf3           - Approximation 3 to the complex error function
 %   cerf4           - Approximation 4 to the complex error function
+%   faddeeva_bench  - Accuracy and throughput benchmark for w(z) approximations
 %   Humlicek        - [cn,c0] = humlicek(x,y)
 %   lsq_model       - Least-square curve fitting function
+%   lsq_model_fid   - Least-square curve fitting function for FIDs
 %   model_demo      - model_demo
 %   model_f0        - Calculate the ppm shifts of NAA, Cr, Cho and water
+%   model_fid       - Time-domain Voigt model FID
 %   model_fit       - Fit a model spectrum of four Voigt resonances to
 %   model_mrs       - s = model_mrs(I, f0, gL, gD, phi, T)
 %   model_ppm       - Calculate the ppm scale for a spectrum
@@ -20,6 +23,8 @@
 %   synth_mrs       - Generate a synthetic long TE 1H brain spectrum
 %   voigt           - V = voigt(f, I0, f0, gL, gD, phi)
 %   voigt_area      - Q = voigt_area(A, gL, gD)
+%   voigt_bench     - Time humlicek_mex and voigt_mex per sample
+%   voigt_cache     - Cached table lookup version of voigt
 %   voigt_demo      - Demonstrate the Voigt lineshape
 %   voigt_fwhm      - 
 %   voigt_fwhm_plot - Contour plot of results with labels
@@ -0,0 +1,305 @@
+/************************************************************
+ * Header-only complex arithmetic routines
+ *
+ * All routines are static inline so that each MEX file gets
+ * its own inlineable copy and the struct-by-value calls
+ * compile away. Replaces Cmath.c/CMATH.H.
+ *
+ * AUTHOR : Mike Tyszka, Ph.D.
+ * PLACE  : Caltech BIC, Pasadena CA
+ * DATES  : 11/11/99 Start from scratch
+ *          10/19/2026 JMT Convert to header-only static inline
+ *          10/19/2026 JMT Add single precision fcomplex routines
+ *          10/19/2026 JMT Keep exact Cmath.c division in dcdiv
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Mike Tyszka
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ *   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ *   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ *   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ *   Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ *   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ *   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ************************************************************/
+
+#ifndef DCOMPLEX_H
+#define DCOMPLEX_H
+
+#include <math.h>
+
+typedef struct {
+  float re, im;
+} fcomplex;
+
+typedef struct {
+  double re, im;
+} dcomplex;
+
+static inline dcomplex dcset(dcomplex a)
+{
+  return a;
+}
+
+static inline dcomplex dcsetri(double a_re, double a_im)
+{
+  dcomplex b;
+  b.re = a_re;
+  b.im = a_im;
+  return b;
+}
+
+static inline dcomplex dcaddr(dcomplex a, double b)
+{
+  a.re += b;
+  return a;
+}
+
+static inline dcomplex dcadd(dcomplex a, dcomplex b)
+{
+  a.re += b.re;
+  a.im += b.im;
+  return a;
+}
+
+static inline dcomplex dcsub(dcomplex a, dcomplex b)
+{
+  a.re -= b.re;
+  a.im -= b.im;
+  return a;
+}
+
+static inline dcomplex dcmultr(dcomplex a, double b)
+{
+  a.re *= b;
+  a.im *= b;
+  return a;
+}
+
+static inline dcomplex dcmult(dcomplex a, dcomplex b)
+{
+  dcomplex c;
+  c.re = a.re * b.re - a.im * b.im;
+  c.im = a.re * b.im + a.im * b.re;
+  return c;
+}
+
+/************************************************************
+ * Complex division a/b
+ * Both parts are divided by |b|^2 as in the original Cmath.c,
+ * so results are unchanged to the last bit. A single reciprocal
+ * of |b|^2 followed by multiplies is cheaper but differs by an
+ * ulp on many samples, so it is deliberately not used.
+ ************************************************************/
+static inline dcomplex dcdiv(dcomplex a, dcomplex b)
+{
+  dcomplex c;
+  double den = b.re * b.re + b.im * b.im;
+  c.re = (a.re * b.re + a.im * b.im) / den;
+  c.im = (a.im * b.re - a.re * b.im) / den;
+  return c;
+}
+
+static inline double dcarg(dcomplex a)
+{
+  return atan2(a.im, a.re);
+}
+
+static inline double dcmod(dcomplex a)
+{
+  return sqrt(a.re * a.re + a.im * a.im);
+}
+
+/************************************************************
+ * Horner evaluation of a[0] + a[1] x + ... + a[n] x^n
+ ************************************************************/
+static inline dcomplex dcpoly(dcomplex x, const double a[], int n)
+{
+  int i;
+  double p_re, p_im, t;
+
+  if (n < 1) return dcsetri(0.0, 0.0);
+
+  p_re = a[n];
+  p_im = 0.0;
+
+  for (i = n-1; i >= 0; i--) {
+    t    = p_re * x.re - p_im * x.im + a[i];
+    p_im = p_re * x.im + p_im * x.re;
+    p_re = t;
+  }
+
+  return dcsetri(p_re, p_im);
+}
+
+/************************************************************
+ * Complex exponential function cexp(z)
+ * If z = x + iy then
+ *  cexp(z) = exp(x) * exp(iy)
+ *          = exp(x) * (cos(y) + i * sin(y))
+ ************************************************************/
+static inline dcomplex dcexp(dcomplex a)
+{
+  dcomplex b;
+  double expx = exp(a.re);
+
+  b.re = expx * cos(a.im);
+  b.im = expx * sin(a.im);
+
+  return b;
+}
+
+/************************************************************
+ * Vector-width variants
+ * Split (re[], im[]) arrays with no branches in the loop body
+ * so the compiler can vectorize across samples.
+ ************************************************************/
+
+/* p[k] = a[0] + a[1] z[k] + ... + a[n] z[k]^n */
+static inline void dcpolyv(int m, const double *z_re, const double *z_im,
+			   const double a[], int n, double *p_re, double *p_im)
+{
+  int i, k;
+  double pr, pi, t;
+
+  for (k = 0; k < m; k++) {
+    pr = a[n];
+    pi = 0.0;
+    for (i = n-1; i >= 0; i--) {
+      t  = pr * z_re[k] - pi * z_im[k] + a[i];
+      pi = pr * z_im[k] + pi * z_re[k];
+      pr = t;
+    }
+    p_re[k] = pr;
+    p_im[k] = pi;
+  }
+}
+
+/* c[k] = a[k] / b[k], c may alias a or b */
+static inline void dcdivv(int m, const double *a_re, const double *a_im,
+			  const double *b_re, const double *b_im,
+			  double *c_re, double *c_im)
+{
+  int k;
+  double den, cr, ci;
+
+  for (k = 0; k < m; k++) {
+    den = b_re[k] * b_re[k] + b_im[k] * b_im[k];
+    cr  = (a_re[k] * b_re[k] + a_im[k] * b_im[k]) / den;
+    ci  = (a_im[k] * b_re[k] - a_re[k] * b_im[k]) / den;
+    c_re[k] = cr;
+    c_im[k] = ci;
+  }
+}
+
+/************************************************************
+ * Single precision routines
+ ************************************************************/
+
+static inline fcomplex fcsetri(float a_re, float a_im)
+{
+  fcomplex b;
+  b.re = a_re;
+  b.im = a_im;
+  return b;
+}
+
+static inline fcomplex fcaddr(fcomplex a, float b)
+{
+  a.re += b;
+  return a;
+}
+
+static inline fcomplex fcsub(fcomplex a, fcomplex b)
+{
+  a.re -= b.re;
+  a.im -= b.im;
+  return a;
+}
+
+static inline fcomplex fcmultr(fcomplex a, float b)
+{
+  a.re *= b;
+  a.im *= b;
+  return a;
+}
+
+static inline fcomplex fcmult(fcomplex a, fcomplex b)
+{
+  fcomplex c;
+  c.re = a.re * b.re - a.im * b.im;
+  c.im = a.re * b.im + a.im * b.re;
+  return c;
+}
+
+static inline fcomplex fcdiv(fcomplex a, fcomplex b)
+{
+  fcomplex c;
+  float den = b.re * b.re + b.im * b.im;
+  c.re = (a.re * b.re + a.im * b.im) / den;
+  c.im = (a.im * b.re - a.re * b.im) / den;
+  return c;
+}
+
+static inline fcomplex fcpoly(fcomplex x, const float a[], int n)
+{
+  int i;
+  float p_re, p_im, t;
+
+  if (n < 1) return fcsetri(0.0f, 0.0f);
+
+  p_re = a[n];
+  p_im = 0.0f;
+
+  for (i = n-1; i >= 0; i--) {
+    t    = p_re * x.re - p_im * x.im + a[i];
+    p_im = p_re * x.im + p_im * x.re;
+    p_re = t;
+  }
+
+  return fcsetri(p_re, p_im);
+}
+
+static inline void fcpolyv(int m, const float *z_re, const float *z_im,
+			   const float a[], int n, float *p_re, float *p_im)
+{
+  int i, k;
+  float pr, pi, t;
+
+  for (k = 0; k < m; k++) {
+    pr = a[n];
+    pi = 0.0f;
+    for (i = n-1; i >= 0; i--) {
+      t  = pr * z_re[k] - pi * z_im[k] + a[i];
+      pi = pr * z_im[k] + pi * z_re[k];
+      pr = t;
+    }
+    p_re[k] = pr;
+    p_im[k] = pi;
+  }
+}
+
+static inline void fcdivv(int m, const float *a_re, const float *a_im,
+			  const float *b_re, const float *b_im,
+			  float *c_re, float *c_im)
+{
+  int k;
+  float den, cr, ci;
+
+  for (k = 0; k < m; k++) {
+    den = b_re[k] * b_re[k] + b_im[k] * b_im[k];
+    cr  = (a_re[k] * b_re[k] + a_im[k] * b_im[k]) / den;
+    ci  = (a_im[k] * b_re[k] - a_re[k] * b_im[k]) / den;
+    c_re[k] = cr;
+    c_im[k] = ci;
+  }
+}
+
+#endif /* DCOMPLEX_H */
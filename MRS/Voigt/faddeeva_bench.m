@@ -0,0 +1,296 @@
+function res = faddeeva_bench(nx, ny, xmax)
+% res = faddeeva_bench(nx, ny, xmax)
+%
+% Accuracy and throughput benchmark for Faddeeva function w(z),
+% z = x + iy, approximations. Throughput is timed over a dense (x, y)
+% grid and accuracy is measured against a tabulated reference.
+%
+% Methods compared:
+%   w4          - Humlicek w4 (humlicek_mex)
+%   w4+weideman - Humlicek w4 with region IV replaced by Weideman N = 32
+%   poppe       - Poppe-Wijers (ACM TOMS 680)
+%   weideman+cf - Weideman N = 32 for |z| < 8, Laplace continued
+%                 fraction beyond (as used in modern Faddeeva packages)
+%
+% The reference, faddeeva_ref.mat, holds w(z) = exp(-z^2) erfc(-iz)
+% evaluated with 40 significant digits in mpmath and rounded to double,
+% on 601 x samples in [-30, 30] and y = 0 plus 41 log-spaced samples in
+% [1e-6, 100]. It is independent of all the methods compared.
+%
+% w4 runs as compiled MEX, the others as vectorized M-code, so the
+% throughputs compare algorithms only within the same implementation.
+%
+% ARGS:
+% nx   = number of x samples in [-xmax, xmax] [2001]
+% ny   = number of log-spaced y samples in [1e-6, 100] plus y = 0 [81]
+% xmax = x range [30]
+%
+% RETURNS:
+% res  = struct array with fields name, maxrelerr (over the reference
+%        table), ptspersec (over the benchmark grid)
+%
+% AUTHOR : Mike Tyszka, Ph.D.
+% PLACE  : Caltech BIC
+% DATES  : 10/19/2026 JMT Adapt from voigtcmp.m
+%          10/19/2026 JMT Independent extended precision reference table
+% REFS   : Humlicek J, JQSRT 1982; 27:437
+%          Weideman JAC, SIAM J Numer Anal 1994; 31:1497-1518
+%          Poppe GPM, Wijers CMJ, ACM TOMS 1990; 16:38-46
+%
+% The MIT License (MIT)
+%
+% Copyright (c) 2016 Mike Tyszka
+%
+%   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+%   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+%   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+%   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+%
+%   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+%   Software.
+%
+%   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+%   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+%   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+%   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+if nargin < 1 nx = 2001; end
+if nargin < 2 ny = 81; end
+if nargin < 3 xmax = 30; end
+
+% Benchmark grid, one y per row
+x = linspace(-xmax, xmax, nx);
+y = [0 logspace(-6, 2, ny)]';
+npts = length(x) * length(y);
+
+% Extended precision reference table
+ref = load(fullfile(fileparts(mfilename('fullpath')), 'faddeeva_ref.mat'));
+
+% Weideman coefficients are constants, so precompute outside timing
+a32 = weideman_coeffs(32);
+
+names = {'w4', 'w4+weideman', 'poppe', 'weideman+cf'};
+nm = length(names);
+
+res = struct('name', names, 'maxrelerr', 0, 'ptspersec', 0);
+
+for m = 1:nm
+
+  tic;
+  faddeeva_eval(names{m}, x, y, a32);
+  t = toc;
+
+  w = faddeeva_eval(names{m}, ref.x, ref.y, a32);
+
+  res(m).maxrelerr = max(abs(w(:) - ref.w(:)) ./ abs(ref.w(:)));
+  res(m).ptspersec = npts / t;
+
+  fprintf('%-12s : max rel err %8.2e  %8.3g points/s\n', ...
+    names{m}, res(m).maxrelerr, res(m).ptspersec);
+
+end
+
+%------------------------------------------------------------
+% Evaluate method name over the grid x (row) by y (column)
+%------------------------------------------------------------
+function w = faddeeva_eval(name, x, y, a32)
+
+[X, Y] = meshgrid(x, y);
+
+switch name
+  case 'w4'
+    w = zeros(size(X));
+    for r = 1:length(y)
+      w(r,:) = humlicek_mex(x, y(r));
+    end
+  case 'w4+weideman'
+    w = w4_weideman(x, y, a32);
+  case 'poppe'
+    w = poppe_wijers(X, Y);
+  case 'weideman+cf'
+    w = weideman_cf(X + 1i * Y, a32, 16);
+end
+
+%------------------------------------------------------------
+% Weideman rational series for |z| < 8, Laplace continued
+% fraction for |z| >= 8
+%------------------------------------------------------------
+function w = weideman_cf(z, a, K)
+
+w = zeros(size(z));
+near = abs(z) < 8;
+w(near) = weideman(z(near), a);
+w(~near) = laplace_cf(z(~near), K);
+
+%------------------------------------------------------------
+% Humlicek w4 with Weideman replacing region IV
+%------------------------------------------------------------
+function w = w4_weideman(x, y, a)
+
+ny = length(y);
+w = zeros(ny, length(x));
+ax = abs(x);
+
+for r = 1:ny
+  w(r,:) = humlicek_mex(x, y(r));
+  if y(r) < 0.75
+    r4 = (ax + y(r) < 5.5) & (y(r) < 0.195 * ax - 0.176);
+    w(r,r4) = weideman(x(r4) + 1i * y(r), a);
+  end
+end
+
+%------------------------------------------------------------
+% Weideman N-term coefficients
+%------------------------------------------------------------
+function a = weideman_coeffs(N)
+
+M = 2 * N;
+M2 = 2 * M;
+k = (-M+1:M-1)';
+L = sqrt(N / sqrt(2));
+theta = k * pi / M;
+t = L * tan(theta / 2);
+f = exp(-t.^2) .* (L^2 + t.^2);
+f = [0; f];
+a = real(fft(fftshift(f))) / M2;
+a = flipud(a(2:N+1));
+
+%------------------------------------------------------------
+% Weideman rational approximation for Im(z) >= 0
+%------------------------------------------------------------
+function w = weideman(z, a)
+
+N = length(a);
+L = sqrt(N / sqrt(2));
+Z = (L + 1i * z) ./ (L - 1i * z);
+p = polyval(a, Z);
+w = 2 * p ./ (L - 1i * z).^2 + (1 / sqrt(pi)) ./ (L - 1i * z);
+
+%------------------------------------------------------------
+% Laplace continued fraction for Im(z) >= 0, large |z|
+% w(z) = (i/sqrt(pi)) / (z - (1/2) / (z - 1 / (z - (3/2) / ...)))
+%------------------------------------------------------------
+function w = laplace_cf(z, K)
+
+r = zeros(size(z));
+for k = K:-1:1
+  r = (k/2) ./ (z - r);
+end
+w = (1i / sqrt(pi)) ./ (z - r);
+
+%------------------------------------------------------------
+% Vectorized Poppe-Wijers algorithm (ACM TOMS 680)
+% Power series near the origin, continued fraction with
+% Laplace-type acceleration elsewhere. Loops run to the largest
+% term count and each point stops updating at its own count.
+%------------------------------------------------------------
+function w = poppe_wijers(x, y)
+
+factor = 1.12837916709551257388;
+
+xabs = abs(x);
+yabs = abs(y);
+xs = xabs / 6.3;
+ys = yabs / 4.4;
+qrho = xs.^2 + ys.^2;
+xquad = xabs.^2 - yabs.^2;
+yquad = 2 * xabs .* yabs;
+
+u = zeros(size(x));
+v = zeros(size(x));
+
+% Power series region
+ps = qrho < 0.085264;
+
+if any(ps(:))
+
+  xq = xquad(ps); yq = yquad(ps);
+  xa = xabs(ps);  ya = yabs(ps);
+
+  q = (1 - 0.85 * ys(ps)) .* sqrt(qrho(ps));
+  n = round(6 + 72 * q);
+  j = 2 * n + 1;
+  xsum = 1 ./ j;
+  ysum = zeros(size(xsum));
+
+  for i = max(n):-1:1
+    act = i <= n;
+    j(act) = j(act) - 2;
+    xaux = (xsum .* xq - ysum .* yq) / i;
+    ynew = (xsum .* yq + ysum .* xq) / i;
+    xsum(act) = xaux(act) + 1 ./ j(act);
+    ysum(act) = ynew(act);
+  end
+
+  u1 = -factor * (xsum .* ya + ysum .* xa) + 1;
+  v1 = factor * (xsum .* xa - ysum .* ya);
+  daux = exp(-xq);
+  u2 = daux .* cos(yq);
+  v2 = -daux .* sin(yq);
+
+  u(ps) = u1 .* u2 - v1 .* v2;
+  v(ps) = u1 .* v2 + v1 .* u2;
+
+end
+
+% Continued fraction region
+cf = ~ps;
+
+if any(cf(:))
+
+  xa = xabs(cf); ya = yabs(cf);
+  qr = qrho(cf); yc = ys(cf);
+
+  big = qr > 1;
+  qs = zeros(size(qr));
+  qs(big) = sqrt(qr(big));
+  qs(~big) = (1 - yc(~big)) .* sqrt(1 - qr(~big));
+
+  h = 1.88 * qs;
+  h(big) = 0;
+  h2 = 2 * h;
+  kapn = round(7 + 34 * qs);
+  kapn(big) = 0;
+  nu = round(16 + 26 * qs);
+  nu(big) = floor(3 + 1442 ./ (26 * qs(big) + 77));
+
+  hb = h > 0;
+  ql = zeros(size(h));
+  ql(hb) = h2(hb) .^ kapn(hb);
+  h2(~hb) = 1;
+
+  rx = zeros(size(xa)); ry = rx;
+  sx = rx; sy = rx;
+
+  for n = max(nu):-1:0
+    act = n <= nu;
+    np1 = n + 1;
+    tx = ya + h + np1 * rx;
+    ty = xa - np1 * ry;
+    c = 0.5 ./ (tx.^2 + ty.^2);
+    rx(act) = c(act) .* tx(act);
+    ry(act) = c(act) .* ty(act);
+    act2 = act & hb & (n <= kapn);
+    tx = ql + sx;
+    sxn = rx .* tx - ry .* sy;
+    syn = ry .* tx + rx .* sy;
+    sx(act2) = sxn(act2);
+    sy(act2) = syn(act2);
+    ql(act2) = ql(act2) ./ h2(act2);
+  end
+
+  uc = factor * rx;
+  vc = factor * ry;
+  uc(hb) = factor * sx(hb);
+  vc(hb) = factor * sy(hb);
+
+  u(cf) = uc;
+  v(cf) = vc;
+
+end
+
+% Real axis and reflection in x
+u(yabs == 0) = exp(-xabs(yabs == 0).^2);
+v(x < 0) = -v(x < 0);
+
+w = u + 1i * v;
@@ -0,0 +1,323 @@
+/************************************************************
+ * Humlicek w4 approximation to the Voigt/Faddeeva function
+ * w(z) = exp(-z^2) * erfc(-iz), z = x + iy
+ *
+ * Shared by voigt_mex.c and humlicek_mex.c
+ *
+ * AUTHOR : Mike Tyszka, Ph.D.
+ * PLACE  : City of Hope
+ * DATES  : 5/21/00 Start from Fortran (Schreier) and
+ *                  Matlab code (JMT)
+ *          10/19/2026 JMT Move to header shared by both MEX files
+ *          10/19/2026 JMT Add single precision humlicek_w4f()
+ * REFS   : Humlicek J, JQSRT 1982; 27:437
+ *          Schreier F JQSRT 1992; 48:743-762
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Mike Tyszka
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ *   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ *   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ *   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ *   Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ *   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ *   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ************************************************************/
+
+#ifndef HUMLICEK_W4_H
+#define HUMLICEK_W4_H
+
+#include "dcomplex.h"
+
+/* Samples per block for the vector-width region I path */
+#define W4_BLOCK 64
+
+static const double w4_a3[5] = {16.4955, 20.20933, 11.96482, 3.778987, 0.5642236};
+static const double w4_b3[6] = {16.4955, 38.82363, 39.27121, 21.69274, 6.699398, 1.0};
+static const double w4_a4[7] = {36183.31, 3321.99, 1540.787, 219.031, 35.7668,
+				1.320522, 0.56419};
+static const double w4_b4[8] = {32066.6, 24322.8, 9022.23, 2186.18, 364.219,
+				61.5704, 1.84144, 1.0};
+
+static const float w4_a3f[5] = {16.4955f, 20.20933f, 11.96482f, 3.778987f, 0.5642236f};
+static const float w4_b3f[6] = {16.4955f, 38.82363f, 39.27121f, 21.69274f, 6.699398f, 1.0f};
+
+/************************************************************
+ * APPROX1(T)   = (T * .5641896) / (.5 + (T * T))
+ ************************************************************/
+static inline dcomplex cerf1(dcomplex t)
+{
+  return dcdiv(dcmultr(t, 0.5641896), dcaddr(dcmult(t, t), 0.5));
+}
+
+/************************************************************
+ * APPROX2(T,U) = (T * (1.410474 + U *.5641896)) / (.75 + (U * (3. + U)))
+ ************************************************************/
+static inline dcomplex cerf2(dcomplex t, dcomplex u)
+{
+  dcomplex p, q;
+
+  p = dcmult(t, dcaddr(dcmultr(u, 0.5641896), 1.410474));
+  q = dcaddr(dcmult(u, dcaddr(u, 3.0)), 0.75);
+
+  return dcdiv(p, q);
+}
+
+/************************************************************
+ * APPROX3(T)   = ( 16.4955 + T * (20.20933 + T * (11.96482 +
+ *                  T * (3.778987 + 0.5642236*T))))
+ *              / ( 16.4955 + T * (38.82363 + T *
+ *                ( 39.27121 + T * (21.69274 + T * (6.699398 + T)))))
+ ************************************************************/
+static inline dcomplex cerf3(dcomplex t)
+{
+  return dcdiv(dcpoly(t, w4_a3, 4), dcpoly(t, w4_b3, 5));
+}
+
+/************************************************************
+ * APPROX4(T,U) = (T * (36183.31 - U * (3321.99 - U * (1540.787 - U
+ *          * (219.031 - U *(35.7668 - U *(1.320522 - U * .56419))))))
+ *        / (32066.6 - U * (24322.8 - U * (9022.23 - U * (2186.18
+ *           - U * (364.219 - U * (61.5704 - U * (1.84144 - U))))))))
+ ************************************************************/
+static inline dcomplex cerf4(dcomplex t, dcomplex u)
+{
+  dcomplex p, q;
+
+  /* Polynomials are all in -U */
+  u = dcmultr(u, -1.0);
+
+  p = dcmult(t, dcpoly(u, w4_a4, 6));
+  q = dcpoly(u, w4_b4, 7);
+
+  return dcdiv(p, q);
+}
+
+/************************************************************
+ * Region I for a block of samples sharing y
+ * Numerator and denominator are built in split arrays and
+ * divided with the vector-width routines.
+ ************************************************************/
+static inline void humlicek_w4_region1(int n, const double x[], double y,
+				       double *c_re, double *c_im)
+{
+  double p_re[W4_BLOCK], p_im[W4_BLOCK];
+  double t_re[W4_BLOCK], t_im[W4_BLOCK];
+  double q_re[W4_BLOCK], q_im[W4_BLOCK];
+  const double b1[3] = {0.5, 0.0, 1.0};
+  int j, k, m;
+
+  for (j = 0; j < n; j += W4_BLOCK) {
+
+    m = (n - j < W4_BLOCK) ? n - j : W4_BLOCK;
+
+    for (k = 0; k < m; k++) {
+      t_re[k] = y;
+      t_im[k] = -x[j+k];
+      p_re[k] = 0.5641896 * t_re[k];
+      p_im[k] = 0.5641896 * t_im[k];
+    }
+
+    dcpolyv(m, t_re, t_im, b1, 2, q_re, q_im);
+    dcdivv(m, p_re, p_im, q_re, q_im, c_re + j, c_im + j);
+  }
+}
+
+/************************************************************
+ * Fast approximation to cerf(z) using the Humlicek w4
+ * algorithm
+ ************************************************************/
+static void humlicek_w4(int n, const double x[], double y, double *c_re, double *c_im)
+{
+  int i;
+  double s, ax;
+  dcomplex t, u, c;
+
+  if (y >= 15) {
+
+    /* All points are in region I */
+    humlicek_w4_region1(n, x, y, c_re, c_im);
+
+  } else if (y < 15 && y >= 5.5) {
+
+    /* Points are in region I or region II */
+
+    for (i = 0; i < n; i++) {
+
+      t = dcsetri(y, -x[i]);
+
+      s = fabs(x[i]) + y;
+
+      if (s >= 15) {
+	c = cerf1(t);
+      } else {
+	u = dcmult(t, t);
+	c = cerf2(t, u);
+      }
+
+      c_re[i] = c.re; c_im[i] = c.im;
+    }
+
+  } else if (y < 5.5 && y >= 0.75) {
+
+    for (i = 0; i < n; i++) {
+
+      t = dcsetri(y, -x[i]);
+
+      s = fabs(x[i]) + y;
+
+      if (s >= 15) {
+	c = cerf1(t);
+      } else if (s < 5.5) {
+	c = cerf3(t);
+      } else {
+	u = dcmult(t, t);
+	c = cerf2(t, u);
+      }
+
+      c_re[i] = c.re; c_im[i] = c.im;
+    }
+
+  } else {
+
+    for (i = 0; i < n; i++) {
+
+      t = dcsetri(y, -x[i]);
+
+      ax = fabs(x[i]);
+      s = ax + y;
+
+      if (s >= 15) {
+	c = cerf1(t);
+      } else if (s < 15.0 && s >= 5.5) {
+	u = dcmult(t, t);
+	c = cerf2(t, u);
+      } else if (s < 5.5 && y >= (0.195 * ax - 0.176)) {
+	c = cerf3(t);
+      } else {
+	u = dcmult(t, t);
+	c = dcsub(dcexp(u), cerf4(t, u));
+      }
+
+      c_re[i] = c.re; c_im[i] = c.im;
+    }
+
+  }
+
+  if (y == 0.0) {
+    for (i = 0; i < n; i++) {
+      c_re[i] = exp(-x[i]*x[i]);
+    }
+  }
+
+}
+
+/************************************************************
+ * Single precision approximations 1-3
+ ************************************************************/
+static inline fcomplex cerf1f(fcomplex t)
+{
+  return fcdiv(fcmultr(t, 0.5641896f), fcaddr(fcmult(t, t), 0.5f));
+}
+
+static inline fcomplex cerf2f(fcomplex t, fcomplex u)
+{
+  fcomplex p, q;
+
+  p = fcmult(t, fcaddr(fcmultr(u, 0.5641896f), 1.410474f));
+  q = fcaddr(fcmult(u, fcaddr(u, 3.0f)), 0.75f);
+
+  return fcdiv(p, q);
+}
+
+static inline fcomplex cerf3f(fcomplex t)
+{
+  return fcdiv(fcpoly(t, w4_a3f, 4), fcpoly(t, w4_b3f, 5));
+}
+
+static inline void humlicek_w4f_region1(int n, const float x[], float y,
+					float *c_re, float *c_im)
+{
+  float p_re[W4_BLOCK], p_im[W4_BLOCK];
+  float t_re[W4_BLOCK], t_im[W4_BLOCK];
+  float q_re[W4_BLOCK], q_im[W4_BLOCK];
+  const float b1[3] = {0.5f, 0.0f, 1.0f};
+  int j, k, m;
+
+  for (j = 0; j < n; j += W4_BLOCK) {
+
+    m = (n - j < W4_BLOCK) ? n - j : W4_BLOCK;
+
+    for (k = 0; k < m; k++) {
+      t_re[k] = y;
+      t_im[k] = -x[j+k];
+      p_re[k] = 0.5641896f * t_re[k];
+      p_im[k] = 0.5641896f * t_im[k];
+    }
+
+    fcpolyv(m, t_re, t_im, b1, 2, q_re, q_im);
+    fcdivv(m, p_re, p_im, q_re, q_im, c_re + j, c_im + j);
+  }
+}
+
+/************************************************************
+ * Single precision Humlicek w4
+ * Regions I-III are evaluated in float. Region IV, where
+ * exp(U) - APPROX4 cancels and the APPROX4 coefficients span
+ * five decades, falls back to double precision per sample.
+ ************************************************************/
+static void humlicek_w4f(int n, const float x[], float y, float *c_re, float *c_im)
+{
+  int i;
+  float s, ax;
+  fcomplex t, u, c;
+  dcomplex td, ud, cd;
+
+  if (y >= 15.0f) {
+
+    humlicek_w4f_region1(n, x, y, c_re, c_im);
+
+  } else {
+
+    for (i = 0; i < n; i++) {
+
+      t = fcsetri(y, -x[i]);
+
+      ax = fabsf(x[i]);
+      s = ax + y;
+
+      if (s >= 15.0f) {
+	c = cerf1f(t);
+      } else if (s >= 5.5f) {
+	u = fcmult(t, t);
+	c = cerf2f(t, u);
+      } else if (y >= 0.75f || y >= (0.195f * ax - 0.176f)) {
+	c = cerf3f(t);
+      } else {
+	td = dcsetri((double)y, -(double)x[i]);
+	ud = dcmult(td, td);
+	cd = dcsub(dcexp(ud), cerf4(td, ud));
+	c = fcsetri((float)cd.re, (float)cd.im);
+      }
+
+      c_re[i] = c.re; c_im[i] = c.im;
+    }
+
+  }
+
+  if (y == 0.0f) {
+    for (i = 0; i < n; i++) {
+      c_re[i] = expf(-x[i]*x[i]);
+    }
+  }
+
+}
+
+#endif /* HUMLICEK_W4_H */
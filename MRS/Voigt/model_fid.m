@@ -0,0 +1,43 @@
+function s = model_fid(t, I, f0, gL, gD, phi, w)
+% s = model_fid(t, I, f0, gL, gD, phi, w)
+%
+% Time-domain Voigt model FID. Counterpart of model_mrs for fitting
+% FIDs directly (eg from parxloadmrsfid or read_rda) without an FFT.
+%
+% t   = Sample time vector (s)
+% I   = FID amplitude vector at t = 0 (spectral area of each line)
+% f0  = Central frequency vector (Hz)
+% gL  = Lorentzian half width vector (Hz)
+% gD  = Doppler (Gaussian) half width vector (Hz)
+% phi = Phase vector in radians
+% w   = Optional apodization matching that applied to the data
+%
+% Truncated and non-uniformly sampled FIDs are handled by passing
+% only the acquired sample times in t.
+%
+% AUTHOR : Mike Tyszka, Ph.D.
+% PLACE  : Caltech BIC
+% DATES  : 10/19/2026 JMT Adapt from model_mrs.m
+%
+% The MIT License (MIT)
+%
+% Copyright (c) 2016 Mike Tyszka
+%
+%   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+%   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+%   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+%   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+%
+%   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+%   Software.
+%
+%   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+%   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+%   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+%   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+if nargin < 7
+  s = voigt_fid_mex(t(:)', I, f0, gL, gD, phi);
+else
+  s = voigt_fid_mex(t(:)', I, f0, gL, gD, phi, w(:)');
+end
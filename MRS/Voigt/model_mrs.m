@@ -1,5 +1,5 @@
-function s = model_mrs(f, I, f0, gL, gD, phi)
-% s = model_mrs(I, f0, gL, gD, phi, T)
+function s = model_mrs(f, I, f0, gL, gD, phi, cached)
+% s = model_mrs(f, I, f0, gL, gD, phi, cached)
 %
 % f   = Frequency vector (ppm)
 % I   = Amplitude vector [4]
@@ -7,6 +7,7 @@ function s = model_mrs(f, I, f0, gL, gD, phi)
 % gL  = Lorentzian width vector [4]
 % gD  = Doppler (Gaussian) width vector [4]
 % phi = Phase vector [4] in radians
+% cached = use tabulated lineshapes from voigt_cache [false]
 %
 % AUTHOR : Mike Tyszka, Ph.D.
 % PLACE  : Caltech BIC
@@ -29,12 +30,18 @@ function s = model_mrs(f, I, f0, gL, gD, phi)
 %   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
 %   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
+if nargin < 7 cached = false; end
+
 n = length(f);
 
 V = zeros(4, n);
 
 for c = 1:4
-  V(c,:) = voigt(f, I(c), f0(c), gL(c), gD(c), phi(c));
+  if cached
+    V(c,:) = voigt_cache(f, I(c), f0(c), gL(c), gD(c), phi(c));
+  else
+    V(c,:) = voigt(f, I(c), f0(c), gL(c), gD(c), phi(c));
+  end
 end
 
 s = sum(V);
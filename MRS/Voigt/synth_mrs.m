@@ -1,4 +1,4 @@
-function [f, s_e, x_e] = synth_mrs(n, cf, df, bw, T, sd_n, sd_b)
+function [f, s_e, x_e] = synth_mrs(n, cf, df, bw, T, sd_n, sd_b, cached)
 % Generate a synthetic long TE 1H brain spectrum
 %
 % n     = number of points
@@ -8,6 +8,7 @@ function [f, s_e, x_e] = synth_mrs(n, cf, df, bw, T, sd_n, sd_b)
 % T     = sample temperature in degC
 % sd_n  = sd of Gaussian noise in AU
 % sd_b  = sd of baseline noise
+% cached = use tabulated lineshapes from voigt_cache [false]
 %
 % AUTHOR : Mike Tyszka, Ph.D.
 % PLACE  : Caltech BIC
@@ -30,6 +31,8 @@ function [f, s_e, x_e] = synth_mrs(n, cf, df, bw, T, sd_n, sd_b)
 %   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
 %   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
+if nargin < 8 cached = false; end
+
 f = model_ppm(n, cf, df, bw);
 f0 = model_f0(T);
 
@@ -41,7 +44,7 @@ phi = [1 1 -0.5 0];
 x_e = [I f0 gL gD phi];
 
 % Generate the four resonance complex spectrum
-s_e = model_mrs(f, I, f0, gL, gD, phi);
+s_e = model_mrs(f, I, f0, gL, gD, phi, cached);
 
 % Add a smoothed random baseline
 b = synth_base(n, sd_b);
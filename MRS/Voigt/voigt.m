@@ -10,6 +10,8 @@ function V = voigt(f, I0, f0, gL, gD, phi)
 % gD  = Doppler (Gaussian) width 
 % phi = Phase in radians
 %
+% Single precision f returns a single precision V
+%
 % AUTHOR : Mike Tyszka, Ph.D.
 % PLACE  : Caltech BIC
 % DATES  : 4/28/00 Start from memory
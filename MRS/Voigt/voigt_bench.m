@@ -0,0 +1,67 @@
+function t_ns = voigt_bench(n, nrep)
+% t_ns = voigt_bench(n, nrep)
+%
+% Time humlicek_mex and voigt_mex per sample over a range of
+% y = sqrt(ln2) * gL / gD covering all four w4 regions.
+% Run before and after rebuilding the MEX files to compare.
+%
+% n    = samples per call [4096]
+% nrep = calls per timing [1000]
+%
+% RETURNS:
+% t_ns = [ny x 2] ns per sample for humlicek_mex and voigt_mex
+%
+% AUTHOR : Mike Tyszka, Ph.D.
+% PLACE  : Caltech BIC
+% DATES  : 10/19/2026 JMT Adapt from voigtcmp.m
+%
+% The MIT License (MIT)
+%
+% Copyright (c) 2016 Mike Tyszka
+%
+%   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+%   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+%   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+%   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+%
+%   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+%   Software.
+%
+%   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+%   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+%   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+%   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+if nargin < 1 n = 4096; end
+if nargin < 2 nrep = 1000; end
+
+% One y per w4 region
+y = [0.05 0.5 3.0 8.0 20.0];
+ny = length(y);
+
+x = linspace(-20, 20, n);
+f = x / sqrt(log(2));
+
+t_ns = zeros(ny, 2);
+
+for k = 1:ny
+
+  % Warm up
+  humlicek_mex(x, y(k));
+
+  tic;
+  for r = 1:nrep
+    humlicek_mex(x, y(k));
+  end
+  t_ns(k,1) = toc / (n * nrep) * 1e9;
+
+  tic;
+  for r = 1:nrep
+    voigt_mex(f, 1, 0, y(k) / sqrt(log(2)), 1, 0);
+  end
+  t_ns(k,2) = toc / (n * nrep) * 1e9;
+
+  fprintf('y = %5.2f : humlicek_mex %6.2f ns/sample  voigt_mex %6.2f ns/sample\n', ...
+    y(k), t_ns(k,1), t_ns(k,2));
+
+end
@@ -0,0 +1,187 @@
+function [V, err] = voigt_cache(f, I0, f0, gL, gD, phi)
+% [V, err] = voigt_cache(f, I0, f0, gL, gD, phi)
+%
+% Generate a complex Voigt lineshape from a cached table of the
+% Humlicek w4 approximation. Drop-in replacement for voigt().
+%
+% Lineshapes sharing the same y = sqrt(ln2) * gL / gD differ only by
+% shift, scale and phase, so w(x + iy) is tabulated once per y over
+% 0 <= x <= xmax and reused. Values are recovered by cubic Hermite
+% interpolation using the exact Faddeeva derivative
+%
+%   dw/dx = -2 z w(z) + 2i/sqrt(pi),  z = x + iy
+%
+% and the symmetry w(-x + iy) = conj(w(x + iy)). The table spacing is
+% halved until the interpolation error at the interval midpoints (where
+% the Hermite error term peaks) is below tol relative to w(iy). If the
+% finest spacing still misses tol no table is kept and every point is
+% evaluated directly. Points beyond xmax fall back to humlicek_mex.
+%
+% voigt_cache('clear') empties the cache.
+%
+% f   = Frequency vector
+% I0  = Amplitude
+% f0  = Central frequency
+% gL  = Lorentzian width
+% gD  = Doppler (Gaussian) width
+% phi = Phase in radians
+%
+% RETURNS:
+% V   = complex Voigt lineshape
+% err = measured max interpolation error relative to V0 for this table
+%       (always below tol, 0 for direct evaluation)
+%
+% AUTHOR : Mike Tyszka, Ph.D.
+% PLACE  : Caltech BIC
+% DATES  : 10/19/2026 JMT Adapt from voigt.m
+%          10/19/2026 JMT Direct evaluation when the table misses tol
+% REFS   : Armstrong BH J Quant Spectrosc Radiat Transfer 1967; 7:61-88
+%          Schreier F JQSRT 1992; 48:743-762
+%
+% The MIT License (MIT)
+%
+% Copyright (c) 2016 Mike Tyszka
+%
+%   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+%   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+%   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+%   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+%
+%   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+%   Software.
+%
+%   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+%   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+%   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+%   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+persistent cache tick
+
+% Table limits and tolerances
+xmax  = 15.0;   % Region I (cerf1) beyond |x| + y >= 15 is cheap anyway
+h0    = 0.1;    % Starting table spacing
+hmin  = 0.0125; % Finest table spacing
+tol   = 5e-5;   % Interpolation error relative to V0 (w4 itself is ~1e-4)
+maxn  = 64;     % Maximum number of cached tables (LRU)
+
+if isempty(cache)
+  cache = struct('y', {}, 'h', {}, 'w', {}, 'dw', {}, 'c0', {}, 'err', {}, 'used', {});
+  tick = 0;
+end
+
+if ischar(f)
+  switch lower(f)
+    case 'clear'
+      cache = [];
+    otherwise
+      fprintf('voigt_cache: unknown command %s\n', f);
+  end
+  V = []; err = [];
+  return
+end
+
+% Numerical scale for x and y
+A = sqrt(log(2)) / gD;
+
+x = (f-f0) * A;
+y = gL * A;
+
+% Look up table for this y, building it if necessary
+k = find([cache.y] == y, 1);
+
+if isempty(k)
+
+  [h, w, dw, c0, err] = build_table(y, xmax, h0, hmin, tol);
+
+  % Evict least recently used table if full
+  if length(cache) >= maxn
+    [~, k] = min([cache.used]);
+    cache(k) = [];
+  end
+
+  k = length(cache) + 1;
+  cache(k).y   = y;
+  cache(k).h   = h;
+  cache(k).w   = w;
+  cache(k).dw  = dw;
+  cache(k).c0  = c0;
+  cache(k).err = err;
+
+end
+
+tick = tick + 1;
+cache(k).used = tick;
+
+tab = cache(k);
+err = tab.err;
+
+% Interpolate w(|x| + iy) from the table
+ax = abs(x);
+c = zeros(size(x));
+
+in = ax < xmax & ~isempty(tab.w);
+c(in) = hermite_interp(ax(in), tab.h, tab.w, tab.dw);
+
+% Direct evaluation for points beyond the table
+if any(~in)
+  c(~in) = humlicek_mex(ax(~in), y);
+end
+
+% w(-x + iy) = conj(w(x + iy))
+neg = x < 0;
+c(neg) = conj(c(neg));
+
+% Normalize V to 1.0 then scale by I0 exp(i phi)
+% The complex conjugate of w(z) gives the correct phase for NMR spectra
+V = I0 * exp(1i * phi) * conj(c) / tab.c0;
+
+%------------------------------------------------------------
+% Tabulate w(x + iy) and dw/dx over [0, xmax]
+%------------------------------------------------------------
+function [h, w, dw, c0, err] = build_table(y, xmax, h, hmin, tol)
+
+while true
+
+  xt = 0:h:xmax;
+  [w, c0] = humlicek_mex(xt, y);
+  dw = -2 * (xt + 1i * y) .* w + 2i / sqrt(pi);
+
+  % Hermite error term t^2 (1-t)^2 peaks at the interval midpoints
+  xm = xt(1:end-1) + h/2;
+  wm = humlicek_mex(xm, y);
+  err = max(abs(hermite_interp(xm, h, w, dw) - wm)) / abs(c0);
+
+  if err < tol
+    break
+  end
+
+  % Finest spacing misses tol : drop the table, evaluate directly
+  if h / 2 < hmin
+    w = []; dw = []; err = 0;
+    break
+  end
+
+  h = h / 2;
+
+end
+
+%------------------------------------------------------------
+% Cubic Hermite interpolation on a uniform grid starting at 0
+%------------------------------------------------------------
+function c = hermite_interp(x, h, w, dw)
+
+u = x / h;
+k = min(floor(u), length(w) - 2);
+t = u - k;
+k = k + 1;
+
+t2 = t .* t;
+s  = 1 - t;
+s2 = s .* s;
+
+h00 = (1 + 2*t) .* s2;
+h10 = t .* s2 * h;
+h01 = t2 .* (3 - 2*t);
+h11 = -t2 .* s * h;
+
+c = h00 .* w(k) + h10 .* dw(k) + h01 .* w(k+1) + h11 .* dw(k+1);
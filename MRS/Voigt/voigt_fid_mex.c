@@ -0,0 +1,265 @@
+/************************************************************
+ * C source for voigt_fid_mex MEX object
+ *
+ * SYNTAX: s = voigt_fid_mex(t, I, f0, gL, gD, phi)
+ *         s = voigt_fid_mex(t, I, f0, gL, gD, phi, w)
+ *
+ * Time-domain Voigt model FID. Each peak is an exponentially
+ * and Gaussian damped complex sinusoid:
+ *
+ *   s(t) = sum_p I_p exp(i phi_p) exp(i 2 pi f0_p t)
+ *                exp(-2 pi gL_p t) exp(-(pi gD_p t)^2 / ln 2)
+ *
+ * which is the inverse Fourier transform of voigt() with
+ * Lorentzian and Gaussian half widths gL and gD (Hz). I is the
+ * FID amplitude at t = 0, ie the spectral area of the line.
+ *
+ * t   = sample times in seconds (1 x nt, t >= 0)
+ * I, f0, gL, gD, phi = peak parameter vectors (1 x np), f0 in Hz
+ * w   = optional apodization applied to the model (1 x nt)
+ *
+ * The samples are advanced by recursive phasor updates, so the
+ * inner loop is multiply-add only and the cost is O(nt * np).
+ * The exponential and Gaussian phasors are reseeded exactly
+ * every BLOCK samples to bound the accumulated rounding error.
+ * Non-uniform t is handled by stepping the underlying uniform
+ * grid when t lies on one (eg truncated or NUS acquisitions)
+ * that is at most GRID_SPAN times longer than t, otherwise each
+ * sample is evaluated directly.
+ *
+ * AUTHOR : Mike Tyszka, Ph.D.
+ * PLACE  : Caltech BIC
+ * DATES  : 10/19/2026 JMT Adapt from voigt_mex.c
+ *          10/19/2026 JMT Absolute grid tolerance and grid length cap
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Mike Tyszka
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ *   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ *   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ *   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ *   Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ *   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ *   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ************************************************************/
+
+#include <math.h>
+#include "mex.h"
+
+#include "dcomplex.h"
+
+/* Grid samples between exact phasor reseeds */
+#define BLOCK 256
+
+/* Tolerance for t lying on a uniform grid, in units of dt */
+#define GRID_TOL 1e-6
+
+/* Longest grid stepped, relative to the number of samples */
+#define GRID_SPAN 4.0
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* Input Arguments */
+
+#define	t_IN   prhs[0]
+#define	I_IN   prhs[1]
+#define	f0_IN  prhs[2]
+#define	gL_IN  prhs[3]
+#define	gD_IN  prhs[4]
+#define	phi_IN prhs[5]
+#define	w_IN   prhs[6]
+
+/* Output Arguments */
+
+#define	S_OUT	plhs[0]
+
+static int grid_index(int, const double *, double *, int *);
+static void fid_grid(int, const double *, const int *, double,
+		     double, double, double, double, double,
+		     double *, double *);
+static void fid_direct(int, const double *, double, double, double, double, double,
+		       double *, double *);
+
+/************************************************************
+ * Entry point for MEX call
+ ************************************************************/
+void mexFunction(int nlhs, mxArray *plhs[],
+		 int nrhs, const mxArray *prhs[])
+{
+  double *t, *I, *f0, *gL, *gD, *phi, *w;
+  double *s_r, *s_i;
+  double dt;
+  int *m;
+  int nt, np, p, k;
+  int on_grid;
+
+  /* Check for proper number of arguments */
+
+  if (nrhs < 6 || nrhs > 7 || nlhs > 1) {
+    mexErrMsgTxt("SYNTAX: s = voigt_fid_mex(t,I,f0,gL,gD,phi[,w])");
+  }
+
+  nt = (int)mxGetNumberOfElements(t_IN);
+  np = (int)mxGetNumberOfElements(I_IN);
+
+  if ((int)mxGetNumberOfElements(f0_IN) != np ||
+      (int)mxGetNumberOfElements(gL_IN) != np ||
+      (int)mxGetNumberOfElements(gD_IN) != np ||
+      (int)mxGetNumberOfElements(phi_IN) != np)
+    mexErrMsgTxt("voigt_fid_mex : I, f0, gL, gD and phi must have the same length");
+
+  if (nrhs == 7 && (int)mxGetNumberOfElements(w_IN) != nt)
+    mexErrMsgTxt("voigt_fid_mex : w must be the same length as t");
+
+  /* Only consider the real parts of the inputs */
+  t = mxGetPr(t_IN);
+  I = mxGetPr(I_IN);
+  f0 = mxGetPr(f0_IN);
+  gL = mxGetPr(gL_IN);
+  gD = mxGetPr(gD_IN);
+  phi = mxGetPr(phi_IN);
+  w = (nrhs == 7) ? mxGetPr(w_IN) : NULL;
+
+  /* Create the complex output FID - zero filled */
+  S_OUT = mxCreateDoubleMatrix(1, nt, mxCOMPLEX);
+  s_r = mxGetPr(S_OUT);
+  s_i = mxGetPi(S_OUT);
+
+  if (nt < 1) return;
+
+  /* Map t onto a uniform grid if possible */
+  m = (int *)mxCalloc(nt, sizeof(int));
+  on_grid = grid_index(nt, t, &dt, m);
+
+  /* Accumulate each peak into the output */
+  for (p = 0; p < np; p++) {
+    if (on_grid) {
+      fid_grid(nt, t, m, dt, I[p], f0[p], gL[p], gD[p], phi[p], s_r, s_i);
+    } else {
+      fid_direct(nt, t, I[p], f0[p], gL[p], gD[p], phi[p], s_r, s_i);
+    }
+  }
+
+  /* Apply the same apodization as the data */
+  if (w != NULL) {
+    for (k = 0; k < nt; k++) {
+      s_r[k] *= w[k];
+      s_i[k] *= w[k];
+    }
+  }
+
+  mxFree(m);
+
+  return;
+}
+
+/************************************************************
+ * Find grid indices m[k] with t[k] = t[0] + m[k] * dt
+ * dt is the smallest positive sample spacing.
+ * Returns 1 if t is increasing and on a grid no longer than
+ * GRID_SPAN * nt samples, 0 otherwise.
+ ************************************************************/
+static int grid_index(int nt, const double *t, double *dt, int *m)
+{
+  int k;
+  double d, u, umax = GRID_SPAN * nt;
+
+  m[0] = 0;
+  *dt = 0.0;
+
+  if (nt < 2) return 1;
+
+  for (k = 1; k < nt; k++) {
+    d = t[k] - t[k-1];
+    if (d <= 0.0) return 0;
+    if (*dt == 0.0 || d < *dt) *dt = d;
+  }
+
+  for (k = 1; k < nt; k++) {
+    u = (t[k] - t[0]) / *dt;
+    if (!(u < umax)) return 0;
+    m[k] = (int)floor(u + 0.5);
+    if (fabs(u - m[k]) > GRID_TOL) return 0;
+  }
+
+  return 1;
+}
+
+/************************************************************
+ * Add one peak on a uniform grid by recursive phasor update
+ *
+ * With t_j = t0 + j dt the damped sinusoid obeys
+ *   c_{j+1} = c_j * z * r_j,   r_{j+1} = r_j * q
+ * where z = exp((i 2 pi f0 - 2 pi gL) dt) is constant and the
+ * Gaussian ratio r_j = exp(-beta (2 t_j dt + dt^2)) itself
+ * decays geometrically by q = exp(-2 beta dt^2).
+ ************************************************************/
+static void fid_grid(int nt, const double *t, const int *m, double dt,
+		     double I, double f0, double gL, double gD, double phi,
+		     double *s_r, double *s_i)
+{
+  double beta = M_PI * M_PI * gD * gD / log(2.0);
+  double q = exp(-2.0 * beta * dt * dt);
+  double zmag = exp(-2.0 * M_PI * gL * dt);
+  dcomplex z = dcsetri(zmag * cos(2.0 * M_PI * f0 * dt),
+		       zmag * sin(2.0 * M_PI * f0 * dt));
+  dcomplex c;
+  double r, tj, amp, ph;
+  int j, k, jend;
+
+  k = 0;
+
+  for (j = 0; j <= m[nt-1]; j = jend) {
+
+    /* Exact reseed at the start of each block */
+    tj  = t[0] + j * dt;
+    amp = I * exp(-2.0 * M_PI * gL * tj - beta * tj * tj);
+    ph  = phi + 2.0 * M_PI * f0 * tj;
+    c   = dcsetri(amp * cos(ph), amp * sin(ph));
+    r   = exp(-beta * (2.0 * tj * dt + dt * dt));
+
+    jend = j + BLOCK;
+    if (jend > m[nt-1] + 1) jend = m[nt-1] + 1;
+
+    /* No transcendental calls from here to the end of the block */
+    for (; j < jend; j++) {
+
+      if (m[k] == j) {
+	s_r[k] += c.re;
+	s_i[k] += c.im;
+	k++;
+      }
+
+      c = dcmultr(dcmult(c, z), r);
+      r *= q;
+    }
+  }
+}
+
+/************************************************************
+ * Add one peak at arbitrary sample times
+ ************************************************************/
+static void fid_direct(int nt, const double *t,
+		       double I, double f0, double gL, double gD, double phi,
+		       double *s_r, double *s_i)
+{
+  double beta = M_PI * M_PI * gD * gD / log(2.0);
+  double amp, ph;
+  int k;
+
+  for (k = 0; k < nt; k++) {
+    amp = I * exp(-2.0 * M_PI * gL * t[k] - beta * t[k] * t[k]);
+    ph  = phi + 2.0 * M_PI * f0 * t[k];
+    s_r[k] += amp * cos(ph);
+    s_i[k] += amp * sin(ph);
+  }
+}
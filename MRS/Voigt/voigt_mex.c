@@ -12,6 +12,8 @@
  * DATES  : 5/21/00 Start from Fortran (Schreier) and
  *                  Matlab code (JMT)
  *          5/22/00 Convert to MEX routine
+ *          10/19/2026 JMT Use shared inline humlicek_w4.h
+ *          10/19/2026 JMT Single precision path for single f
  *
  * The MIT License (MIT)
  *
@@ -34,14 +36,7 @@
 #include <math.h>
 #include "mex.h"
 
-#include "cmath.c"
-
-void humlicek_w4(int, double [], double, double *, double *);
-
-dcomplex cerf1(dcomplex);
-dcomplex cerf2(dcomplex, dcomplex);
-dcomplex cerf3(dcomplex);
-dcomplex cerf4(dcomplex, dcomplex);
+#include "humlicek_w4.h"
 
 /* Input Arguments */
 
@@ -58,19 +53,23 @@ dcomplex cerf4(dcomplex, dcomplex);
 
 /************************************************************
  * Entry point for MEX call
+ * Single precision f returns a single precision V
  ************************************************************/
 void mexFunction(int nlhs, mxArray *plhs[], 
 		 int nrhs, const mxArray *prhs[])
 {
-  double *f, *I, *f0, *gL, *gD, *phi; 
+  double *f;
+  double I, f0, gL, gD, phi;
   double *cn_r, *cn_i;
   double c0_r, c0_i;
   double *v_r, *v_i; 
   double *x; 
+  float *ff, *fx, *fcn_r, *fcn_i, *fv_r, *fv_i;
+  float fsc, fsinphi, fcosphi, fre, fim;
   unsigned int fm, fn, i;
   double x0, y;
   double sqrtln2 = sqrt(log(2.0));
-  double re, im;
+  double re, im, sc;
   double sinphi, cosphi;
     
   /* Check for proper number of arguments */
@@ -85,234 +84,92 @@ void mexFunction(int nlhs, mxArray *plhs[],
   if (fm > 1)
     mexErrMsgTxt("voigt(f,I,f0,gL,gD,phi) : f must be be a 1xN vector");
 
-  /* Create a matrix for the return arguments */ 
-  V_OUT = mxCreateDoubleMatrix(1, fn, mxCOMPLEX);
-    
-  /* Assign pointers to the complex output vector */ 
-  v_r = mxGetPr(V_OUT);
-  v_i = mxGetPi(V_OUT);
-
-  /* Only consider the real parts of the inputs */
-  f = mxGetPr(f_IN); 
-  I = mxGetPr(I_IN);
-  f0 = mxGetPr(f0_IN);
-  gL = mxGetPr(gL_IN);
-  gD = mxGetPr(gD_IN);
-  phi = mxGetPr(phi_IN);
-
-  /* Make temporary space for x[], cn_r[] and cn_i[] - autofreed */
-  x = (double *)mxCalloc(fn, sizeof(double));
-  cn_r = (double *)mxCalloc(fn, sizeof(double));
-  cn_i = (double *)mxCalloc(fn, sizeof(double));
-
-  /* Calculate x and y for the Humlicek w4 algorithm */
-  y = sqrtln2 * gL[0] / gD[0];
-  for (i = 0; i < fn; i++) x[i] = (f[i] - f0[0]) * sqrtln2 / gD[0];
+  if (!mxIsDouble(f_IN) && !mxIsSingle(f_IN))
+    mexErrMsgTxt("voigt(f,I,f0,gL,gD,phi) : f must be double or single");
 
-  /* Call the Humlicek w4 routine */
-  humlicek_w4(fn, x, y, cn_r, cn_i);
+  /* Only consider the real parts of the scalar parameters */
+  I = mxGetScalar(I_IN);
+  f0 = mxGetScalar(f0_IN);
+  gL = mxGetScalar(gL_IN);
+  gD = mxGetScalar(gD_IN);
+  phi = mxGetScalar(phi_IN);
 
-  /* Call routine for x = 0 */
+  /* Calculate y and the normalization for the Humlicek w4 algorithm */
+  y = sqrtln2 * gL / gD;
   x0 = 0.0;
   humlicek_w4(1, &x0, y, &c0_r, &c0_i);
 
-  /* Scale the vector by I / V0 * exp(i * phi) and conjugate */
-  for (i = 0; i < fn; i++) {
+  sc = I / c0_r;
+  sinphi = sin(phi);
+  cosphi = cos(phi);
 
-      re = I[0] / c0_r * cn_r[i];
-      im = -I[0] / c0_r * cn_i[i];
+  if (mxIsSingle(f_IN)) {
 
-      sinphi = sin(phi[0]);
-      cosphi = cos(phi[0]);
+    /* Single precision in and out */
+    V_OUT = mxCreateNumericMatrix(1, fn, mxSINGLE_CLASS, mxCOMPLEX);
+    fv_r = (float *)mxGetData(V_OUT);
+    fv_i = (float *)mxGetImagData(V_OUT);
 
-      v_r[i] = re * cosphi - im * sinphi;
-      v_i[i] = im * cosphi + re * sinphi;
-  }
- 
-  return;
-}
-
-/************************************************************
- * Fast approximation to cerf(z) using the Humlicek w4
- * algorithm
- ************************************************************/
-void humlicek_w4(int n, double x[], double y, double *c_re, double *c_im)
-{
-  int i;
-  double s, ax;
-  dcomplex t, u, c, cexpu;
+    ff = (float *)mxGetData(f_IN);
 
-  if (y >= 15) {
+    fx = (float *)mxCalloc(fn, sizeof(float));
+    fcn_r = (float *)mxCalloc(fn, sizeof(float));
+    fcn_i = (float *)mxCalloc(fn, sizeof(float));
 
-    /* All points are in region I */
+    for (i = 0; i < fn; i++) fx[i] = (float)((ff[i] - f0) * sqrtln2 / gD);
 
-    for (i = 0; i < n; i++) {
-      t = dcsetri(y, -x[i]);
-      c = cerf1(t);
-      c_re[i] = c.re; c_im[i] = c.im;
-    }
-    
-  } else if (y < 15 && y >= 5.5) {
-
-    /* Points are in region I or region II */
+    humlicek_w4f(fn, fx, (float)y, fcn_r, fcn_i);
 
-    for (i = 0; i < n; i++) {
+    fsc = (float)sc;
+    fsinphi = (float)sinphi;
+    fcosphi = (float)cosphi;
 
-      t = dcsetri(y, -x[i]);
+    for (i = 0; i < fn; i++) {
 
-      s = fabs(x[i]) + y;
-
-      if (s >= 15) {
-	c = cerf1(t);
-	c_re[i] = c.re; c_im[i] = c.im;
-      } else {
-	u = dcmult(t, t);
-	c = cerf2(t, u);
-	c_re[i] = c.re; c_im[i] = c.im;
-      }
+      fre = fsc * fcn_r[i];
+      fim = -fsc * fcn_i[i];
 
+      fv_r[i] = fre * fcosphi - fim * fsinphi;
+      fv_i[i] = fim * fcosphi + fre * fsinphi;
     }
 
-  } else if (y < 5.5 && y >= 0.75) {
-
-    for (i = 0; i < n; i++) {
-
-      t = dcsetri(y, -x[i]);
-
-      s = fabs(x[i]) + y;
-
-      if (s >= 15) {
-	c = cerf1(t);
-	c_re[i] = c.re; c_im[i] = c.im;
-      } else if (s < 5.5) {
-	c = cerf3(t);
-	c_re[i] = c.re; c_im[i] = c.im;
-      } else {
-	u = dcmult(t, t);
-	c = cerf2(t, u);
-	c_re[i] = c.re; c_im[i] = c.im;
-      }
-
-    }
-
-  } else {
-
-    for (i = 0; i < n; i++) {
-
-      t = dcsetri(y, -x[i]);
-	  
-      ax = fabs(x[i]);
-      s = ax + y;
-
-      if (s >= 15) {
-	c = cerf1(t);
-	c_re[i] = c.re; c_im[i] = c.im;
-      } else if (s < 15.0 && s >= 5.5) {
-	u = dcmult(t, t);
-	c = cerf2(t, u);
-	c_re[i] = c.re; c_im[i] = c.im;
-      } else if (s < 5.5 && y >= (0.195 * ax - 0.176)) {
-	c = cerf3(t);
-	c_re[i] = c.re; c_im[i] = c.im;
-      } else {
-	u = dcmult(t, t);
-	c = cerf4(t,u);
-	cexpu = dcexp(u);
-	c = dcsub(cexpu, c);
-	c_re[i] = c.re; c_im[i] = c.im;
-      }
-
-    }
+    mxFree(fx);
+    mxFree(fcn_r);
+    mxFree(fcn_i);
 
+    return;
   }
 
-  if (y == 0.0) {
-    for (i = 0; i < n; i++) {
-      c_re[i] = exp(-x[i]*x[i]);
-    }
-  }
-
-}
-
-/************************************************************
- * APPROX1(T)   = (T * .5641896) / (.5 + (T * T))
- ************************************************************/
-dcomplex cerf1(dcomplex t)
-{
-  dcomplex p, q, c;
-
-  p = dcmultr(t, 0.5641896);
-
-  q = dcmult(t,t);
-  q = dcaddr(q, 0.5);
-
-  c = dcdiv(p,q);
-
-  return c;
-}
-/************************************************************
- * APPROX2(T,U) = (T * (1.410474 + U *.5641896)) / (.75 + (U * (3. + U)))
- ************************************************************/
-dcomplex cerf2(dcomplex t, dcomplex u)
-{
-  dcomplex p, q, c;
-
-  p = dcmultr(u, 0.5641896);
-  p = dcaddr(p, 1.410474);
-  p = dcmult(t, p);
-
-  q = dcaddr(u, 3.0);
-  q = dcmult(u, q);
-  q = dcaddr(q, 0.75);
-
-  c = dcdiv(p, q);
-
-  return c;
-}
-
-/************************************************************
- * APPROX3(T)   = ( 16.4955 + T * (20.20933 + T * (11.96482 +
- *                  T * (3.778987 + 0.5642236*T))))
- *              / ( 16.4955 + T * (38.82363 + T *
- *                ( 39.27121 + T * (21.69274 + T * (6.699398 + T)))))
- ************************************************************/
-dcomplex cerf3(dcomplex t)
-{
-  dcomplex p, q, c;
-  double a[5] = {16.4955, 20.20933, 11.96482, 3.778987, 0.5642236};
-  double b[6] = {16.4955, 38.82363, 39.27121, 21.69274, 6.699398, 1.0};
-
-  p = dcpoly(t, a, 4);
-  q = dcpoly(t, b, 5);
-
-  c = dcdiv(p, q);
+  /* Create a matrix for the return arguments */ 
+  V_OUT = mxCreateDoubleMatrix(1, fn, mxCOMPLEX);
+    
+  /* Assign pointers to the complex output vector */ 
+  v_r = mxGetPr(V_OUT);
+  v_i = mxGetPi(V_OUT);
 
-  return c;
-}
+  /* Only consider the real part of f */
+  f = mxGetPr(f_IN); 
 
-/************************************************************
- * APPROX4(T,U) = (T * (36183.31 - U * (3321.99 - U * (1540.787 - U
- *          * (219.031 - U *(35.7668 - U *(1.320522 - U * .56419))))))
- *        / (32066.6 - U * (24322.8 - U * (9022.23 - U * (2186.18
- *           - U * (364.219 - U * (61.5704 - U * (1.84144 - U))))))))
- ************************************************************/
-dcomplex cerf4(dcomplex t, dcomplex u)
-{
-  dcomplex p, q, c;
-  double a[7] = {36183.31, 3321.99, 1540.787, 219.031, 35.7668,
-		1.320522, 0.56419};
-  double b[8] = {32066.6, 24322.8, 9022.23, 2186.18, 364.219,
-		61.5704, 1.84144, 1.0};
+  /* Make temporary space for x[], cn_r[] and cn_i[] - autofreed */
+  x = (double *)mxCalloc(fn, sizeof(double));
+  cn_r = (double *)mxCalloc(fn, sizeof(double));
+  cn_i = (double *)mxCalloc(fn, sizeof(double));
 
-  /* Polynomials are all in -U */
-  u = dcmultr(u, -1.0);
+  /* Calculate x for the Humlicek w4 algorithm */
+  for (i = 0; i < fn; i++) x[i] = (f[i] - f0) * sqrtln2 / gD;
 
-  p = dcpoly(u, a, 6);
-  p = dcmult(t, p);
+  /* Call the Humlicek w4 routine */
+  humlicek_w4(fn, x, y, cn_r, cn_i);
 
-  q = dcpoly(u, b, 7); 
+  /* Scale the vector by I / V0 * exp(i * phi) and conjugate */
+  for (i = 0; i < fn; i++) {
 
-  c = dcdiv(p, q);
+      re = sc * cn_r[i];
+      im = -sc * cn_i[i];
 
-  return c;
+      v_r[i] = re * cosphi - im * sinphi;
+      v_i[i] = im * cosphi + re * sinphi;
+  }
+ 
+  return;
 }
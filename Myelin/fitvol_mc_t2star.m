@@ -0,0 +1,115 @@
+function [rho, T2, mwf, resnorm, dB0, Mask, oes] = fitvol_mc_t2star(TE, S, Mask, nthreads)
+% [rho, T2, mwf, resnorm, dB0, Mask, oes] = fitvol_mc_t2star(TE, S, Mask, nthreads)
+%
+% Whole-volume three compartment T2* and myelin water fraction maps
+% from complex multi-echo gradient echo data. Each voxel gets the same
+% phase regression and bounded 7 parameter magnitude fit as
+% fitvox_mc_t2star, done for all mask voxels in one threaded call to
+% mc_t2star_mex when compiled, otherwise voxel by voxel.
+%
+% ARGS:
+% TE       = echo times (ms) (1 x nte), at least 16 echoes
+% S        = complex N-D data with echo as the final dimension
+% Mask     = voxels to fit [first echo magnitude > 10% of maximum]
+% nthreads = number of threads, 0 for all processors [0]
+%
+% RETURNS:
+% rho     = compartment amplitudes (N-D with 3 in the final dimension)
+% T2      = compartment T2* in ms (N-D with 3 in the final dimension)
+% mwf     = myelin water fraction map
+% resnorm = residual sum of squares map
+% dB0     = mean odd/even echo phase slope map (rad/ms)
+% Mask    = fit mask used
+% oes     = odd-even echo scale factor map
+%
+% AUTHOR : Mike Tyszka, Ph.D.
+% PLACE  : Caltech BIC
+% DATES  : 10/19/2026 JMT From scratch
+%          10/19/2026 JMT Logical mask, return odd-even echo scale
+%
+% The MIT License (MIT)
+%
+% Copyright (c) 2016 Mike Tyszka
+%
+%   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+%   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+%   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+%   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+%
+%   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+%   Software.
+%
+%   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+%   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+%   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+%   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+% Default args
+if nargin < 3 Mask = []; end
+if nargin < 4 nthreads = 0; end
+
+% Get dimensions
+dims = size(S);
+ndims = length(dims);
+nvox = prod(dims(1:(ndims-1)));
+nte = dims(ndims);
+
+if nte ~= length(TE)
+  error('fitvol_mc_t2star : TE does not match final dimension of data');
+end
+
+S = reshape(S, [nvox nte]);
+
+% Default mask from first echo magnitude
+if isempty(Mask)
+  S1 = abs(S(:,1));
+  Mask = S1 > max(S1) * 0.1;
+end
+Mask = Mask(:) ~= 0;
+nmask = sum(Mask);
+
+rho_m = zeros(nmask, 3);
+T2_m = zeros(nmask, 3);
+mwf_m = zeros(nmask, 1);
+resnorm_m = zeros(nmask, 1);
+dB0_m = zeros(nmask, 1);
+oes_m = ones(nmask, 1);
+
+if exist('mc_t2star_mex','file') == 3
+
+  [rho_m, T2_m, mwf_m, resnorm_m, dB0_m, oes_m] = ...
+    mc_t2star_mex(TE(:)', double(S(Mask,:)), nthreads);
+
+else
+
+  Sm = S(Mask,:);
+  for v = 1:nmask
+    res = fitvox_mc_t2star(TE, Sm(v,:));
+    rho_m(v,:) = res.rho;
+    T2_m(v,:) = res.T2;
+    mwf_m(v) = res.mwf;
+    resnorm_m(v) = res.resnorm;
+    dB0_m(v) = res.dB0;
+    oes_m(v) = res.oes;
+  end
+
+end
+
+% Scatter back into full maps
+rho = zeros(nvox, 3); rho(Mask,:) = rho_m;
+T2 = zeros(nvox, 3); T2(Mask,:) = T2_m;
+mwf = zeros(nvox, 1); mwf(Mask) = mwf_m;
+resnorm = zeros(nvox, 1); resnorm(Mask) = resnorm_m;
+dB0 = zeros(nvox, 1); dB0(Mask) = dB0_m;
+oes = zeros(nvox, 1); oes(Mask) = oes_m;
+
+% Reshape maps back to Ndims-1
+vdims = dims(1:(ndims-1));
+if length(vdims) == 1 vdims = [vdims 1]; end
+rho = reshape(rho, [vdims 3]);
+T2 = reshape(T2, [vdims 3]);
+mwf = reshape(mwf, vdims);
+resnorm = reshape(resnorm, vdims);
+dB0 = reshape(dB0, vdims);
+oes = reshape(oes, vdims);
+Mask = reshape(Mask, vdims);
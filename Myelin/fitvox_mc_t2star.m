@@ -87,3 +87,4 @@ res.T2      = X_fit(5:7);
 res.mwf     = res.rho(1) / sum(res.rho);
 res.resnorm = resnorm;
 res.dB0     = dB0;
+res.oes     = X_fit(1);
@@ -0,0 +1,314 @@
+/************************************************************
+ * C source for fnnls_mex MEX object
+ *
+ * SYNTAX: X = fnnls_mex(G, C)
+ *         X = fnnls_mex(G, C, nthreads)
+ *
+ * Batched non-negative least squares with a shared basis. For
+ * each column c of C solve
+ *
+ *   min |A x - b|^2  subject to  x >= 0
+ *
+ * given only the Gram matrix G = A'A (optionally regularized,
+ * eg A'A + mu I) and c = A'b. This is the fast active set NNLS of
+ * Bro and De Jong, which never touches A, so the cost per voxel
+ * depends on the basis size only and the cross products for all
+ * voxels come from a single matrix product in MATLAB.
+ *
+ * G        = shared Gram matrix (n x n, symmetric positive definite)
+ * C        = cross products A'b, one voxel per column (n x nvox)
+ * nthreads = number of threads, 0 for all processors [0]
+ *
+ * X        = non-negative solutions (n x nvox)
+ *
+ * BUILD  : mex -I../RelaxFit fnnls_mex.c
+ *
+ * AUTHOR : Mike Tyszka, Ph.D.
+ * PLACE  : Caltech BIC
+ * DATES  : 10/19/2026 JMT From scratch
+ *          10/19/2026 JMT Incremental Cholesky updates of the passive set
+ * REFS   : Lawson CL, Hanson RJ. Solving Least Squares Problems. 1974
+ *          Bro R, De Jong S. J Chemometrics 1997; 11:393-401
+ *          Golub GH, Van Loan CF. Matrix Computations. 4th ed. 2013; 6.5
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Mike Tyszka
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ *   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ *   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ *   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ *   Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ *   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ *   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+#include "mex.h"
+
+#include "voxthreads.h"
+
+/* Input Arguments */
+
+#define	G_IN        prhs[0]
+#define	C_IN        prhs[1]
+#define	NTHREADS_IN prhs[2]
+
+/* Output Arguments */
+
+#define	X_OUT       plhs[0]
+
+typedef struct {
+  const double *G;
+  const double *C;
+  double *X;
+  int n;
+  double tol;
+  double *work[VOX_MAXTHREADS];
+} nnls_context;
+
+static int chol_add(const double *, const int *, int, int, int, double *);
+static void chol_del(double *, int, int, int);
+static void chol_solve(const double *, const double *, const int *, int, int, double *, double *);
+static void fnnls(const double *, const double *, int, double, double *, double *);
+static void nnls_worker(void *, int, int, int);
+
+/************************************************************
+ * Entry point for MEX call
+ ************************************************************/
+void mexFunction(int nlhs, mxArray *plhs[],
+		 int nrhs, const mxArray *prhs[])
+{
+  nnls_context ctx;
+  int nvox, nthreads, n, i, ok;
+  double gmax;
+
+  /* Check for proper number of arguments */
+
+  if (nrhs < 2 || nrhs > 3 || nlhs > 1) {
+    mexErrMsgTxt("SYNTAX: X = fnnls_mex(G,C[,nthreads])");
+  }
+
+  if (!mxIsDouble(G_IN) || !mxIsDouble(C_IN) || mxIsComplex(G_IN) || mxIsComplex(C_IN))
+    mexErrMsgTxt("fnnls_mex : G and C must be real double");
+
+  ctx.n = (int)mxGetM(G_IN);
+  nvox = (int)mxGetN(C_IN);
+
+  if ((int)mxGetN(G_IN) != ctx.n || (int)mxGetM(C_IN) != ctx.n)
+    mexErrMsgTxt("fnnls_mex : G must be n x n and C must be n x nvox");
+
+  ctx.G = mxGetPr(G_IN);
+  ctx.C = mxGetPr(C_IN);
+
+  X_OUT = mxCreateDoubleMatrix(ctx.n, nvox, mxREAL);
+  ctx.X = mxGetPr(X_OUT);
+
+  if (nvox < 1 || ctx.n < 1) return;
+
+  /* Dual feasibility tolerance scaled to G */
+  gmax = 0.0;
+  for (i = 0; i < ctx.n * ctx.n; i++) if (fabs(ctx.G[i]) > gmax) gmax = fabs(ctx.G[i]);
+  ctx.tol = 10.0 * DBL_EPSILON * gmax * ctx.n;
+
+  nthreads = vox_nthreads((nrhs > 2) ? (int)mxGetScalar(NTHREADS_IN) : 0);
+  if (nthreads > (nvox + VOX_MINCHUNK - 1) / VOX_MINCHUNK)
+    nthreads = (nvox + VOX_MINCHUNK - 1) / VOX_MINCHUNK;
+
+  /* Per-thread workspace: Cholesky factor, index and vectors */
+  ok = 1;
+  for (n = 0; n < nthreads; n++) {
+    ctx.work[n] = (double *)malloc((size_t)ctx.n * (ctx.n + 5) * sizeof(double));
+    if (ctx.work[n] == NULL) ok = 0;
+  }
+
+  if (ok) vox_parallel(nvox, nthreads, nnls_worker, &ctx);
+
+  for (n = 0; n < nthreads; n++) free(ctx.work[n]);
+
+  if (!ok) mexErrMsgTxt("fnnls_mex : out of memory");
+
+  return;
+}
+
+/************************************************************
+ * Append index j to the Cholesky factor L of G_PP for the np
+ * passive indices P. L is lower triangular with leading
+ * dimension n. Returns 0 if G_PP would not be positive definite.
+ ************************************************************/
+static int chol_add(const double *G, const int *P, int np, int n, int j, double *L)
+{
+  int i, k;
+  double sum;
+
+  for (i = 0; i < np; i++) {
+    sum = G[P[i] + j * n];
+    for (k = 0; k < i; k++) sum -= L[i + k*n] * L[np + k*n];
+    L[np + i*n] = sum / L[i + i*n];
+  }
+
+  sum = G[j + j * n];
+  for (k = 0; k < np; k++) sum -= L[np + k*n] * L[np + k*n];
+  if (sum <= 0.0) return 0;
+  L[np + np*n] = sqrt(sum);
+
+  return 1;
+}
+
+/************************************************************
+ * Remove passive position p from the np x np Cholesky factor L.
+ * Rows below p move up one and the resulting superdiagonal is
+ * rotated out column by column with Givens rotations.
+ ************************************************************/
+static void chol_del(double *L, int np, int n, int p)
+{
+  int i, j, c;
+  double a, b, r, cs, sn, x, y;
+
+  for (i = p; i < np-1; i++) {
+    for (j = 0; j <= i+1; j++) L[i + j*n] = L[i+1 + j*n];
+  }
+
+  for (c = p; c < np-1; c++) {
+    a = L[c + c*n];
+    b = L[c + (c+1)*n];
+    r = hypot(a, b);
+    cs = a / r;
+    sn = b / r;
+    for (i = c; i < np-1; i++) {
+      x = L[i + c*n];
+      y = L[i + (c+1)*n];
+      L[i + c*n]     = cs * x + sn * y;
+      L[i + (c+1)*n] = cs * y - sn * x;
+    }
+  }
+}
+
+/************************************************************
+ * Solve G_PP s_P = c_P from the factor L, zeroing s elsewhere.
+ * y is np workspace.
+ ************************************************************/
+static void chol_solve(const double *L, const double *c, const int *P, int np, int n,
+		       double *s, double *y)
+{
+  int i, k;
+  double sum;
+
+  for (i = 0; i < np; i++) {
+    sum = c[P[i]];
+    for (k = 0; k < i; k++) sum -= L[i + k*n] * y[k];
+    y[i] = sum / L[i + i*n];
+  }
+  for (i = np-1; i >= 0; i--) {
+    sum = y[i];
+    for (k = i+1; k < np; k++) sum -= L[k + i*n] * y[k];
+    y[i] = sum / L[i + i*n];
+  }
+
+  for (i = 0; i < n; i++) s[i] = 0.0;
+  for (i = 0; i < np; i++) s[P[i]] = y[i];
+}
+
+/************************************************************
+ * Fast NNLS for one right hand side c, solution in x
+ * work must hold n * (n + 5) doubles
+ *
+ * The Cholesky factor of G_PP is kept in step with the passive
+ * set, one row added or one position removed at a time, so each
+ * inner iteration costs O(|P|^2) rather than O(|P|^3).
+ ************************************************************/
+static void fnnls(const double *G, const double *c, int n, double tol,
+		  double *x, double *work)
+{
+  double *L = work;
+  double *s = L + n * n;       /* s[n] followed by y[n] */
+  double *y = s + n;
+  double *w = s + 2 * n;
+  int *P = (int *)(w + n);     /* passive set, at most n ints in 2n doubles */
+  int np = 0, i, j, k, jmax, iter, inner, maxiter = 3 * n;
+  double wmax, alpha, a;
+
+  for (i = 0; i < n; i++) {
+    x[i] = 0.0;
+    w[i] = c[i];
+  }
+
+  for (iter = 0; iter < maxiter; iter++) {
+
+    /* Most positive dual variable outside the passive set */
+    jmax = -1;
+    wmax = tol;
+    for (j = 0; j < n; j++) {
+      if (x[j] == 0.0 && w[j] > wmax) {
+	for (k = 0; k < np; k++) if (P[k] == j) break;
+	if (k == np) { wmax = w[j]; jmax = j; }
+      }
+    }
+    if (jmax < 0) break;
+
+    /* Numerically dependent basis : keep the current solution */
+    if (!chol_add(G, P, np, n, jmax, L)) return;
+    P[np++] = jmax;
+
+    for (inner = 0; inner < maxiter; inner++) {
+
+      chol_solve(L, c, P, np, n, s, y);
+
+      /* Feasible step */
+      for (k = 0; k < np; k++) if (s[P[k]] <= 0.0) break;
+      if (k == np) break;
+
+      /* Step back to the boundary and drop zeroed variables */
+      alpha = 2.0;
+      for (k = 0; k < np; k++) {
+	i = P[k];
+	if (s[i] <= 0.0) {
+	  a = x[i] / (x[i] - s[i]);
+	  if (a < alpha) alpha = a;
+	}
+      }
+      for (i = 0; i < n; i++) x[i] += alpha * (s[i] - x[i]);
+
+      for (k = np-1; k >= 0; k--) {
+	i = P[k];
+	if (x[i] <= tol) {
+	  x[i] = 0.0;
+	  chol_del(L, np, n, k);
+	  for (j = k; j < np-1; j++) P[j] = P[j+1];
+	  np--;
+	}
+      }
+    }
+
+    for (k = 0; k < np; k++) x[P[k]] = s[P[k]];
+
+    /* Dual w = c - G x */
+    for (i = 0; i < n; i++) {
+      a = c[i];
+      for (k = 0; k < np; k++) a -= G[i + P[k] * n] * x[P[k]];
+      w[i] = a;
+    }
+  }
+}
+
+/************************************************************
+ * Solve voxels [v0, v1) on thread tid
+ ************************************************************/
+static void nnls_worker(void *arg, int v0, int v1, int tid)
+{
+  nnls_context *ctx = (nnls_context *)arg;
+  int v, n = ctx->n;
+
+  for (v = v0; v < v1; v++) {
+    fnnls(ctx->G, ctx->C + (size_t)v * n, n, ctx->tol, ctx->X + (size_t)v * n, ctx->work[tid]);
+  }
+}
@@ -0,0 +1,301 @@
+/************************************************************
+ * C source for mc_t2star_mex MEX object
+ *
+ * SYNTAX: [rho, T2, mwf, resnorm, dB0, oes] = mc_t2star_mex(TE, S)
+ *         [rho, T2, mwf, resnorm, dB0, oes] = mc_t2star_mex(TE, S, nthreads)
+ *
+ * Batched three compartment T2* fit of multi-echo gradient echo
+ * data, the whole-volume equivalent of fitvox_mc_t2star. For each
+ * voxel:
+ *
+ * 1. Odd and even echo phases are unwrapped and regressed against
+ *    TE over the first 8 echoes of each train. dB0 is the mean of
+ *    the two phase slopes (rad/ms), as in fitvox_mc_t2star.
+ * 2. The magnitude decay is fitted by bounded Levenberg-Marquardt
+ *    with analytic Jacobian to
+ *
+ *      S(TE) = g(TE) * sum_j rho_j exp(-TE/T2_j),  j = 1..3
+ *
+ *    with g = 1 for odd and g = oes for even echoes, starting from
+ *    oes = 1, rho = S(1) * [1/5 1/2 1/2], T2 = [10 35 70] ms and
+ *    bounded by T2_1 in [5 15], T2_2 in [30 40], T2_3 in [60 80] ms.
+ *
+ * TE       = echo times in ms (1 x nte)
+ * S        = complex echo signals, one voxel per row (nvox x nte)
+ * nthreads = number of threads, 0 for all processors [0]
+ *
+ * rho      = compartment amplitudes (nvox x 3)
+ * T2       = compartment T2* in ms (nvox x 3)
+ * mwf      = myelin water fraction rho_1 / sum(rho) (nvox x 1)
+ * resnorm  = residual sum of squares (nvox x 1)
+ * dB0      = mean odd/even phase slope (nvox x 1)
+ * oes      = odd-even echo scale factor (nvox x 1)
+ *
+ * BUILD  : mex -I../RelaxFit mc_t2star_mex.c
+ *
+ * AUTHOR : Mike Tyszka, Ph.D.
+ * PLACE  : Caltech BIC
+ * DATES  : 10/19/2026 JMT Adapt from fitvox_mc_t2star.m
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Mike Tyszka
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ *   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ *   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ *   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ *   Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ *   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ *   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ************************************************************/
+
+#include <stdlib.h>
+#include <math.h>
+#include "mex.h"
+
+#include "relaxfit.h"
+#include "voxthreads.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* Echoes per train used for the phase regression */
+#define NPHASE 8
+
+/* Parameter vector [oes rho_1 rho_2 rho_3 T2_1 T2_2 T2_3] */
+#define NPAR 7
+
+static const double mc_lb[NPAR] = {0.0, 0.0, 0.0, 0.0,  5.0, 30.0, 60.0};
+static const double mc_ub[NPAR] = {HUGE_VAL, HUGE_VAL, HUGE_VAL, HUGE_VAL, 15.0, 40.0, 80.0};
+
+/* Input Arguments */
+
+#define	TE_IN       prhs[0]
+#define	S_IN        prhs[1]
+#define	NTHREADS_IN prhs[2]
+
+/* Output Arguments */
+
+#define	RHO_OUT     plhs[0]
+#define	T2_OUT      plhs[1]
+#define	MWF_OUT     plhs[2]
+#define	RESNORM_OUT plhs[3]
+#define	DB0_OUT     plhs[4]
+#define	OES_OUT     plhs[5]
+
+typedef struct {
+  const double *TE;
+  const double *S_r;
+  const double *S_i;
+  double *rho;
+  double *T2;
+  double *mwf;
+  double *resnorm;
+  double *dB0;
+  double *oes;
+  int nvox;
+  int nte;
+  double *work[VOX_MAXTHREADS];
+} mc_context;
+
+static void mc_eval(const double *, const double *, int, double *, double *);
+static double phase_slope(const double *, const double *, const double *, int, int, double *);
+static void mc_worker(void *, int, int, int);
+
+static const rf_model mc_model = {"mc_t2star", NPAR, mc_eval, 0, 0, 0, NULL, NULL};
+
+/************************************************************
+ * Entry point for MEX call
+ ************************************************************/
+void mexFunction(int nlhs, mxArray *plhs[],
+		 int nrhs, const mxArray *prhs[])
+{
+  mc_context ctx;
+  int nthreads, n, ok;
+
+  /* Check for proper number of arguments */
+
+  if (nrhs < 2 || nrhs > 3 || nlhs > 6) {
+    mexErrMsgTxt("SYNTAX: [rho,T2,mwf,resnorm,dB0,oes] = mc_t2star_mex(TE,S[,nthreads])");
+  }
+
+  if (!mxIsDouble(S_IN) || !mxIsDouble(TE_IN))
+    mexErrMsgTxt("mc_t2star_mex : TE and S must be double");
+
+  ctx.nte = (int)mxGetNumberOfElements(TE_IN);
+  ctx.nvox = (int)mxGetM(S_IN);
+
+  if ((int)mxGetN(S_IN) != ctx.nte)
+    mexErrMsgTxt("mc_t2star_mex : S must have one column per echo");
+
+  if (ctx.nte < 2 * NPHASE)
+    mexErrMsgTxt("mc_t2star_mex : at least 16 echoes required");
+
+  ctx.TE = mxGetPr(TE_IN);
+  ctx.S_r = mxGetPr(S_IN);
+  ctx.S_i = mxIsComplex(S_IN) ? mxGetPi(S_IN) : NULL;
+
+  nthreads = vox_nthreads((nrhs > 2) ? (int)mxGetScalar(NTHREADS_IN) : 0);
+
+  RHO_OUT = mxCreateDoubleMatrix(ctx.nvox, 3, mxREAL);
+  T2_OUT = mxCreateDoubleMatrix(ctx.nvox, 3, mxREAL);
+  MWF_OUT = mxCreateDoubleMatrix(ctx.nvox, 1, mxREAL);
+  RESNORM_OUT = mxCreateDoubleMatrix(ctx.nvox, 1, mxREAL);
+  DB0_OUT = mxCreateDoubleMatrix(ctx.nvox, 1, mxREAL);
+  OES_OUT = mxCreateDoubleMatrix(ctx.nvox, 1, mxREAL);
+
+  ctx.rho = mxGetPr(RHO_OUT);
+  ctx.T2 = mxGetPr(T2_OUT);
+  ctx.mwf = mxGetPr(MWF_OUT);
+  ctx.resnorm = mxGetPr(RESNORM_OUT);
+  ctx.dB0 = mxGetPr(DB0_OUT);
+  ctx.oes = mxGetPr(OES_OUT);
+
+  if (ctx.nvox < 1) return;
+
+  if (nthreads > (ctx.nvox + VOX_MINCHUNK - 1) / VOX_MINCHUNK)
+    nthreads = (ctx.nvox + VOX_MINCHUNK - 1) / VOX_MINCHUNK;
+
+  /* Per-thread workspace: magnitude, phase and LM workspace */
+  ok = 1;
+  for (n = 0; n < nthreads; n++) {
+    ctx.work[n] = (double *)malloc((size_t)ctx.nte * (NPAR + 5) * sizeof(double));
+    if (ctx.work[n] == NULL) ok = 0;
+  }
+
+  if (ok) vox_parallel(ctx.nvox, nthreads, mc_worker, &ctx);
+
+  for (n = 0; n < nthreads; n++) free(ctx.work[n]);
+
+  if (!ok) mexErrMsgTxt("mc_t2star_mex : out of memory");
+
+  return;
+}
+
+/************************************************************
+ * Three compartment model with odd-even echo scaling
+ * Echo k (0-based) is odd for even k
+ ************************************************************/
+static void mc_eval(const double *p, const double *TE, int nte, double *f, double *J)
+{
+  double E[3], T2[3], g, sum;
+  int j, k;
+
+  for (j = 0; j < 3; j++) T2[j] = (p[4+j] > RF_TMIN) ? p[4+j] : RF_TMIN;
+
+  for (k = 0; k < nte; k++) {
+
+    g = (k % 2) ? p[0] : 1.0;
+
+    sum = 0.0;
+    for (j = 0; j < 3; j++) {
+      E[j] = exp(-TE[k] / T2[j]);
+      sum += p[1+j] * E[j];
+    }
+
+    f[k] = g * sum;
+
+    if (J) {
+      J[k] = (k % 2) ? sum : 0.0;
+      for (j = 0; j < 3; j++) {
+	J[k + (1+j)*nte] = g * E[j];
+	J[k + (4+j)*nte] = g * p[1+j] * E[j] * TE[k] / (T2[j] * T2[j]);
+      }
+    }
+  }
+}
+
+/************************************************************
+ * Unwrapped phase regression over the first n echoes of the
+ * train starting at echo k0 with stride 2
+ * Returns the slope, intercept in *phi0
+ ************************************************************/
+static double phase_slope(const double *TE, const double *S_r, const double *S_i,
+			  int nvox, int k0, double *phi0)
+{
+  double x, y, prev = 0.0, off = 0.0, d;
+  double Sx = 0.0, Sy = 0.0, Sxx = 0.0, Sxy = 0.0, b;
+  int n, k;
+
+  for (n = 0; n < NPHASE; n++) {
+
+    k = k0 + 2 * n;
+    x = TE[k];
+    y = (S_i != NULL) ? atan2(S_i[(size_t)k * nvox], S_r[(size_t)k * nvox])
+                      : ((S_r[(size_t)k * nvox] < 0.0) ? M_PI : 0.0);
+
+    /* Unwrap as MATLAB unwrap() : jumps beyond pi become 2 pi steps */
+    if (n > 0) {
+      d = y - prev;
+      if (d > M_PI) off -= 2.0 * M_PI * floor((d + M_PI) / (2.0 * M_PI));
+      else if (d < -M_PI) off += 2.0 * M_PI * floor((M_PI - d) / (2.0 * M_PI));
+    }
+    prev = y;
+    y += off;
+
+    Sx += x; Sy += y; Sxx += x * x; Sxy += x * y;
+  }
+
+  b = (Sxy - Sx * Sy / NPHASE) / (Sxx - Sx * Sx / NPHASE);
+  *phi0 = (Sy - b * Sx) / NPHASE;
+
+  return b;
+}
+
+/************************************************************
+ * Fit voxels [v0, v1) on thread tid
+ ************************************************************/
+static void mc_worker(void *arg, int v0, int v1, int tid)
+{
+  mc_context *ctx = (mc_context *)arg;
+  int nte = ctx->nte, nvox = ctx->nvox;
+  double *s = ctx->work[tid];
+  double p[NPAR], phi0, b_odd, b_even, rsum;
+  const double *S_i;
+  double re, im;
+  int v, k, j, it;
+
+  for (v = v0; v < v1; v++) {
+
+    S_i = (ctx->S_i != NULL) ? ctx->S_i + v : NULL;
+
+    /* B0 offset from odd and even echo phase slopes */
+    b_odd  = phase_slope(ctx->TE, ctx->S_r + v, S_i, nvox, 0, &phi0);
+    b_even = phase_slope(ctx->TE, ctx->S_r + v, S_i, nvox, 1, &phi0);
+    ctx->dB0[v] = 0.5 * (b_odd + b_even);
+
+    /* Magnitude decay */
+    for (k = 0; k < nte; k++) {
+      re = ctx->S_r[v + (size_t)k * nvox];
+      im = (S_i != NULL) ? S_i[(size_t)k * nvox] : 0.0;
+      s[k] = sqrt(re * re + im * im);
+    }
+
+    p[0] = 1.0;
+    p[1] = s[0] / 5.0;
+    p[2] = s[0] / 2.0;
+    p[3] = s[0] / 2.0;
+    p[4] = 10.0;
+    p[5] = 35.0;
+    p[6] = 70.0;
+
+    ctx->resnorm[v] = rf_lm_fit(&mc_model, ctx->TE, s, nte, p, mc_lb, mc_ub,
+				200, 1e-6, s + nte, &it);
+
+    rsum = 0.0;
+    for (j = 0; j < 3; j++) {
+      ctx->rho[v + j * nvox] = p[1+j];
+      ctx->T2[v + j * nvox] = p[4+j];
+      rsum += p[1+j];
+    }
+    ctx->mwf[v] = (rsum > 0.0) ? p[1] / rsum : 0.0;
+    ctx->oes[v] = p[0];
+  }
+}
@@ -0,0 +1,135 @@
+function [spec, mwf, T2gm, T2grid, Mask] = t2spectrum(TE, S, opts)
+% [spec, mwf, T2gm, T2grid, Mask] = t2spectrum(TE, S, opts)
+%
+% Regularized non-negative T2 spectrum and myelin water fraction maps
+% from multi-echo spin echo magnitude data. Each voxel decay is
+% expanded over a fixed log-spaced T2 basis A and solved as
+%
+%   min |A x - s|^2 + mu |x|^2  subject to  x >= 0
+%
+% The basis is identical for every voxel, so the Tikhonov regularized
+% Gram matrix A'A + mu I is formed once and the cross products A's for
+% all voxels come from a single matrix product. The threaded fnnls_mex
+% active set solver is used when compiled, otherwise lsqnonneg on the
+% equivalent augmented system voxel by voxel.
+%
+% The basis is pure exponential decay; stimulated echoes from imperfect
+% refocusing are not modelled.
+%
+% ARGS:
+% TE   = echo times (ms) (1 x nte)
+% S    = N-D magnitude data with echo as the final dimension
+% opts = optional structure of settings
+%   .T2       = T2 basis (ms) [60 log-spaced points from 10 to 2000 ms]
+%   .lambda   = regularization relative to mean diag(A'A) [1e-3]
+%   .mwfcut   = myelin water T2 cutoff (ms) [40]
+%   .Mask     = voxels to fit [first echo > 10% of maximum]
+%   .nthreads = number of threads, 0 for all processors [0]
+%
+% RETURNS:
+% spec   = T2 spectrum amplitudes (N-D with nT2 in the final dimension)
+% mwf    = myelin water fraction map (spectrum fraction below mwfcut)
+% T2gm   = geometric mean T2 map (ms)
+% T2grid = T2 basis (ms) (1 x nT2)
+% Mask   = fit mask used
+%
+% AUTHOR : Mike Tyszka, Ph.D.
+% PLACE  : Caltech BIC
+% DATES  : 10/19/2026 JMT From scratch
+% REFS   : Whittall KP, MacKay AL. J Magn Reson 1989; 84:134-152
+%          Bro R, De Jong S. J Chemometrics 1997; 11:393-401
+%
+% The MIT License (MIT)
+%
+% Copyright (c) 2016 Mike Tyszka
+%
+%   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+%   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+%   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+%   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+%
+%   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+%   Software.
+%
+%   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+%   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+%   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+%   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+% Default args
+if nargin < 3 opts = struct(); end
+if ~isfield(opts, 'T2') opts.T2 = logspace(log10(10), log10(2000), 60); end
+if ~isfield(opts, 'lambda') opts.lambda = 1e-3; end
+if ~isfield(opts, 'mwfcut') opts.mwfcut = 40; end
+if ~isfield(opts, 'Mask') opts.Mask = []; end
+if ~isfield(opts, 'nthreads') opts.nthreads = 0; end
+
+T2grid = opts.T2(:)';
+nT2 = length(T2grid);
+
+% Get dimensions
+dims = size(S);
+ndims = length(dims);
+nvox = prod(dims(1:(ndims-1)));
+nte = dims(ndims);
+
+if nte ~= length(TE)
+  error('t2spectrum : TE does not match final dimension of data');
+end
+
+S = reshape(double(abs(S)), [nvox nte]);
+
+% Default mask from first echo
+Mask = opts.Mask;
+if isempty(Mask)
+  Mask = S(:,1) > max(S(:,1)) * 0.1;
+end
+Mask = Mask(:) ~= 0;
+nmask = sum(Mask);
+
+% Shared exponential basis and regularized Gram matrix
+A = exp(-TE(:) * (1 ./ T2grid));
+G = A' * A;
+mu = opts.lambda * mean(diag(G));
+G = G + mu * eye(nT2);
+
+% Cross products for all mask voxels at once
+C = A' * S(Mask,:)';
+
+if exist('fnnls_mex','file') == 3
+
+  X = fnnls_mex(G, C, opts.nthreads);
+
+else
+
+  Aaug = [A; sqrt(mu) * eye(nT2)];
+  Sm = S(Mask,:);
+  z = zeros(nT2, 1);
+  X = zeros(nT2, nmask);
+  nnopts = optimset('Display', 'off');
+  for v = 1:nmask
+    X(:,v) = lsqnonneg(Aaug, [Sm(v,:)'; z], nnopts);
+  end
+
+end
+
+% Spectrum summaries
+tot = sum(X, 1);
+tot(tot == 0) = Inf;
+mw = T2grid < opts.mwfcut;
+mwf_m = sum(X(mw,:), 1) ./ tot;
+T2gm_m = exp((log(T2grid) * X) ./ tot);
+T2gm_m(isinf(tot)) = 0;
+
+% Scatter back into full maps
+spec = zeros(nvox, nT2); spec(Mask,:) = X';
+mwf = zeros(nvox, 1); mwf(Mask) = mwf_m;
+T2gm = zeros(nvox, 1); T2gm(Mask) = T2gm_m;
+
+% Reshape maps back to Ndims-1
+vdims = dims(1:(ndims-1));
+if length(vdims) == 1 vdims = [vdims 1]; end
+spec = reshape(spec, [vdims nT2]);
+mwf = reshape(mwf, vdims);
+T2gm = reshape(T2gm, vdims);
+Mask = reshape(Mask, vdims);
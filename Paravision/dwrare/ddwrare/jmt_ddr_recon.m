@@ -16,6 +16,7 @@ function jmt_ddr_recon(study_dir,hardi_scans,method)
 %
 % AUTHOR : Mike Tyszka, Ph.D.
 % DATES  : 09/13/2007 JMT From scratch
+%          10/19/2026 JMT Add progress and stage timing reports
 %
 % The MIT License (MIT)
 %
@@ -150,8 +151,14 @@ if debug && isequal(method,'optimized')
     '#','RawRes','RndRes0','EstRes0','RndRes','EstRes','RndIt','EstIt','Gx','Gy','Gz');
 end
 
+% Volume rate, ETA and per-stage timing. Each volume takes seconds, so
+% update every pass and let the report interval do the throttling
+pr = fitprogress('start', 'jmt_ddr_recon', nhardi, struct('unit', 'vol'));
+
 for dc = 1:nhardi
 
+  pr = fitprogress('stage', pr, 'load');
+
   % HARDI scan directory name
   hardi_no = hardi_scans(dc);
   hardi_fname = fullfile(study_dir,num2str(hardi_no));
@@ -169,6 +176,8 @@ for dc = 1:nhardi
   %---------------------------------------------
   % Numerical calculation of b-matrix
   %---------------------------------------------
+
+  pr = fitprogress('stage', pr, 'b-matrix');
   
   bval_ideal = info.bfactor;
   bvec_ideal = info.diffdir;
@@ -203,6 +212,8 @@ for dc = 1:nhardi
   % - applied to DWIs only
   %--------------------------------------------
 
+  pr = fitprogress('stage', pr, 'phase correction');
+
   if info.bfactor > 0.0
     switch lower(method)
       case 'optimized'
@@ -214,6 +225,8 @@ for dc = 1:nhardi
     k_corr = k;
   end
 
+  pr = fitprogress('stage', pr, 'filter/FFT');
+
   % Apply phase rolls from geometry prescription to each dimension
   k_corr = pvmphaseroll(k_corr,info);
 
@@ -241,6 +254,8 @@ for dc = 1:nhardi
 
   if debug && info.bfactor > 0.0 && isequal(method,'optimized')
 
+    pr = fitprogress('stage', pr, 'debug');
+
     % Get k-space dimensions
     [nx,ny,nz] = size(k);
 
@@ -327,8 +342,12 @@ for dc = 1:nhardi
 
   end
 
+  pr = fitprogress('update', pr, dc);
+
 end
 
+fitprogress('done', pr);
+
 % Close the optimization log file if debugging
 if debug && isequal(method,'optimized')
   fclose(fd_log);
@@ -17,6 +17,7 @@ function jmt_dr_hardi_recon(study_dir, hardi_scans, samp_type, method)
 % DATES  : 09/13/2007 JMT From scratch
 %          02/26/2008 JMT Rename for HARDI recon
 %          2015-03-27 JMT Update for latest jmt_dr results
+%          10/19/2026 JMT Add progress and stage timing reports
 %
 % The MIT License (MIT)
 %
@@ -173,9 +174,15 @@ if debug && isequal(method, 'optimized')
     '#','RawRes','EstRes','EstIt','Gx','Gy','Gz');
 end
 
+% Volume rate, ETA and per-stage timing. Each volume takes seconds, so
+% update every pass and let the report interval do the throttling
+pr = fitprogress('start', 'jmt_dr_hardi_recon', nhardi, struct('unit', 'vol'));
+
 % Loop includes S(0) scans
 for dc = 1:nhardi
 
+  pr = fitprogress('stage', pr, 'load');
+
   % HARDI scan directory name
   hardi_no = hardi_scans(dc);
   hardi_fname = fullfile(study_dir,num2str(hardi_no));
@@ -193,6 +200,8 @@ for dc = 1:nhardi
   %---------------------------------------------
   % Numerical calculation of b-matrix
   %---------------------------------------------
+
+  pr = fitprogress('stage', pr, 'b-matrix');
   
   bval_ideal = info.bfactor;
   bvec_ideal = info.diffdir;
@@ -225,6 +234,8 @@ for dc = 1:nhardi
   fprintf('  Sequence b-factor   : %0.1f s/mm^2\n', bval_ideal);
   fprintf('  Calculated b-factor : %0.1f s/mm^2\n', bval_sim);
   
+  pr = fitprogress('stage', pr, 'phase correction');
+
   % Reorder ky dimension of DWI k-space
   k(:,ky_order(:),:) = k; 
   
@@ -252,6 +263,8 @@ for dc = 1:nhardi
     k_corr = k;
   end
   
+  pr = fitprogress('stage', pr, 'filter/FFT');
+
   % Apply phase rolls from geometry prescription to each dimension
   k_corr = pvmphaseroll(k_corr,info);
 
@@ -278,6 +291,8 @@ for dc = 1:nhardi
 
   if debug && info.bfactor > 0.0 && isequal(method,'optimized')
 
+    pr = fitprogress('stage', pr, 'debug');
+
     % Save optimization results in log file
     fprintf(fd_log, '%6d %12.5g %12.5g %6d %8.3f %8.3f %8.3f\n', ...
       dc, optres.resnorm_raw, optres.resnorm_est, optres.iters_est, ...
@@ -333,8 +348,12 @@ for dc = 1:nhardi
 
   end
 
+  pr = fitprogress('update', pr, dc);
+
 end
 
+fitprogress('done', pr);
+
 % Close the optimization log file if debugging
 if debug && isequal(method,'optimized')
   fclose(fd_log);
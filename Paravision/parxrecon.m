@@ -32,6 +32,7 @@ function [s,info,errmsg] = parxrecon(sdir,options)
 %          03/22/2004 JMT Add FID filter
 %          01/17/2006 JMT M-Lint corrections
 %          2015-04-06 JMT Add optional Nifti output
+%          10/19/2026 JMT Apply cached apodbank kernels without full filter arrays
 %
 % The MIT License (MIT)
 %
@@ -117,46 +118,25 @@ switch info.uflare_echopath
     %----------------------------------------------------------
   
     if verbose; fprintf('  Spatial filtering: '); end
+
+    % Cached kernels, broadcast over slices for 2D acquisitions
+    dims = [nx ny nz];
+    dims = dims(1:nDim);
+
     switch options.filttype
       
       case 'hamming'
         if verbose; fprintf('Hamming [%f]\n',options.fr); end
-        switch nDim
-          case 2
-            Hfilt = hamming2([nx ny], options.fr, info.echopos/100);
-            Hfilt = repmat(Hfilt,[1 1 nz]);
-          case 3
-            Hfilt = hamming3([nx ny nz], options.fr, info.echopos/100);
-        end
-        
-        % Apply filter
-        k = k .* Hfilt;
+        k = apodize(k, apodbank('hamming', dims, options.fr, [], info.echopos/100));
               
       case 'gauss'
         gauss_fwhm = options.fr * 2;
         if verbose; fprintf('Radial Gauss [FWHM %f voxels]\n',gauss_fwhm); end
-        switch nDim
-          case 2
-            Hfilt = gauss2([nx ny], gauss_fwhm, info.echopos/100);
-            Hfilt = repmat(Hfilt,[1 1 nz]);
-          case 3
-            Hfilt = gauss3([nx ny nz], gauss_fwhm, info.echopos/100);
-        end
-        
-        % Apply filter
-        k = k .* Hfilt;
+        k = apodize(k, apodbank('gauss', dims, gauss_fwhm, [], info.echopos/100));
         
       case 'fermi'
         if verbose; fprintf('Fermi [%f %f]\n',options.fr, options.fw); end
-        switch nDim
-          case 2
-            Hfilt = fermi2([nx ny], options.fr, options.fw, info.echopos/100);
-          case 3
-            Hfilt = fermi3([nx ny nz], options.fr, options.fw, info.echopos/100);
-        end
-
-        % Apply filter
-        k = k .* Hfilt;
+        k = apodize(k, apodbank('fermi', dims, options.fr, options.fw, info.echopos/100));
         
       otherwise
         if verbose; fprintf('None\n'); end
@@ -174,10 +154,9 @@ switch info.uflare_echopath
       % Fermi filter is asymmetric. Radius set empirically
       Hfid = fermi(nx, 0.5-options.fidw*5, options.fidw);
       Hfid = flip(Hfid,1);
-      Hfid = repmat(Hfid(:), [1 ny nz]);
 
-      % Apply filter
-      k = k .* Hfid;
+      % Apply filter along the read dimension
+      k = bsxfun(@times, k, Hfid(:));
       
     end
 
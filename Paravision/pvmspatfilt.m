@@ -14,6 +14,7 @@ function kf = pvmspatfilt(k, filttype, fr, fw, echopos)
 % PLACE  : Caltech
 % DATES  : 09/10/2007 JMT Extract and adapt from parxrecon.m
 %          2015-04-05 JMT Map fr to FWHM for Gauss filtering
+%          10/19/2026 JMT Apply cached apodbank kernels without full filter arrays
 %
 % The MIT License (MIT)
 %
@@ -35,6 +36,8 @@ function kf = pvmspatfilt(k, filttype, fr, fw, echopos)
 % k-space dimensionality (presumed <= 3)
 nDim = ndims(k);
 [nx,ny,nz] = size(k);
+dims = [nx ny nz];
+dims = dims(1:nDim);
 
 %----------------------------------------------------------
 % Spatial filter
@@ -44,44 +47,18 @@ switch filttype
 
   case 'hamming'
 
-    switch nDim
-      case 2
-        Hfilt = hamming2([nx ny], fr, echopos/100);
-        Hfilt = repmat(Hfilt,[1 1 nz]);
-      case 3
-        Hfilt = hamming3([nx ny nz], fr, echopos/100);
-    end
-
-    % Apply filter
-    kf = k .* Hfilt;
+    kf = apodize(k, apodbank('hamming', dims, fr, [], echopos/100));
 
   case 'gauss'
     
     % For Gauss filtering, fr is the FWHM of the PSF in voxels
     FWHM = fr;
 
-    switch nDim
-      case 2
-        Hfilt = gauss2([nx ny], FWHM, echopos/100);
-        Hfilt = repmat(Hfilt,[1 1 nz]);
-      case 3
-        Hfilt = gauss3([nx ny nz], FWHM, echopos/100);
-    end
-
-    % Apply filter
-    kf = k .* Hfilt;
+    kf = apodize(k, apodbank('gauss', dims, FWHM, [], echopos/100));
 
   case 'fermi'
 
-    switch nDim
-      case 2
-        Hfilt = fermi2([nx ny], fr, fw, echopos/100);
-      case 3
-        Hfilt = fermi3([nx ny nz], fr, fw, echopos/100);
-    end
-
-    % Apply filter
-    kf = k .* Hfilt;
+    kf = apodize(k, apodbank('fermi', dims, fr, fw, echopos/100));
 
   otherwise
 
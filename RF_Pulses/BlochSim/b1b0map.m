@@ -0,0 +1,71 @@
+function R = b1b0map(t, B1, G, z, band, b1scale, dB0, T2, nthreads)
+% R = b1b0map(t, B1, G, z, band, b1scale, dB0, T2, nthreads)
+%
+% B1 x off-resonance (x T2) robustness map of a slice selective RF
+% pulse. The slice profile is simulated over the whole grid in one
+% threaded call to b1b0map_mex, replacing repeated full simulations
+% per B1 scale as in b1slr. T1 recovery during the pulse is ignored.
+%
+% ARGS :
+% t        = time vector (s), uniformly sampled
+% B1       = RF waveform (T), real or complex
+% G        = slice gradient waveform (T/m)
+% z        = isochromat positions through the slice (m)
+% band     = 1 passband, -1 stopband, 0 transition for each position
+% b1scale  = relative B1 values [0.05:0.05:2.0]
+% dB0      = off-resonance values (Hz) [-500:25:500]
+% T2       = transverse relaxation times (s) [Inf]
+% nthreads = number of threads, 0 for all processors [0]
+%
+% RETURNS :
+% R = structure with the grid axes and metrics over the grid
+%     (nb1 x nb0 x nT2)
+%   b1scale, dB0, T2 = grid axes
+%   pass   = mean passband |Mxy|
+%   stop   = mean stopband |Mxy|
+%   ripple = passband |Mxy| range
+%   ratio  = stop / pass
+%   mxy    = complex slice profiles (npos x nb1 x nb0 x nT2)
+%
+% AUTHOR : Mike Tyszka, Ph.D.
+% PLACE  : Caltech BIC
+% DATES  : 10/19/2026 JMT Adapt from b1slr.m
+%
+% The MIT License (MIT)
+%
+% Copyright (c) 2016 Mike Tyszka
+%
+%   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+%   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+%   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+%   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+%
+%   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+%   Software.
+%
+%   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+%   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+%   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+%   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+% Default args
+if nargin < 6 || isempty(b1scale) b1scale = 0.05:0.05:2.0; end
+if nargin < 7 || isempty(dB0) dB0 = -500:25:500; end
+if nargin < 8 || isempty(T2) T2 = Inf; end
+if nargin < 9 nthreads = 0; end
+
+if exist('b1b0map_mex','file') ~= 3
+  error('b1b0map : compile b1b0map_mex first (mex -I../../RelaxFit b1b0map_mex.c)');
+end
+
+[pass, stop, ripple, mxy] = b1b0map_mex(t(:).', B1(:).', G(:).', z(:), ...
+  b1scale(:)', dB0(:)', T2(:)', double(band(:)), nthreads);
+
+R.b1scale = b1scale(:)';
+R.dB0 = dB0(:)';
+R.T2 = T2(:)';
+R.pass = pass;
+R.stop = stop;
+R.ripple = ripple;
+R.ratio = stop ./ pass;
+R.mxy = mxy;
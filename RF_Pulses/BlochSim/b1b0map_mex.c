@@ -0,0 +1,279 @@
+/************************************************************
+ * C source for b1b0map_mex MEX object
+ *
+ * SYNTAX: [pass, stop, ripple, mxy] = b1b0map_mex(t, B1, G, z, b1scale, dB0, T2, band)
+ *         [pass, stop, ripple, mxy] = b1b0map_mex(t, B1, G, z, b1scale, dB0, T2, band, nthreads)
+ *
+ * Robustness map of an RF pulse. The slice profile along z is
+ * simulated for every combination of B1 scale, off-resonance and
+ * transverse relaxation, starting from M = (0, 0, 1). Rotations
+ * follow bloch_mex. The RF and gradient waveforms, and |B1|^2 per
+ * sample, are computed once and shared by all threads. A B1 scale
+ * only stretches the transverse field and an off-resonance only
+ * shifts the longitudinal field of each sample. Every (isochromat,
+ * grid point) pair is an independent task on the thread pool.
+ * T1 recovery during the pulse is ignored.
+ *
+ * t        = time vector (s), uniformly sampled
+ * B1       = RF waveform (T, real or complex, 1 x nt)
+ * G        = slice gradient waveform (T/m, 1 x nt)
+ * z        = isochromat positions (m, npos x 1)
+ * b1scale  = relative B1 values (1 x nb1)
+ * dB0      = off-resonance values (Hz, 1 x nb0)
+ * T2       = transverse relaxation times (s, 1 x nt2), [] or Inf for none
+ * band     = 1 passband, -1 stopband, 0 ignored for each position (npos x 1)
+ * nthreads = number of threads, 0 for all processors [0]
+ *
+ * pass     = mean |Mxy| over the passband (nb1 x nb0 x nt2)
+ * stop     = mean |Mxy| over the stopband (nb1 x nb0 x nt2)
+ * ripple   = max - min |Mxy| over the passband (nb1 x nb0 x nt2)
+ * mxy      = complex slice profiles (npos x nb1 x nb0 x nt2)
+ *
+ * BUILD  : mex -I../../RelaxFit b1b0map_mex.c
+ *
+ * AUTHOR : Mike Tyszka, Ph.D.
+ * PLACE  : Caltech BIC
+ * DATES  : 10/19/2026 JMT Adapt from bloch_mex.c
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Mike Tyszka
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ *   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ *   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ *   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ *   Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ *   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ *   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ************************************************************/
+
+#include <stdlib.h>
+#include <float.h>
+#include <math.h>
+#include "mex.h"
+
+#include "voxthreads.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* 1H gamma in rad/s/T */
+#define GAMMA_1H (2.6754e8)
+
+/* Input Arguments */
+
+#define	T_IN        prhs[0]
+#define	B1_IN       prhs[1]
+#define	G_IN        prhs[2]
+#define	Z_IN        prhs[3]
+#define	B1SCALE_IN  prhs[4]
+#define	DB0_IN      prhs[5]
+#define	T2_IN       prhs[6]
+#define	BAND_IN     prhs[7]
+#define	NTHREADS_IN prhs[8]
+
+/* Output Arguments */
+
+#define	PASS_OUT    plhs[0]
+#define	STOP_OUT    plhs[1]
+#define	RIPPLE_OUT  plhs[2]
+#define	MXY_OUT     plhs[3]
+
+typedef struct {
+  double dt;
+  int nt;
+  int npos;
+  int nb1;
+  int nb0;
+  const double *B1r;
+  const double *B1i;
+  const double *B1sq;
+  const double *G;
+  const double *z;
+  const double *b1scale;
+  const double *dB0;
+  const double *T2;
+  double *mr, *mi;
+} map_context;
+
+static void map_worker(void *, int, int, int);
+
+/************************************************************
+ * Entry point for MEX call
+ ************************************************************/
+void mexFunction(int nlhs, mxArray *plhs[],
+		 int nrhs, const mxArray *prhs[])
+{
+  map_context ctx;
+  mxArray *MXY;
+  mwSize dims[4];
+  double *B1sq, *tv, *band, *pass, *stop, *ripple;
+  double m, mmin, mmax, spass, sstop;
+  double Tinf = HUGE_VAL;
+  int nt2, ncell, nthreads, npass, nstop, c, p, k;
+
+  /* Check for proper number of arguments */
+
+  if (nrhs < 8 || nrhs > 9 || nlhs > 4) {
+    mexErrMsgTxt("SYNTAX: [pass,stop,ripple,mxy] = b1b0map_mex(t,B1,G,z,b1scale,dB0,T2,band[,nthreads])");
+  }
+
+  if (!mxIsDouble(T_IN) || !mxIsDouble(B1_IN) || !mxIsDouble(G_IN) || !mxIsDouble(Z_IN) ||
+      !mxIsDouble(B1SCALE_IN) || !mxIsDouble(DB0_IN) || !mxIsDouble(BAND_IN))
+    mexErrMsgTxt("b1b0map_mex : arguments must be double");
+
+  ctx.nt = (int)mxGetNumberOfElements(T_IN);
+  ctx.npos = (int)mxGetNumberOfElements(Z_IN);
+  ctx.nb1 = (int)mxGetNumberOfElements(B1SCALE_IN);
+  ctx.nb0 = (int)mxGetNumberOfElements(DB0_IN);
+  nt2 = mxIsEmpty(T2_IN) ? 1 : (int)mxGetNumberOfElements(T2_IN);
+
+  if ((int)mxGetNumberOfElements(B1_IN) != ctx.nt || (int)mxGetNumberOfElements(G_IN) != ctx.nt)
+    mexErrMsgTxt("b1b0map_mex : t, B1 and G must have the same length");
+
+  if ((int)mxGetNumberOfElements(BAND_IN) != ctx.npos)
+    mexErrMsgTxt("b1b0map_mex : band must have one value per position");
+
+  if (ctx.nt < 2)
+    mexErrMsgTxt("b1b0map_mex : at least two time samples required");
+
+  /* Assume uniform temporal sampling as bloch_mex */
+  tv = mxGetPr(T_IN);
+  ctx.dt = tv[1] - tv[0];
+
+  ctx.B1r = mxGetPr(B1_IN);
+  ctx.B1i = mxGetPi(B1_IN);  /* NULL for a real waveform */
+  ctx.G = mxGetPr(G_IN);
+  ctx.z = mxGetPr(Z_IN);
+  ctx.b1scale = mxGetPr(B1SCALE_IN);
+  ctx.dB0 = mxGetPr(DB0_IN);
+  ctx.T2 = mxIsEmpty(T2_IN) ? &Tinf : mxGetPr(T2_IN);
+  band = mxGetPr(BAND_IN);
+
+  /* Shared per-sample |B1|^2 */
+  B1sq = (double *)mxMalloc((size_t)ctx.nt * sizeof(double));
+  for (k = 0; k < ctx.nt; k++) {
+    B1sq[k] = ctx.B1r[k] * ctx.B1r[k];
+    if (ctx.B1i != NULL) B1sq[k] += ctx.B1i[k] * ctx.B1i[k];
+  }
+  ctx.B1sq = B1sq;
+
+  dims[0] = ctx.npos; dims[1] = ctx.nb1; dims[2] = ctx.nb0; dims[3] = nt2;
+  MXY = mxCreateNumericArray(4, dims, mxDOUBLE_CLASS, mxCOMPLEX);
+  ctx.mr = mxGetPr(MXY);
+  ctx.mi = mxGetPi(MXY);
+
+  ncell = ctx.nb1 * ctx.nb0 * nt2;
+
+  if (ctx.npos > 0 && ncell > 0) {
+    nthreads = vox_nthreads((nrhs > 8) ? (int)mxGetScalar(NTHREADS_IN) : 0);
+    k = (ctx.npos * ncell + VOX_MINCHUNK - 1) / VOX_MINCHUNK;
+    if (nthreads > k) nthreads = k;
+    vox_parallel(ctx.npos * ncell, nthreads, map_worker, &ctx);
+  }
+
+  mxFree(B1sq);
+
+  /* Pass and stop band metrics for each grid point */
+  dims[0] = ctx.nb1; dims[1] = ctx.nb0; dims[2] = nt2;
+  PASS_OUT = mxCreateNumericArray(3, dims, mxDOUBLE_CLASS, mxREAL);
+  STOP_OUT = mxCreateNumericArray(3, dims, mxDOUBLE_CLASS, mxREAL);
+  RIPPLE_OUT = mxCreateNumericArray(3, dims, mxDOUBLE_CLASS, mxREAL);
+  pass = mxGetPr(PASS_OUT);
+  stop = mxGetPr(STOP_OUT);
+  ripple = mxGetPr(RIPPLE_OUT);
+
+  for (c = 0; c < ncell; c++) {
+    spass = sstop = 0.0;
+    npass = nstop = 0;
+    mmin = DBL_MAX;
+    mmax = 0.0;
+    for (p = 0; p < ctx.npos; p++) {
+      k = p + c * ctx.npos;
+      m = sqrt(ctx.mr[k] * ctx.mr[k] + ctx.mi[k] * ctx.mi[k]);
+      if (band[p] > 0.0) {
+	spass += m;
+	npass++;
+	if (m < mmin) mmin = m;
+	if (m > mmax) mmax = m;
+      } else if (band[p] < 0.0) {
+	sstop += m;
+	nstop++;
+      }
+    }
+    pass[c] = (npass > 0) ? spass / npass : mxGetNaN();
+    stop[c] = (nstop > 0) ? sstop / nstop : mxGetNaN();
+    ripple[c] = (npass > 0) ? mmax - mmin : mxGetNaN();
+  }
+
+  if (nlhs > 3) MXY_OUT = MXY; else mxDestroyArray(MXY);
+
+  return;
+}
+
+/************************************************************
+ * Simulate tasks [v0, v1) on thread tid
+ * Task v is position v % npos of grid point v / npos
+ ************************************************************/
+static void map_worker(void *arg, int v0, int v1, int tid)
+{
+  map_context *ctx = (map_context *)arg;
+  double s1, s2, bz0, E2, z;
+  double Mx, My, Mz, mx, my, mz;
+  double bx, by, bz, B, rx, ry, rz, theta, st, ct, tt;
+  int v, c, k;
+
+  (void)tid;
+
+  for (v = v0; v < v1; v++) {
+
+    z = ctx->z[v % ctx->npos];
+    c = v / ctx->npos;
+
+    /* Grid point : B1 scale, off-resonance field and T2 decay per sample */
+    s1 = ctx->b1scale[c % ctx->nb1];
+    bz0 = 2.0 * M_PI * ctx->dB0[(c / ctx->nb1) % ctx->nb0] / GAMMA_1H;
+    E2 = exp(-ctx->dt / ctx->T2[c / (ctx->nb1 * ctx->nb0)]);
+    s2 = s1 * s1;
+
+    Mx = 0.0; My = 0.0; Mz = 1.0;
+
+    for (k = 0; k < ctx->nt; k++) {
+
+      bz = ctx->G[k] * z + bz0;
+      B = sqrt(s2 * ctx->B1sq[k] + bz * bz);
+
+      if (B > 0.0) {
+
+	bx = s1 * ctx->B1r[k];
+	by = (ctx->B1i != NULL) ? s1 * ctx->B1i[k] : 0.0;
+	rx = bx / B; ry = by / B; rz = bz / B;
+
+	/* Precession about B_eff as bloch_mex (Graphics Gems I p466) */
+	theta = GAMMA_1H * B * ctx->dt;
+	st = sin(theta);
+	ct = cos(theta);
+	tt = 1.0 - ct;
+
+	mx = (tt * rx * rx + ct) * Mx + (tt * rx * ry + st * rz) * My + (tt * rx * rz - st * ry) * Mz;
+	my = (tt * rx * ry - st * rz) * Mx + (tt * ry * ry + ct) * My + (tt * ry * rz + st * rx) * Mz;
+	mz = (tt * rx * rz + st * ry) * Mx + (tt * ry * rz - st * rx) * My + (tt * rz * rz + ct) * Mz;
+
+	Mx = mx; My = my; Mz = mz;
+      }
+
+      Mx *= E2;
+      My *= E2;
+    }
+
+    ctx->mr[v] = Mx;
+    ctx->mi[v] = My;
+  }
+}
@@ -2,8 +2,20 @@
  * Calculate the isodelay for RF refocusing and the gradient
  * delay for gradient refocusing.
  *
+ * IsoDelay() uses phase finite differences at the isocenter of
+ * the full simulation grid. IsoDelayFit() fits a plane to the
+ * unwrapped phase of a passband-only grid by weighted least
+ * squares, which is robust to noise and phase wraps and needs far
+ * fewer isochromats, so it suits pulse design loops.
+ *
+ * Results are appended to the binary <pulsename>.ssb container
+ * (see ssbin.h). Compile with -DSS_TEXT_EXPORT to also write the
+ * original <pulsename>.iso text file.
+ *
  * AUTHOR : Mike Tyszka, Ph.D.
  * DATES  : 1999-01-18 JMT From scratch
+ *          2026-10-19 JMT Write results to binary .ssb container
+ *          2026-10-19 JMT Add weighted phase regression in IsoDelayFit
  * PLACE  : City of Hope, Duarte CA
  *
  * The MIT License (MIT)
@@ -25,12 +37,18 @@
  ************************************************************/
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <math.h>
 #include <nmr.h>
 #include <ss.h>
 #include <bloch.h>
 #include <jmt.h>
 
+#include "ssbin.h"
+
+static int WriteIso(char *pulsename, SSPARS *ssp, float tiso, float tg);
+static void UnwrapStep(double *theta, float *mx, float *my, int loc, int prev);
+
 /************************************************************
  * Calculate the isodelay and gradient delay from the final
  * mxy distribution.
@@ -47,8 +65,6 @@ int IsoDelay(char *pulsename,
 	     float *tiso,
 	     float *tg)
 {
-  FILE *fd;
-  char isoname[512];
   float mx0, my0;
   float mxx, myx;
   float mxw, myw;
@@ -114,8 +130,165 @@ int IsoDelay(char *pulsename,
     printf("IsoDelay: Isodelay       = %g us\n", *tiso * 1e6);
   }
 
+  return WriteIso(pulsename, ssp, *tiso, *tg);
+}
+
+/************************************************************
+ * Isodelay and gradient delay by weighted linear regression of
+ * the unwrapped mxy phase over the passband.
+ * w and x sample only the passband (nw x nx, indexed by LOC as
+ * for IsoDelay), so only passband isochromats need simulating.
+ * The phase is unwrapped outward from the grid center, first
+ * along x through the center w column and then along w, using
+ * the phase difference of neighboring isochromats. Isochromats
+ * are weighted by |mxy|^2, the inverse variance of their phase.
+ * The full phase plane is fitted whenever nw >= 2, so the x slope
+ * is unbiased by any w dependence. Spectral-spatial pulses need
+ * nw >= 2 for the w slope, and nw == 1 fits the x slope alone.
+ * Results are written as for IsoDelay unless pulsename is NULL.
+ ************************************************************/
+int IsoDelayFit(char *pulsename,
+		SSPARS *ssp,
+		int nw,
+		int nx,
+		float *w,
+		float *x,
+		float *mx,
+		float *my,
+		float *tiso,
+		float *tg)
+{
+  double *theta;
+  double wt, sw, w0, x0, t0;
+  double dw, dx, dt;
+  double sww = 0.0, sxx = 0.0, swx = 0.0, swt = 0.0, sxt = 0.0;
+  double det, dtheta_dw = 0.0, dtheta_dx = 0.0;
+  int hnx = nx/2;
+  int hnw = nw/2;
+  int iw, ix, loc;
+  int fitw = nw > 1;
+
+  /* The spectral-spatial isodelay needs at least two w samples */
+  if (nx < 2 || nw < 1 || (ssp->ssflag && !fitw)) return FAILURE;
+
+  if ((theta = (double *)malloc((size_t)nw * nx * sizeof(double))) == NULL) {
+    fprintf(stderr, "IsoDelayFit: Out of memory\n");
+    return FAILURE;
+  }
+
+  /* Unwrap along x through the center column, then along w */
+  loc = LOC(hnw, hnx, nw);
+  theta[loc] = atan2(my[loc], mx[loc]);
+  for (ix = hnx+1; ix < nx; ix++) UnwrapStep(theta, mx, my, LOC(hnw, ix, nw), LOC(hnw, ix-1, nw));
+  for (ix = hnx-1; ix >= 0; ix--) UnwrapStep(theta, mx, my, LOC(hnw, ix, nw), LOC(hnw, ix+1, nw));
+
+  for (ix = 0; ix < nx; ix++) {
+    for (iw = hnw+1; iw < nw; iw++) UnwrapStep(theta, mx, my, LOC(iw, ix, nw), LOC(iw-1, ix, nw));
+    for (iw = hnw-1; iw >= 0; iw--) UnwrapStep(theta, mx, my, LOC(iw, ix, nw), LOC(iw+1, ix, nw));
+  }
+
+  /* Weighted centroid */
+  sw = w0 = x0 = t0 = 0.0;
+  for (ix = 0; ix < nx; ix++) {
+    for (iw = 0; iw < nw; iw++) {
+      loc = LOC(iw, ix, nw);
+      wt = (double)mx[loc] * mx[loc] + (double)my[loc] * my[loc];
+      sw += wt;
+      w0 += wt * w[iw];
+      x0 += wt * x[ix];
+      t0 += wt * theta[loc];
+    }
+  }
+
+  if (sw <= 0.0) {
+    free(theta);
+    return FAILURE;
+  }
+
+  w0 /= sw; x0 /= sw; t0 /= sw;
+
+  /* Weighted centered moments */
+  for (ix = 0; ix < nx; ix++) {
+    for (iw = 0; iw < nw; iw++) {
+      loc = LOC(iw, ix, nw);
+      wt = (double)mx[loc] * mx[loc] + (double)my[loc] * my[loc];
+      dw = w[iw] - w0;
+      dx = x[ix] - x0;
+      dt = theta[loc] - t0;
+      sww += wt * dw * dw;
+      sxx += wt * dx * dx;
+      swx += wt * dw * dx;
+      swt += wt * dw * dt;
+      sxt += wt * dx * dt;
+    }
+  }
+
+  free(theta);
+
+  /* Phase plane theta = t0 + dtheta_dw (w - w0) + dtheta_dx (x - x0),
+     or the line theta = t0 + dtheta_dx (x - x0) for a single w */
+  if (fitw && sww <= 0.0) {
+    if (ssp->ssflag) return FAILURE;
+    fitw = 0;
+  }
+
+  if (fitw) {
+    det = sww * sxx - swx * swx;
+    if (det <= 0.0) return FAILURE;
+    dtheta_dw = (sxx * swt - swx * sxt) / det;
+    dtheta_dx = (sww * sxt - swx * swt) / det;
+  } else {
+    if (sxx <= 0.0) return FAILURE;
+    dtheta_dx = sxt / sxx;
+  }
+
+  if (ssp->ssflag) {
+    *tiso = fabs(dtheta_dw);
+    *tg = dtheta_dx / (GAMMA_1H * ssp->Gmax);
+  } else {
+    *tiso = fabs(dtheta_dx) / (GAMMA_1H * ssp->Gmax);
+  }
+
+  if (pulsename == NULL) return SUCCESS;
+
+  printf("IsoDelayFit: Isodelay       = %g us\n", *tiso * 1e6);
+  if (ssp->ssflag) printf("IsoDelayFit: Gradient delay = %g us\n", *tg * 1e6);
+
+  return WriteIso(pulsename, ssp, *tiso, *tg);
+}
+
+/************************************************************
+ * Unwrapped phase at loc from its unwrapped neighbor prev
+ ************************************************************/
+static void UnwrapStep(double *theta, float *mx, float *my, int loc, int prev)
+{
+  double re = (double)mx[loc] * mx[prev] + (double)my[loc] * my[prev];
+  double im = (double)my[loc] * mx[prev] - (double)mx[loc] * my[prev];
+
+  theta[loc] = theta[prev] + atan2(im, re);
+}
+
+/************************************************************
+ * Append isodelay and gradient delay to <pulsename>.ssb
+ ************************************************************/
+static int WriteIso(char *pulsename, SSPARS *ssp, float tiso, float tg)
+{
+  char ssbname[512];
+#ifdef SS_TEXT_EXPORT
+  FILE *fd;
+  char isoname[512];
+#endif
+
+  sprintf(ssbname, "%s.ssb", pulsename);
+  if (ssb_scalar(ssbname, "iso.IsodelayUS", tiso * 1e6) < 0 ||
+      (ssp->ssflag && ssb_scalar(ssbname, "iso.GradDelayUS", tg * 1e6) < 0)) {
+    fprintf(stderr, "IsoDelay: Could not write to %s\n", ssbname);
+    return FAILURE;
+  }
+
+#ifdef SS_TEXT_EXPORT
   /************************************************************
-   * Write isodelay and gradient delay to <pulsename>.iso
+   * Text export of isodelay and gradient delay to <pulsename>.iso
    ************************************************************/
   sprintf(isoname, "%s.iso", pulsename);
   if ((fd = fopen(isoname, "w")) == NULL) {
@@ -123,13 +296,14 @@ int IsoDelay(char *pulsename,
     return FAILURE;
   }
 
-  fprintf(fd, "IsodelayUS %g\n", *tiso * 1e6);
+  fprintf(fd, "IsodelayUS %g\n", tiso * 1e6);
 
   if (ssp->ssflag) {
-    fprintf(fd, "GradDelayUS %g\n", *tg * 1e6);
+    fprintf(fd, "GradDelayUS %g\n", tg * 1e6);
   }
 
   fclose(fd);
+#endif
 
   return SUCCESS;
 }
@@ -0,0 +1,164 @@
+/************************************************************
+ * Binary result container for spectral-spatial simulations
+ *
+ * A <pulsename>.ssb file holds any number of named numeric
+ * arrays, so one file replaces the .mxy, .rmsf, .rmsx, .par and
+ * .iso text files. Loading it needs no parsing and keeps full
+ * float precision. All fields are little endian; writers on big
+ * endian hosts byte swap, and the byte order mark lets readers
+ * reject a file that was written in the wrong order.
+ *
+ *   File header  (16 bytes) : "SSB1", uint32 byte order mark 1,
+ *                             uint64 reserved
+ *   Chunk header (64 bytes) : char name[32], uint32 type,
+ *                             uint32 ndims, uint32 dims[4],
+ *                             uint64 nbytes
+ *   Chunk data   (nbytes)   : column-major array, zero padded to
+ *                             a multiple of 8 bytes
+ *
+ * type is SSB_FLOAT32 or SSB_FLOAT64. Chunks are appended, so
+ * separate stages of a simulation can add their own results to
+ * the same file. Readers take the last chunk of a given name.
+ * Data are 8 byte aligned and contiguous, so readers can memory
+ * map each array directly (see ReadSSbin.m).
+ *
+ * AUTHOR : Mike Tyszka, Ph.D.
+ * PLACE  : Caltech BIC
+ * DATES  : 10/19/2026 JMT From scratch
+ *          10/19/2026 JMT Byte swap on big endian hosts
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Mike Tyszka
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ *   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ *   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ *   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ *   Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ *   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ *   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ************************************************************/
+
+#ifndef SSBIN_H
+#define SSBIN_H
+
+#include <stdio.h>
+#include <string.h>
+
+#define SSB_MAGIC     "SSB1"
+#define SSB_NAMELEN   32
+#define SSB_MAXDIMS   4
+#define SSB_FLOAT32   1
+#define SSB_FLOAT64   2
+
+typedef struct {
+  char name[SSB_NAMELEN];
+  unsigned int type;
+  unsigned int ndims;
+  unsigned int dims[SSB_MAXDIMS];
+  unsigned long long nbytes;
+} ssb_chunk;
+
+/************************************************************
+ * Write n items of the given size in little endian order
+ * Returns the number of items written
+ ************************************************************/
+static size_t ssb_fwrite_le(const void *data, size_t size, size_t n, FILE *fd)
+{
+  const unsigned int one = 1;
+  const unsigned char *p = (const unsigned char *)data;
+  unsigned char buf[4096];
+  size_t i, j, nbuf, done = 0;
+
+  /* Little endian host or single bytes : write as is */
+  if (*(const unsigned char *)&one == 1 || size == 1) return fwrite(data, size, n, fd);
+
+  /* Big endian host : reverse each item through a buffer */
+  while (done < n) {
+    nbuf = sizeof(buf) / size;
+    if (nbuf > n - done) nbuf = n - done;
+    for (i = 0; i < nbuf; i++)
+      for (j = 0; j < size; j++)
+	buf[i * size + j] = p[(done + i) * size + size - 1 - j];
+    if (fwrite(buf, size, nbuf, fd) != nbuf) break;
+    done += nbuf;
+  }
+
+  return done;
+}
+
+/************************************************************
+ * Append array data (ndims x dims) to an .ssb file, creating
+ * the file and its header if necessary
+ * Returns 0 on success, -1 on failure
+ ************************************************************/
+static int ssb_append(const char *fname, const char *name, unsigned int type,
+		      unsigned int ndims, const unsigned int *dims, const void *data)
+{
+  static const char pad[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+  unsigned int bom = 1;
+  unsigned long long reserved = 0, n, nraw;
+  ssb_chunk ch;
+  FILE *fd;
+  long pos;
+  unsigned int d;
+
+  if (ndims < 1 || ndims > SSB_MAXDIMS || (type != SSB_FLOAT32 && type != SSB_FLOAT64)) return -1;
+
+  memset(&ch, 0, sizeof(ch));
+  strncpy(ch.name, name, SSB_NAMELEN - 1);
+  ch.type = type;
+  ch.ndims = ndims;
+
+  n = 1;
+  for (d = 0; d < SSB_MAXDIMS; d++) {
+    ch.dims[d] = (d < ndims) ? dims[d] : 1;
+    n *= ch.dims[d];
+  }
+  nraw = n * ((type == SSB_FLOAT32) ? 4 : 8);
+  ch.nbytes = (nraw + 7) / 8 * 8;
+
+  if ((fd = fopen(fname, "ab")) == NULL) return -1;
+
+  /* New file : write the file header first */
+  fseek(fd, 0L, SEEK_END);
+  pos = ftell(fd);
+  if (pos == 0) {
+    fwrite(SSB_MAGIC, 1, 4, fd);
+    ssb_fwrite_le(&bom, sizeof(bom), 1, fd);
+    ssb_fwrite_le(&reserved, sizeof(reserved), 1, fd);
+  }
+
+  fwrite(ch.name, 1, SSB_NAMELEN, fd);
+  ssb_fwrite_le(&ch.type, sizeof(ch.type), 1, fd);
+  ssb_fwrite_le(&ch.ndims, sizeof(ch.ndims), 1, fd);
+  ssb_fwrite_le(ch.dims, sizeof(ch.dims[0]), SSB_MAXDIMS, fd);
+  ssb_fwrite_le(&ch.nbytes, sizeof(ch.nbytes), 1, fd);
+  if (nraw > 0) ssb_fwrite_le(data, (type == SSB_FLOAT32) ? 4 : 8, (size_t)n, fd);
+  fwrite(pad, 1, (size_t)(ch.nbytes - nraw), fd);
+
+  if (ferror(fd)) {
+    fclose(fd);
+    return -1;
+  }
+
+  return fclose(fd) == 0 ? 0 : -1;
+}
+
+/************************************************************
+ * Append a single float64 value, eg a pulse parameter
+ ************************************************************/
+static int ssb_scalar(const char *fname, const char *name, double value)
+{
+  unsigned int dims[2] = {1, 1};
+
+  return ssb_append(fname, name, SSB_FLOAT64, 2, dims, &value);
+}
+
+#endif /* SSBIN_H */
@@ -0,0 +1,74 @@
+function ExportSStext(dirname, name)
+% ExportSStext(dirname, name)
+%
+% Export a binary spectral-spatial result container <name>.ssb to
+% the original text files (<name>.mxy, .rmsf, .rmsx, .par and .iso)
+% for external tools. Only the arrays present in the container are
+% exported.
+%
+% ARGS :
+% dirname = pulse directory
+% name    = pulse name
+%
+% AUTHOR : Mike Tyszka, Ph.D.
+% PLACE  : Caltech BIC
+% DATES  : 10/19/2026 JMT From scratch
+%
+% The MIT License (MIT)
+%
+% Copyright (c) 2016 Mike Tyszka
+%
+%   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+%   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+%   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+%   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+%
+%   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+%   Software.
+%
+%   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+%   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+%   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+%   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+[B, info] = ReadSSbin(sprintf('%s/%s.ssb', dirname, name));
+
+% Column tables
+tables = {'mxy', 'rmsf', 'rmsx'};
+for k = 1:length(tables)
+  field = tables{k};
+  if isfield(B, field)
+    a = double(B.(field));
+    fd = open_text(dirname, name, field);
+    fprintf(fd, [repmat('%f ', 1, size(a,1)-1) '%f\n'], a);
+    fclose(fd);
+  end
+end
+
+% Name-value files in container order
+pairs = {'par', 'iso'};
+for k = 1:length(pairs)
+  field = pairs{k};
+  ch = find(strncmp({info.name}, [field '.'], length(field)+1));
+  if isempty(ch), continue; end
+  [~, keep] = unique({info(ch).name}, 'last');
+  ch = ch(sort(keep));
+  fd = open_text(dirname, name, field);
+  for c = ch
+    key = info(c).name(length(field)+2:end);
+    val = B.(field).(strrep(key, '%', 'perc'));
+    fprintf(fd, '%-12s %10g\n', strrep(key, 'perc', '%'), val);
+  end
+  fclose(fd);
+end
+
+%------------------------------------------------------------
+% Open <name>.<ext> for writing
+%------------------------------------------------------------
+function fd = open_text(dirname, name, ext)
+
+fname = sprintf('%s/%s.%s', dirname, name, ext);
+fd = fopen(fname, 'w');
+if fd < 0
+  error('ExportSStext : could not open %s to write', fname);
+end
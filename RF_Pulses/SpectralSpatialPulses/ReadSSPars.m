@@ -16,6 +16,11 @@ function [Tms, FOVfHz, Slicexmm] = ReadSSPars(dirname, name)
 % SmaxTms        77
 % GmaxGcm         2
 %
+% Parameters come from <name>.ssb when present (see ReadSSbin),
+% otherwise from the <name>.par text file above.
+%
+% DATES  : 10/19/2026 JMT Prefer the binary .ssb container
+%
 % The MIT License (MIT)
 %
 % Copyright (c) 2016 Mike Tyszka
@@ -33,6 +38,18 @@ function [Tms, FOVfHz, Slicexmm] = ReadSSPars(dirname, name)
 %   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
 %   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
+% Binary container when present
+ssbfile = sprintf('%s/%s.ssb', dirname, name);
+if exist(ssbfile, 'file')
+  B = ReadSSbin(ssbfile, {'par.'});
+  if isfield(B, 'par')
+    Tms      = B.par.Tms;
+    FOVfHz   = B.par.FOVfHz;
+    Slicexmm = B.par.Slicexmm;
+    return
+  end
+end
+
 % Read essential parameters
 parfile = sprintf('%s/%s.par', dirname, name);
 fd = fopen(parfile,'r');
@@ -0,0 +1,138 @@
+function [B, info] = ReadSSbin(ssbfile, names, lazy)
+% [B, info] = ReadSSbin(ssbfile, names, lazy)
+%
+% Load arrays from a binary spectral-spatial result container
+% (<pulsename>.ssb, format described in BlochSim/ssbin.h). Chunk
+% headers are scanned with fread, so nothing is parsed and only the
+% requested arrays are touched. By default each array is read into
+% a MATLAB array in its stored class. With lazy set, each array is
+% returned as a memmapfile object instead and no data are read until
+% the caller indexes m.Data, which then copies only the indexed
+% elements, eg mx = m.Data(1:7:end) for the first row of a 7 x n
+% table (dims are in info).
+%
+% ARGS :
+% ssbfile = .ssb filename
+% names   = cell array of chunk names to load, or prefixes ending in '.'
+%           (eg 'par.') [all chunks]
+% lazy    = return memmapfile objects rather than arrays [0]. Ignored
+%           where memmapfile is unavailable or the host is big endian
+%
+% RETURNS :
+% B    = structure of arrays (or memmapfile objects). Dotted chunk names
+%        become nested fields (eg 'par.Tms' -> B.par.Tms) and '%'
+%        becomes 'perc'
+% info = structure array of chunk headers (name, class, dims, offset)
+%        in file order
+%
+% AUTHOR : Mike Tyszka, Ph.D.
+% PLACE  : Caltech BIC
+% DATES  : 10/19/2026 JMT From scratch
+%          10/19/2026 JMT Lazy memmapfile access, byte order check
+%
+% The MIT License (MIT)
+%
+% Copyright (c) 2016 Mike Tyszka
+%
+%   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+%   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+%   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+%   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+%
+%   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+%   Software.
+%
+%   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+%   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+%   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+%   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+if nargin < 2 names = {}; end
+if nargin < 3 lazy = 0; end
+if ischar(names) names = {names}; end
+
+B = struct();
+
+fd = fopen(ssbfile, 'r', 'ieee-le');
+if fd < 0
+  error('ReadSSbin : could not open %s', ssbfile);
+end
+
+% File header
+magic = fread(fd, [1 4], '*char');
+bom = fread(fd, 1, 'uint32');
+fread(fd, 1, 'uint64');
+if ~strcmp(magic, 'SSB1') || bom ~= 1
+  fclose(fd);
+  if strcmp(magic, 'SSB1') && bom == 2^24
+    error('ReadSSbin : %s was written big endian', ssbfile);
+  end
+  error('ReadSSbin : %s is not an SSB1 file', ssbfile);
+end
+
+% Scan chunk headers
+info = struct('name', {}, 'class', {}, 'dims', {}, 'offset', {});
+classes = {'single', 'double'};
+while true
+  cname = fread(fd, [1 32], '*char');
+  if length(cname) < 32, break; end
+  type = fread(fd, 1, 'uint32');
+  nd = fread(fd, 1, 'uint32');
+  dims = fread(fd, [1 4], 'uint32');
+  nbytes = fread(fd, 1, 'uint64');
+  k = length(info) + 1;
+  info(k).name = cname(1:find([cname char(0)] == 0, 1) - 1);
+  info(k).class = classes{type};
+  info(k).dims = dims(1:max(nd,2));
+  info(k).offset = ftell(fd);
+  fseek(fd, nbytes, 'cof');
+end
+
+% Later chunks replace earlier chunks of the same name
+[~, last] = unique({info.name}, 'last');
+last = sort(last);
+
+% memmapfile uses host byte order and the file is little endian
+[~, ~, endian] = computer;
+use_map = exist('memmapfile', 'file') > 0 && endian == 'L';
+
+for c = last(:)'
+
+  ch = info(c);
+  if ~isempty(names) && ~wanted(ch.name, names)
+    continue
+  end
+
+  if prod(ch.dims) == 0
+    a = zeros(ch.dims, ch.class);
+  elseif use_map && lazy
+    a = memmapfile(ssbfile, 'Offset', ch.offset, 'Format', ch.class, 'Repeat', prod(ch.dims));
+  elseif use_map
+    m = memmapfile(ssbfile, 'Offset', ch.offset, 'Format', {ch.class, ch.dims, 'a'}, 'Repeat', 1);
+    a = m.Data.a;
+  else
+    fseek(fd, ch.offset, 'bof');
+    a = reshape(fread(fd, prod(ch.dims), ['*' ch.class]), ch.dims);
+  end
+
+  % Dotted names to nested fields
+  parts = regexp(strrep(ch.name, '%', 'perc'), '\.', 'split');
+  B = setfield(B, parts{:}, a);
+
+end
+
+fclose(fd);
+
+%------------------------------------------------------------
+% True if name matches one of names, or a prefix ending in '.'
+%------------------------------------------------------------
+function ok = wanted(name, names)
+
+ok = false;
+for k = 1:length(names)
+  p = names{k};
+  if strcmp(name, p) || (p(end) == '.' && strncmp(name, p, length(p)))
+    ok = true;
+    return
+  end
+end
@@ -1,30 +1,60 @@
-function [mx,my,mz] = ReadSSmxy(dirname, name, nf, nx)
-%
-% The MIT License (MIT)
-%
-% Copyright (c) 2016 Mike Tyszka
-%
-%   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
-%   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
-%   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
-%   permit persons to whom the Software is furnished to do so, subject to the following conditions:
-%
-%   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
-%   Software.
-%
-%   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
-%   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
-%   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
-%   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
-
-mxyfile = sprintf('%s/%s.mxy', dirname, name);
-
-% Read in Mxy data
-fd = fopen(mxyfile,'r');
-mxy = fscanf(fd, '%f', [7, Inf]);
-fclose(fd);
-
-% Extract magnetization components
-mx = reshape(mxy(1,:),nf,nx);
-my = reshape(mxy(2,:),nf,nx);
-mz = reshape(mxy(3,:),nf,nx);
+function [mx,my,mz] = ReadSSmxy(dirname, name, nf, nx)
+% [mx,my,mz] = ReadSSmxy(dirname, name, nf, nx)
+%
+% Read the simulated magnetization of a spectral-spatial pulse,
+% memory mapped from <name>.ssb when present (see ReadSSbin),
+% otherwise parsed from the <name>.mxy text file. Only the mx, my
+% and mz rows of the mapped table are read, in their stored class.
+%
+% DATES  : 10/19/2026 JMT Prefer the binary .ssb container
+%          10/19/2026 JMT Index the mapped table lazily
+%
+% The MIT License (MIT)
+%
+% Copyright (c) 2016 Mike Tyszka
+%
+%   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+%   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+%   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+%   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+%
+%   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+%   Software.
+%
+%   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+%   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+%   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+%   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ssbfile = sprintf('%s/%s.ssb', dirname, name);
+mxyfile = sprintf('%s/%s.mxy', dirname, name);
+
+B = struct();
+if exist(ssbfile, 'file')
+  [B, info] = ReadSSbin(ssbfile, {'mxy'}, 1);
+end
+
+if isfield(B, 'mxy') && isa(B.mxy, 'memmapfile')
+
+  % Strided reads of rows 1:3 of the mapped nrow x n table
+  nrow = info(find(strcmp({info.name}, 'mxy'), 1, 'last')).dims(1);
+  mx = reshape(B.mxy.Data(1:nrow:end),nf,nx);
+  my = reshape(B.mxy.Data(2:nrow:end),nf,nx);
+  mz = reshape(B.mxy.Data(3:nrow:end),nf,nx);
+  return
+
+end
+
+if isfield(B, 'mxy')
+  mxy = B.mxy;
+else
+  % Read in Mxy data
+  fd = fopen(mxyfile,'r');
+  mxy = fscanf(fd, '%f', [7, Inf]);
+  fclose(fd);
+end
+
+% Extract magnetization components
+mx = reshape(mxy(1,:),nf,nx);
+my = reshape(mxy(2,:),nf,nx);
+mz = reshape(mxy(3,:),nf,nx);
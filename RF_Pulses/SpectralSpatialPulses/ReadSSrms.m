@@ -1,4 +1,11 @@
 function [f, x, rmsf, rmsx] = ReadSSrms(dirname, name, nf, nx)
+% [f, x, rmsf, rmsx] = ReadSSrms(dirname, name, nf, nx)
+%
+% Read the spectrally and spatially integrated rms magnetization,
+% from <name>.ssb when present (see ReadSSbin), otherwise from the
+% <name>.rmsf and <name>.rmsx text files.
+%
+% DATES  : 10/19/2026 JMT Prefer the binary .ssb container
 %
 % The MIT License (MIT)
 %
@@ -17,6 +24,19 @@ function [f, x, rmsf, rmsx] = ReadSSrms(dirname, name, nf, nx)
 %   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
 %   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
+ssbfile = sprintf('%s/%s.ssb', dirname, name);
+
+if exist(ssbfile, 'file')
+  B = ReadSSbin(ssbfile, {'rmsf', 'rmsx'});
+  if isfield(B, 'rmsf') && isfield(B, 'rmsx')
+    f = double(B.rmsf(1,:));
+    rmsf = double(B.rmsf(2,:));
+    x = double(B.rmsx(1,:));
+    rmsx = double(B.rmsx(2,:));
+    return
+  end
+end
+
 rmsffile = sprintf('%s/%s.rmsf', dirname, name);
 
 % Read in Mxy data
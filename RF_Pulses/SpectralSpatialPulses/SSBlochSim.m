@@ -1,15 +1,22 @@
-function [x,w,mxy] = SSBlochSim(t,Gt,B1t)
-% mxy = SSBlochSim(t,Gt,B1t)
+function [x,w,mxy] = SSBlochSim(t,Gt,B1t,nx,nw,nthreads)
+% [x,w,mxy] = SSBlochSim(t,Gt,B1t,nx,nw,nthreads)
 % Bloch equation simulation of the gradient and RF waveform
 %
 % INPUT PARAMETERS:
 % t   : Time samples vector
 % Gt  : Gradient waveform vector
 % B1t : Complex RF waveform
+% nx, nw : Response grid size in x and w [32, 34]
+% nthreads : ssbloch_mex threads, 0 for all processors [0]
+%
+% The spinor response over the whole (x, w) grid is computed in one
+% threaded call to ssbloch_mex when compiled, so dense grids (eg 256 x 256)
+% are practical. The MATLAB loop below is the reference fallback.
 %
 % AUTHOR : Mike Tyszka, Ph.D.
 % PLACE  : City of Hope, Duarte CA
 % DATES  : 10/1/98   Convert to quaternion rotations
+%          10/19/2026 JMT Add grid size args and threaded ssbloch_mex engine
 %
 % The MIT License (MIT)
 %
@@ -28,14 +35,17 @@ function [x,w,mxy] = SSBlochSim(t,Gt,B1t)
 %   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
 %   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
+% Default args
+if nargin < 4 nx = 32; end
+if nargin < 5 nw = 34; end
+if nargin < 6 nthreads = 0; end
+
 fprintf('\nInitializing Bloch Simulation\n');
 
 % Temporary default parameters
 FOVx = 4.0e-2;      % m
 BWw = 2*pi * 2000.0; % rad/s
 
-nx = 32;
-nw = 34;
 nt = length(t);
 
 % Initialize complex transverse magnetization array
@@ -59,6 +69,13 @@ dt = t(2)-t(1);
 
 fprintf('Performing Bloch Simulation for %d points:\n',length(t)-1);
 
+% Native threaded engine over the full grid when compiled
+if exist('ssbloch_mex','file') == 3
+   mxy = ssbloch_mex(dt, GAMMA*Gt(:).', GAMMA*B1t(:).', x(:), w(:).', nthreads);
+   fprintf('done\n');
+   return
+end
+
 fprintf('Progress : ');
 previous = -10;
 
@@ -0,0 +1,119 @@
+function [B1t, J, mxy, output] = SSoptimize(t, Gt, B1t, x, w, D, W, opts)
+% [B1t, J, mxy, output] = SSoptimize(t, Gt, B1t, x, w, D, W, opts)
+%
+% Refine the RF waveform of a spectral-spatial pulse towards a target
+% (x, w) response by quasi-Newton minimization of the weighted
+% passband/stopband cost
+%
+%   magnitude : J = sum W (|mxy|^2 - |D|^2)^2
+%   complex   : J = sum W |mxy - D|^2
+%
+% The gradient with respect to every B1 sample comes from a single
+% forward and adjoint spinor sweep in ssgrad_mex, so each iteration
+% costs about two Bloch simulations regardless of the pulse length.
+% The gradient waveform is held fixed.
+%
+% Example target from the ideal response of SSresponse :
+%   D = sin(flip) * (SSresponse(x, w, BWx, BWw) > 0);
+%   W = 1 in the pass and stop bands, 0 in the transition bands
+%
+% ARGS :
+% t    = time samples (s), uniformly spaced
+% Gt   = gradient waveform (T/m)
+% B1t  = starting complex RF waveform (T), eg from SSpulse
+% x    = positions (m)
+% w    = off-resonance frequencies (rad/s)
+% D    = target mxy (nx x nw)
+% W    = cost weights (nx x nw) [ones]
+% opts = optional structure with fields
+%   mode     = 'magnitude' or 'complex' ['magnitude']
+%   maxiter  = maximum quasi-Newton iterations [100]
+%   nthreads = number of threads, 0 for all processors [0]
+%   display  = fminunc display level ['iter']
+%
+% RETURNS :
+% B1t    = optimized RF waveform (T), same shape as the input
+% J      = final cost
+% mxy    = final response over the (x, w) grid
+% output = fminunc output structure
+%
+% AUTHOR : Mike Tyszka, Ph.D.
+% PLACE  : Caltech BIC
+% DATES  : 10/19/2026 JMT From scratch
+% REFS   : Grissom WA et al. Magn Reson Med 2006; 56:620-629
+%
+% The MIT License (MIT)
+%
+% Copyright (c) 2016 Mike Tyszka
+%
+%   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+%   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+%   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+%   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+%
+%   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+%   Software.
+%
+%   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+%   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+%   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+%   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+% Default args
+if nargin < 7 W = []; end
+if nargin < 8 opts = struct(); end
+if ~isfield(opts, 'mode') opts.mode = 'magnitude'; end
+if ~isfield(opts, 'maxiter') opts.maxiter = 100; end
+if ~isfield(opts, 'nthreads') opts.nthreads = 0; end
+if ~isfield(opts, 'display') opts.display = 'iter'; end
+
+if exist('ssgrad_mex','file') ~= 3
+  error('SSoptimize : compile ssgrad_mex first (mex -I../../RelaxFit ssgrad_mex.c)');
+end
+
+% Gyromagnetic ratio in rad/s/T, as SSBlochSim
+GAMMA = 2 * pi * 42e6;
+
+dt = t(2) - t(1);
+nt = length(B1t);
+sz = size(B1t);
+
+% Engine arguments
+gG = GAMMA * Gt(:).';
+x = x(:);
+w = w(:)';
+D = complex(double(D));
+W = double(W);
+mode = double(strcmp(opts.mode, 'magnitude'));
+
+% Optimize real and imaginary parts scaled to order one
+B1s = max(abs(B1t(:)));
+if B1s == 0, B1s = 1e-6; end
+p0 = [real(B1t(:)); imag(B1t(:))] / B1s;
+
+fopts = optimset('fminunc');
+fopts = optimset(fopts, ...
+  'GradObj', 'on', ...
+  'LargeScale', 'off', ...
+  'HessUpdate', 'bfgs', ...
+  'MaxIter', opts.maxiter, ...
+  'Display', opts.display);
+
+[p, J, ~, output] = fminunc(@cost, p0, fopts);
+
+B1t = reshape(complex(p(1:nt), p(nt+1:end)) * B1s, sz);
+
+[J, ~, ~, mxy] = ssgrad_mex(dt, gG, GAMMA * B1t(:).', x, w, D, W, mode, opts.nthreads);
+
+%------------------------------------------------------------
+% Cost and adjoint gradient for scaled waveform p
+%------------------------------------------------------------
+function [J, g] = cost(p)
+
+  gB1 = GAMMA * B1s * complex(p(1:nt), p(nt+1:end)).';
+  [J, gr, gi] = ssgrad_mex(dt, gG, gB1, x, w, D, W, mode, opts.nthreads);
+  g = GAMMA * B1s * [gr(:); gi(:)];
+
+end
+
+end
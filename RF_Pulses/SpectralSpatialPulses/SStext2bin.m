@@ -0,0 +1,74 @@
+function ssbfile = SStext2bin(dirname, name)
+% ssbfile = SStext2bin(dirname, name)
+%
+% Convert the text results of a spectral-spatial pulse simulation
+% (<name>.mxy, .rmsf, .rmsx, .par and .iso) into a single binary
+% <name>.ssb container read by ReadSSmxy, ReadSSrms and ReadSSPars.
+% Missing text files are skipped. ExportSStext is the inverse.
+%
+% ARGS :
+% dirname = pulse directory
+% name    = pulse name
+%
+% RETURNS :
+% ssbfile = .ssb filename written
+%
+% AUTHOR : Mike Tyszka, Ph.D.
+% PLACE  : Caltech BIC
+% DATES  : 10/19/2026 JMT From scratch
+%
+% The MIT License (MIT)
+%
+% Copyright (c) 2016 Mike Tyszka
+%
+%   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+%   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+%   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+%   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+%
+%   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+%   Software.
+%
+%   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+%   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+%   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+%   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+B = struct();
+
+% Magnetization and rms arrays keep their text row layout
+B = read_cols(B, 'mxy', sprintf('%s/%s.mxy', dirname, name), 7);
+B = read_cols(B, 'rmsf', sprintf('%s/%s.rmsf', dirname, name), 2);
+B = read_cols(B, 'rmsx', sprintf('%s/%s.rmsx', dirname, name), 2);
+
+% Name-value pairs from the parameter and isodelay files
+B = read_pairs(B, 'par', sprintf('%s/%s.par', dirname, name));
+B = read_pairs(B, 'iso', sprintf('%s/%s.iso', dirname, name));
+
+ssbfile = sprintf('%s/%s.ssb', dirname, name);
+WriteSSbin(ssbfile, B);
+
+%------------------------------------------------------------
+% Read a whitespace separated float table with nrows rows
+%------------------------------------------------------------
+function B = read_cols(B, field, fname, nrows)
+
+fd = fopen(fname, 'r');
+if fd < 0, return; end
+B.(field) = single(fscanf(fd, '%f', [nrows, Inf]));
+fclose(fd);
+
+%------------------------------------------------------------
+% Read "Name value" lines into substructure B.(field)
+%------------------------------------------------------------
+function B = read_pairs(B, field, fname)
+
+fd = fopen(fname, 'r');
+if fd < 0, return; end
+C = textscan(fd, '%s %f');
+fclose(fd);
+
+for k = 1:length(C{1})
+  key = strrep(C{1}{k}, '%', 'perc');
+  B.(field).(key) = C{2}(k);
+end
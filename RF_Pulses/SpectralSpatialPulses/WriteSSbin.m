@@ -0,0 +1,97 @@
+function WriteSSbin(ssbfile, B, append)
+% WriteSSbin(ssbfile, B, append)
+%
+% Write the numeric fields of structure B as chunks of a binary
+% spectral-spatial result container (see BlochSim/ssbin.h). Nested
+% structures become dotted chunk names (B.par.Tms -> 'par.Tms').
+% Single arrays are stored as float32, all others as float64.
+%
+% ARGS :
+% ssbfile = .ssb filename
+% B       = structure of real numeric arrays (at most 4-D)
+% append  = append to an existing file rather than replace it [0]
+%
+% AUTHOR : Mike Tyszka, Ph.D.
+% PLACE  : Caltech BIC
+% DATES  : 10/19/2026 JMT From scratch
+%
+% The MIT License (MIT)
+%
+% Copyright (c) 2016 Mike Tyszka
+%
+%   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+%   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+%   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+%   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+%
+%   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+%   Software.
+%
+%   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+%   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+%   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+%   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+if nargin < 3 append = 0; end
+
+if append && exist(ssbfile, 'file')
+  fd = fopen(ssbfile, 'a', 'ieee-le');
+else
+  fd = fopen(ssbfile, 'w', 'ieee-le');
+  if fd >= 0
+    fwrite(fd, 'SSB1', 'char');
+    fwrite(fd, 1, 'uint32');
+    fwrite(fd, 0, 'uint64');
+  end
+end
+
+if fd < 0
+  error('WriteSSbin : could not open %s to write', ssbfile);
+end
+
+write_fields(fd, B, '');
+
+fclose(fd);
+
+%------------------------------------------------------------
+% Write each numeric field, recursing into substructures
+%------------------------------------------------------------
+function write_fields(fd, B, prefix)
+
+fn = fieldnames(B);
+
+for f = 1:length(fn)
+
+  a = B.(fn{f});
+  cname = [prefix fn{f}];
+
+  if isstruct(a)
+    write_fields(fd, a, [cname '.']);
+    continue
+  end
+
+  if ~isnumeric(a) && ~islogical(a) || ~isreal(a) || ndims(a) > 4 || length(cname) > 31
+    error('WriteSSbin : %s must be a real array of at most 4 dimensions', cname);
+  end
+
+  if isa(a, 'single')
+    type = 1; prec = 'float32'; nb = 4;
+  else
+    type = 2; prec = 'float64'; nb = 8;
+  end
+
+  dims = ones(1,4);
+  dims(1:ndims(a)) = size(a);
+  nraw = numel(a) * nb;
+  nbytes = ceil(nraw / 8) * 8;
+
+  name32 = zeros(1, 32);
+  name32(1:length(cname)) = double(cname);
+
+  fwrite(fd, name32, 'uint8');
+  fwrite(fd, [type ndims(a) dims], 'uint32');
+  fwrite(fd, nbytes, 'uint64');
+  fwrite(fd, a, prec);
+  fwrite(fd, zeros(1, nbytes - nraw), 'uint8');
+
+end
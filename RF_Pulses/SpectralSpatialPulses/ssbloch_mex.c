@@ -0,0 +1,194 @@
+/************************************************************
+ * C source for ssbloch_mex MEX object
+ *
+ * SYNTAX: [mxy, a, b] = ssbloch_mex(dt, gG, gB1, x, w)
+ *         [mxy, a, b] = ssbloch_mex(dt, gG, gB1, x, w, nthreads)
+ *
+ * Spinor (Cayley-Klein) response of a spectral-spatial RF pulse
+ * over a full (x, w) grid, the engine behind SSBlochSim. For each
+ * grid point the hard pulse rotations of all time samples are
+ * composed as
+ *
+ *   Q = Qn ... Q2 Q1,  Q = [a -b* ; b a*]
+ *
+ * and the transverse magnetization from equilibrium is 2 a* b.
+ * Grid points are distributed over POSIX threads and all threads
+ * share the same gradient and B1 waveforms.
+ *
+ * dt       = sample interval (s)
+ * gG       = gamma * gradient waveform (rad/s/m, 1 x nt)
+ * gB1      = gamma * complex B1 waveform (rad/s, 1 x nt)
+ * x        = positions (m, nx x 1)
+ * w        = off-resonance frequencies (rad/s, 1 x nw)
+ * nthreads = number of threads, 0 for all processors [0]
+ *
+ * mxy      = complex transverse magnetization (nx x nw)
+ * a, b     = total Cayley-Klein parameters (nx x nw)
+ *
+ * BUILD  : mex -I../../RelaxFit ssbloch_mex.c
+ *
+ * AUTHOR : Mike Tyszka, Ph.D.
+ * PLACE  : Caltech BIC
+ * DATES  : 10/19/2026 JMT Adapt from SSBlochSim.m
+ *          10/19/2026 JMT Share spinor rotations with ssgrad_mex
+ * REFS   : Pauly J et al. IEEE Trans Med Imaging 1991; 10:53-65
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Mike Tyszka
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ *   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ *   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ *   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ *   Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ *   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ *   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ************************************************************/
+
+#include <math.h>
+#include "mex.h"
+
+#include "voxthreads.h"
+#include "ssspinor.h"
+
+/* Input Arguments */
+
+#define	DT_IN       prhs[0]
+#define	GG_IN       prhs[1]
+#define	GB1_IN      prhs[2]
+#define	X_IN        prhs[3]
+#define	W_IN        prhs[4]
+#define	NTHREADS_IN prhs[5]
+
+/* Output Arguments */
+
+#define	MXY_OUT     plhs[0]
+#define	A_OUT       plhs[1]
+#define	B_OUT       plhs[2]
+
+typedef struct {
+  double dt;
+  const double *gG;
+  const double *gB1r;
+  const double *gB1i;
+  const double *x;
+  const double *w;
+  int nt;
+  int nx;
+  double *ar, *ai, *br, *bi;
+} ss_context;
+
+static void ss_spinor(const ss_context *, double, double, double *);
+static void ss_worker(void *, int, int, int);
+
+/************************************************************
+ * Entry point for MEX call
+ ************************************************************/
+void mexFunction(int nlhs, mxArray *plhs[],
+		 int nrhs, const mxArray *prhs[])
+{
+  ss_context ctx;
+  mxArray *A, *B;
+  double *mr, *mi;
+  int nw, npts, nthreads, v;
+
+  /* Check for proper number of arguments */
+
+  if (nrhs < 5 || nrhs > 6 || nlhs > 3) {
+    mexErrMsgTxt("SYNTAX: [mxy,a,b] = ssbloch_mex(dt,gG,gB1,x,w[,nthreads])");
+  }
+
+  if (!mxIsDouble(GG_IN) || !mxIsDouble(GB1_IN) || !mxIsDouble(X_IN) || !mxIsDouble(W_IN) ||
+      mxIsComplex(GG_IN) || mxIsComplex(X_IN) || mxIsComplex(W_IN))
+    mexErrMsgTxt("ssbloch_mex : gG, x and w must be real double, gB1 double");
+
+  ctx.nt = (int)mxGetNumberOfElements(GG_IN);
+  ctx.nx = (int)mxGetNumberOfElements(X_IN);
+  nw = (int)mxGetNumberOfElements(W_IN);
+
+  if ((int)mxGetNumberOfElements(GB1_IN) != ctx.nt)
+    mexErrMsgTxt("ssbloch_mex : gG and gB1 must have the same length");
+
+  ctx.dt = mxGetScalar(DT_IN);
+  ctx.gG = mxGetPr(GG_IN);
+  ctx.gB1r = mxGetPr(GB1_IN);
+  ctx.gB1i = mxGetPi(GB1_IN);  /* NULL for a real waveform */
+  ctx.x = mxGetPr(X_IN);
+  ctx.w = mxGetPr(W_IN);
+
+  /* Cayley-Klein parameters are always computed */
+  A = mxCreateDoubleMatrix(ctx.nx, nw, mxCOMPLEX);
+  B = mxCreateDoubleMatrix(ctx.nx, nw, mxCOMPLEX);
+  ctx.ar = mxGetPr(A); ctx.ai = mxGetPi(A);
+  ctx.br = mxGetPr(B); ctx.bi = mxGetPi(B);
+
+  npts = ctx.nx * nw;
+
+  if (npts > 0) {
+    nthreads = vox_nthreads((nrhs > 5) ? (int)mxGetScalar(NTHREADS_IN) : 0);
+    if (nthreads > (npts + VOX_MINCHUNK - 1) / VOX_MINCHUNK)
+      nthreads = (npts + VOX_MINCHUNK - 1) / VOX_MINCHUNK;
+    vox_parallel(npts, nthreads, ss_worker, &ctx);
+  }
+
+  /* Transverse magnetization from equilibrium, mxy = 2 a* b */
+  MXY_OUT = mxCreateDoubleMatrix(ctx.nx, nw, mxCOMPLEX);
+  mr = mxGetPr(MXY_OUT);
+  mi = mxGetPi(MXY_OUT);
+  for (v = 0; v < npts; v++) {
+    mr[v] = 2.0 * (ctx.ar[v] * ctx.br[v] + ctx.ai[v] * ctx.bi[v]);
+    mi[v] = 2.0 * (ctx.ar[v] * ctx.bi[v] - ctx.ai[v] * ctx.br[v]);
+  }
+
+  if (nlhs > 1) A_OUT = A; else mxDestroyArray(A);
+  if (nlhs > 2) B_OUT = B; else mxDestroyArray(B);
+
+  return;
+}
+
+/************************************************************
+ * Compose the rotations of all time samples for one grid
+ * point at position x0 and off-resonance w0
+ * q returns [Re(a) Im(a) Re(b) Im(b)]
+ ************************************************************/
+static void ss_spinor(const ss_context *ctx, double x0, double w0, double *q)
+{
+  double R[4], wi;
+  int t;
+
+  q[0] = 1.0; q[1] = 0.0; q[2] = 0.0; q[3] = 0.0;
+
+  for (t = 0; t < ctx->nt; t++) {
+
+    /* Effective field: B1 in the transverse plane, gradient and chemical shift on z */
+    wi = (ctx->gB1i != NULL) ? ctx->gB1i[t] : 0.0;
+    ss_rotation(ctx->gB1r[t], wi, ctx->gG[t] * x0 + w0, 0.5 * ctx->dt, R);
+    ss_apply(R, q);
+  }
+}
+
+/************************************************************
+ * Simulate grid points [v0, v1) on thread tid
+ ************************************************************/
+static void ss_worker(void *arg, int v0, int v1, int tid)
+{
+  ss_context *ctx = (ss_context *)arg;
+  double q[4];
+  int v;
+
+  (void)tid;
+
+  for (v = v0; v < v1; v++) {
+    ss_spinor(ctx, ctx->x[v % ctx->nx], ctx->w[v / ctx->nx], q);
+    ctx->ar[v] = q[0];
+    ctx->ai[v] = q[1];
+    ctx->br[v] = q[2];
+    ctx->bi[v] = q[3];
+  }
+}
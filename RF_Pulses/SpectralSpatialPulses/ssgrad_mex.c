@@ -0,0 +1,275 @@
+/************************************************************
+ * C source for ssgrad_mex MEX object
+ *
+ * SYNTAX: [J, gr, gi, mxy] = ssgrad_mex(dt, gG, gB1, x, w, D, W)
+ *         [J, gr, gi, mxy] = ssgrad_mex(dt, gG, gB1, x, w, D, W, mode, nthreads)
+ *
+ * Weighted profile cost of a spectral-spatial pulse over an
+ * (x, w) grid and its exact gradient with respect to every B1
+ * sample, from one forward and one backward (adjoint) spinor
+ * sweep per grid point. With mxy = 2 a* b from ssbloch_mex,
+ *
+ *   mode 0 : J = sum W |mxy - D|^2            (complex target)
+ *   mode 1 : J = sum W (|mxy|^2 - |D|^2)^2    (magnitude target)
+ *
+ * The forward sweep stores the spinor after each sample. The
+ * adjoint spinor starts from dJ/dconj([a ; b]) and is propagated
+ * back through Q^H, picking up the derivative of each sample's
+ * rotation on the way. Grid points with zero weight are only
+ * simulated forward. Grid points are distributed over POSIX
+ * threads, each accumulating its own gradient.
+ *
+ * dt       = sample interval (s)
+ * gG       = gamma * gradient waveform (rad/s/m, 1 x nt)
+ * gB1      = gamma * complex B1 waveform (rad/s, 1 x nt)
+ * x        = positions (m, nx x 1)
+ * w        = off-resonance frequencies (rad/s, 1 x nw)
+ * D        = target mxy (nx x nw, real or complex)
+ * W        = non-negative weights (nx x nw) or [] for all ones
+ * mode     = 0 complex or 1 magnitude cost [1]
+ * nthreads = number of threads, 0 for all processors [0]
+ *
+ * J        = cost
+ * gr, gi   = dJ/dRe(gB1) and dJ/dIm(gB1) (1 x nt)
+ * mxy      = complex transverse magnetization (nx x nw)
+ *
+ * BUILD  : mex -I../../RelaxFit ssgrad_mex.c
+ *
+ * AUTHOR : Mike Tyszka, Ph.D.
+ * PLACE  : Caltech BIC
+ * DATES  : 10/19/2026 JMT From scratch
+ * REFS   : Pauly J et al. IEEE Trans Med Imaging 1991; 10:53-65
+ *          Grissom WA et al. Magn Reson Med 2006; 56:620-629
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Mike Tyszka
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ *   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ *   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ *   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ *   Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ *   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ *   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "mex.h"
+
+#include "voxthreads.h"
+#include "ssspinor.h"
+
+/* Input Arguments */
+
+#define	DT_IN       prhs[0]
+#define	GG_IN       prhs[1]
+#define	GB1_IN      prhs[2]
+#define	X_IN        prhs[3]
+#define	W_IN        prhs[4]
+#define	D_IN        prhs[5]
+#define	WT_IN       prhs[6]
+#define	MODE_IN     prhs[7]
+#define	NTHREADS_IN prhs[8]
+
+/* Output Arguments */
+
+#define	J_OUT       plhs[0]
+#define	GR_OUT      plhs[1]
+#define	GI_OUT      plhs[2]
+#define	MXY_OUT     plhs[3]
+
+typedef struct {
+  double h;
+  const double *gG;
+  const double *gB1r;
+  const double *gB1i;
+  const double *x;
+  const double *w;
+  const double *Dr;
+  const double *Di;
+  const double *Wt;
+  int mode;
+  int nt;
+  int nx;
+  double *mr, *mi;
+  double J[VOX_MAXTHREADS];
+  double *work[VOX_MAXTHREADS];
+} sg_context;
+
+static void sg_worker(void *, int, int, int);
+
+/************************************************************
+ * Entry point for MEX call
+ ************************************************************/
+void mexFunction(int nlhs, mxArray *plhs[],
+		 int nrhs, const mxArray *prhs[])
+{
+  sg_context ctx;
+  double *gr, *gi, *g;
+  int nw, npts, nthreads, n, t, ok;
+
+  /* Check for proper number of arguments */
+
+  if (nrhs < 7 || nrhs > 9 || nlhs > 4) {
+    mexErrMsgTxt("SYNTAX: [J,gr,gi,mxy] = ssgrad_mex(dt,gG,gB1,x,w,D,W[,mode,nthreads])");
+  }
+
+  if (!mxIsDouble(GG_IN) || !mxIsDouble(GB1_IN) || !mxIsDouble(X_IN) || !mxIsDouble(W_IN) ||
+      !mxIsDouble(D_IN) || !mxIsDouble(WT_IN) ||
+      mxIsComplex(GG_IN) || mxIsComplex(X_IN) || mxIsComplex(W_IN) || mxIsComplex(WT_IN))
+    mexErrMsgTxt("ssgrad_mex : gG, x, w and W must be real double, gB1 and D double");
+
+  ctx.nt = (int)mxGetNumberOfElements(GG_IN);
+  ctx.nx = (int)mxGetNumberOfElements(X_IN);
+  nw = (int)mxGetNumberOfElements(W_IN);
+  npts = ctx.nx * nw;
+
+  if ((int)mxGetNumberOfElements(GB1_IN) != ctx.nt)
+    mexErrMsgTxt("ssgrad_mex : gG and gB1 must have the same length");
+
+  if ((int)mxGetNumberOfElements(D_IN) != npts ||
+      (!mxIsEmpty(WT_IN) && (int)mxGetNumberOfElements(WT_IN) != npts))
+    mexErrMsgTxt("ssgrad_mex : D and W must be nx x nw");
+
+  ctx.h = 0.5 * mxGetScalar(DT_IN);
+  ctx.gG = mxGetPr(GG_IN);
+  ctx.gB1r = mxGetPr(GB1_IN);
+  ctx.gB1i = mxGetPi(GB1_IN);
+  ctx.x = mxGetPr(X_IN);
+  ctx.w = mxGetPr(W_IN);
+  ctx.Dr = mxGetPr(D_IN);
+  ctx.Di = mxGetPi(D_IN);
+  ctx.Wt = mxIsEmpty(WT_IN) ? NULL : mxGetPr(WT_IN);
+  ctx.mode = (nrhs > 7) ? (int)mxGetScalar(MODE_IN) : 1;
+
+  J_OUT = mxCreateDoubleMatrix(1, 1, mxREAL);
+  GR_OUT = mxCreateDoubleMatrix(1, ctx.nt, mxREAL);
+  GI_OUT = mxCreateDoubleMatrix(1, ctx.nt, mxREAL);
+  MXY_OUT = mxCreateDoubleMatrix(ctx.nx, nw, mxCOMPLEX);
+  gr = mxGetPr(GR_OUT);
+  gi = mxGetPr(GI_OUT);
+  ctx.mr = mxGetPr(MXY_OUT);
+  ctx.mi = mxGetPi(MXY_OUT);
+
+  if (npts < 1 || ctx.nt < 1) return;
+
+  nthreads = vox_nthreads((nrhs > 8) ? (int)mxGetScalar(NTHREADS_IN) : 0);
+  if (nthreads > (npts + VOX_MINCHUNK - 1) / VOX_MINCHUNK)
+    nthreads = (npts + VOX_MINCHUNK - 1) / VOX_MINCHUNK;
+
+  /* Per-thread workspace: spinor history and gradient accumulators */
+  ok = 1;
+  for (n = 0; n < nthreads; n++) {
+    ctx.work[n] = (double *)calloc((size_t)6 * ctx.nt + 4, sizeof(double));
+    if (ctx.work[n] == NULL) ok = 0;
+    ctx.J[n] = 0.0;
+  }
+
+  if (ok) vox_parallel(npts, nthreads, sg_worker, &ctx);
+
+  /* Reduce thread results in a fixed order */
+  if (ok) {
+    for (n = 0; n < nthreads; n++) {
+      g = ctx.work[n] + 4 * (ctx.nt + 1);
+      mxGetPr(J_OUT)[0] += ctx.J[n];
+      for (t = 0; t < ctx.nt; t++) {
+	gr[t] += g[2*t];
+	gi[t] += g[2*t+1];
+      }
+    }
+  }
+
+  for (n = 0; n < nthreads; n++) free(ctx.work[n]);
+
+  if (!ok) mexErrMsgTxt("ssgrad_mex : out of memory");
+
+  if (nlhs < 4) mxDestroyArray(MXY_OUT);
+
+  return;
+}
+
+/************************************************************
+ * Cost and gradient for grid points [v0, v1) on thread tid
+ ************************************************************/
+static void sg_worker(void *arg, int v0, int v1, int tid)
+{
+  sg_context *ctx = (sg_context *)arg;
+  int nt = ctx->nt, v, t;
+  double *s = ctx->work[tid];           /* spinors s[0..nt], 4 each */
+  double *g = s + 4 * (nt + 1);         /* [dJ/dwr dJ/dwi] per sample */
+  double R[4], dRr[4], dRi[4], u[4], l[4];
+  double x0, w0, wr, wi, wz, Wv, mr, mi, dr, di, er, ei, r, c;
+
+  for (v = v0; v < v1; v++) {
+
+    x0 = ctx->x[v % ctx->nx];
+    w0 = ctx->w[v / ctx->nx];
+
+    /* Forward sweep keeping the spinor after every sample */
+    s[0] = 1.0; s[1] = 0.0; s[2] = 0.0; s[3] = 0.0;
+    for (t = 0; t < nt; t++) {
+      wi = (ctx->gB1i != NULL) ? ctx->gB1i[t] : 0.0;
+      ss_rotation(ctx->gB1r[t], wi, ctx->gG[t] * x0 + w0, ctx->h, R);
+      memcpy(s + 4 * (t + 1), s + 4 * t, 4 * sizeof(double));
+      ss_apply(R, s + 4 * (t + 1));
+    }
+
+    /* mxy = 2 a* b */
+    u[0] = s[4*nt]; u[1] = s[4*nt+1]; u[2] = s[4*nt+2]; u[3] = s[4*nt+3];
+    mr = 2.0 * (u[0] * u[2] + u[1] * u[3]);
+    mi = 2.0 * (u[0] * u[3] - u[1] * u[2]);
+    ctx->mr[v] = mr;
+    ctx->mi[v] = mi;
+
+    Wv = (ctx->Wt != NULL) ? ctx->Wt[v] : 1.0;
+    if (Wv == 0.0) continue;
+
+    /* Cost and e such that dJ = 2 W Re(e* dmxy) */
+    dr = ctx->Dr[v];
+    di = (ctx->Di != NULL) ? ctx->Di[v] : 0.0;
+    if (ctx->mode == 0) {
+      er = mr - dr;
+      ei = mi - di;
+      ctx->J[tid] += Wv * (er * er + ei * ei);
+    } else {
+      r = mr * mr + mi * mi - dr * dr - di * di;
+      ctx->J[tid] += Wv * r * r;
+      er = 2.0 * r * mr;
+      ei = 2.0 * r * mi;
+    }
+
+    /* Adjoint spinor [la ; lb] = 2 W [e* b ; e a] */
+    c = 2.0 * Wv;
+    l[0] = c * (er * u[2] + ei * u[3]);
+    l[1] = c * (er * u[3] - ei * u[2]);
+    l[2] = c * (er * u[0] - ei * u[1]);
+    l[3] = c * (er * u[1] + ei * u[0]);
+
+    /* Backward sweep, dJ/dwk = 2 Re(l' dQk s[k-1]) */
+    for (t = nt - 1; t >= 0; t--) {
+      wr = ctx->gB1r[t];
+      wi = (ctx->gB1i != NULL) ? ctx->gB1i[t] : 0.0;
+      wz = ctx->gG[t] * x0 + w0;
+
+      ss_rotation_grad(wr, wi, wz, ctx->h, dRr, dRi);
+
+      memcpy(u, s + 4 * t, 4 * sizeof(double));
+      ss_apply(dRr, u);
+      g[2*t] += 2.0 * (l[0] * u[0] + l[1] * u[1] + l[2] * u[2] + l[3] * u[3]);
+
+      memcpy(u, s + 4 * t, 4 * sizeof(double));
+      ss_apply(dRi, u);
+      g[2*t+1] += 2.0 * (l[0] * u[0] + l[1] * u[1] + l[2] * u[2] + l[3] * u[3]);
+
+      ss_rotation(wr, wi, wz, ctx->h, R);
+      ss_apply_adj(R, l);
+    }
+  }
+}
@@ -0,0 +1,125 @@
+/************************************************************
+ * Hard pulse spinor rotations for spectral-spatial simulation
+ *
+ * Each time sample rotates the spinor [a ; b] by
+ *
+ *   Q = [aj -bj* ; bj aj*]
+ *   aj = cos(phi) - i nz sin(phi)
+ *   bj = -i (nx + i ny) sin(phi)
+ *
+ * about the effective field w = (wr, wi, wz) in rad/s, with half
+ * angle phi = -|w| dt / 2. Rotations are stored as
+ * R = [Re(aj) Im(aj) Re(bj) Im(bj)] and spinors as
+ * s = [Re(a) Im(a) Re(b) Im(b)]. The derivatives of R with respect
+ * to the B1 components wr and wi are used for adjoint gradients.
+ *
+ * AUTHOR : Mike Tyszka, Ph.D.
+ * PLACE  : Caltech BIC
+ * DATES  : 10/19/2026 JMT Split from ssbloch_mex.c
+ * REFS   : Pauly J et al. IEEE Trans Med Imaging 1991; 10:53-65
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Mike Tyszka
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ *   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ *   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ *   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ *   Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ *   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ *   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ************************************************************/
+
+#ifndef SSSPINOR_H
+#define SSSPINOR_H
+
+#include <math.h>
+
+/************************************************************
+ * sin(phi)/|w| and its scaled radial derivative
+ * S = -sin(h r) / r, T = (dS/dr) / r with h = dt/2
+ ************************************************************/
+static inline void ss_sinc(double r, double h, double *S, double *T)
+{
+  double hr = h * r, hr2 = hr * hr;
+
+  if (hr < 1e-3) {
+    *S = -h * (1.0 - hr2 / 6.0);
+    *T = h * h * h / 3.0 * (1.0 - hr2 / 10.0);
+  } else {
+    *S = -sin(hr) / r;
+    *T = (sin(hr) - hr * cos(hr)) / (r * r * r);
+  }
+}
+
+/************************************************************
+ * Rotation R for effective field (wr, wi, wz), h = dt/2
+ ************************************************************/
+static inline void ss_rotation(double wr, double wi, double wz, double h, double *R)
+{
+  double r = sqrt(wr * wr + wi * wi + wz * wz), S, T;
+
+  ss_sinc(r, h, &S, &T);
+
+  R[0] = cos(h * r);
+  R[1] = -wz * S;
+  R[2] = wi * S;
+  R[3] = -wr * S;
+}
+
+/************************************************************
+ * Derivatives of R with respect to wr (dRr) and wi (dRi)
+ ************************************************************/
+static inline void ss_rotation_grad(double wr, double wi, double wz, double h, double *dRr, double *dRi)
+{
+  double r = sqrt(wr * wr + wi * wi + wz * wz), S, T;
+
+  ss_sinc(r, h, &S, &T);
+
+  /* d cos(h r) / dw = h w S, dS / dw = T w */
+  dRr[0] = h * wr * S;
+  dRr[1] = -wz * T * wr;
+  dRr[2] = wi * T * wr;
+  dRr[3] = -wr * T * wr - S;
+
+  dRi[0] = h * wi * S;
+  dRi[1] = -wz * T * wi;
+  dRi[2] = wi * T * wi + S;
+  dRi[3] = -wr * T * wi;
+}
+
+/************************************************************
+ * Apply Q(R) to spinor s in place
+ ************************************************************/
+static inline void ss_apply(const double *R, double *s)
+{
+  double ar = s[0], ai = s[1], br = s[2], bi = s[3];
+
+  /* [a ; b] <- [aj a - bj* b ; bj a + aj* b] */
+  s[0] = R[0] * ar - R[1] * ai - (R[2] * br + R[3] * bi);
+  s[1] = R[0] * ai + R[1] * ar - (R[2] * bi - R[3] * br);
+  s[2] = R[2] * ar - R[3] * ai + (R[0] * br + R[1] * bi);
+  s[3] = R[2] * ai + R[3] * ar + (R[0] * bi - R[1] * br);
+}
+
+/************************************************************
+ * Apply Q(R)^H to adjoint spinor l in place
+ ************************************************************/
+static inline void ss_apply_adj(const double *R, double *l)
+{
+  double ar = l[0], ai = l[1], br = l[2], bi = l[3];
+
+  /* [a ; b] <- [aj* a + bj* b ; -bj a + aj b] */
+  l[0] = R[0] * ar + R[1] * ai + (R[2] * br + R[3] * bi);
+  l[1] = R[0] * ai - R[1] * ar + (R[2] * bi - R[3] * br);
+  l[2] = -(R[2] * ar - R[3] * ai) + (R[0] * br - R[1] * bi);
+  l[3] = -(R[2] * ai + R[3] * ar) + (R[0] * bi + R[1] * br);
+}
+
+#endif /* SSSPINOR_H */
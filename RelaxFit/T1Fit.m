@@ -1,12 +1,17 @@
-function [x, Mfit] = T1Fit(M, TI, ncomps, mag)
+function [x, Mfit] = T1Fit(M, TI, ncomps, mag, method)
 % T1 inversion recovery fit for one voxel
 %
-% [T1, M0] = T1Fit(M, TI, comps, Mag)
+% [x, Mfit] = T1Fit(M, TI, comps, Mag, method)
 %
 % M  : contains N magnitude signal samples
 % TI : contains the N TIs corresponding to S
 % ncomps : number of T1 components to fit
 % mag : real data (=0) magnitude data (=1)
+% method : 'leastsq' or 'varpro' ['leastsq']
+%          varpro solves the M0i in closed form and searches only the T1i,
+%          with polarity restoration about the smallest sample for mag = 1
+%
+% x = [M0_1 T1_1 M0_2 T1_2 ...]'
 %
 % Mz(t) = sum_i(M0i(1-E1i) + Mzi(0)E1i)
 %
@@ -27,14 +32,21 @@ function [x, Mfit] = T1Fit(M, TI, ncomps, mag)
 %   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
 %   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
+if nargin < 5 method = 'leastsq'; end
+
+if strcmp(method, 'varpro')
+  [x, Mfit] = T1Fit_varpro(M, TI, ncomps, mag);
+  return
+end
+
 [nx,nTI] = size(M);
 
-% Initial guesses
-M0guess = M(nTI);
-T1guess = mean(TI);
+% Initial guesses from the null point (mag) or three point solution,
+% shared between components with T1s spread about the estimate
+[M0guess, T1guess] = T1Fit_init(M, TI, ncomps, mag);
 
 % Initial guess array
-x0 = (ones(ncomps,1) * [M0guess T1guess])';
+x0 = [M0guess T1guess]';
 x0 = x0(:); % Flatten
 
 % Iteration options
@@ -46,3 +58,73 @@ options(14) = 500*length(x0);
 [x,options,lambda,hess] = leastsq('T1residual',x0,options,[],TI,M,mag,ncomps);
 Mfit = T1func(x,TI,mag,ncomps);
 
+%------------------------------------------------------------
+% Variable projection fit : M0i solved by least squares for
+% each trial set of log T1i, which fminsearch minimises
+%------------------------------------------------------------
+function [x, Mfit] = T1Fit_varpro(M, TI, ncomps, mag)
+
+y = M(:);
+t = TI(:);
+
+% Candidate polarities about the smallest magnitude sample
+if mag == 1
+  y = abs(y);
+  [ymin, imin] = min(y);
+  before = t < t(imin);
+  Y = [y y];
+  Y(before,:) = -Y(before,:);
+  Y(imin,2) = -Y(imin,2);
+else
+  Y = y;
+end
+
+% Starting log T1 spread about the closed form estimate
+[M0guess, T1guess] = T1Fit_init(M, TI, ncomps, mag);
+u0 = log(T1guess);
+
+options = optimset('fminsearch');
+options = optimset(options, 'Display', 'off', 'TolX', 1e-6, 'TolFun', 1e-10);
+
+ss_best = Inf;
+for p = 1:size(Y,2)
+  [u, ss] = fminsearch(@(u) T1projres(u, t, Y(:,p)), u0, options);
+  if ss < ss_best
+    ss_best = ss;
+    u_best = u;
+    y_best = Y(:,p);
+  end
+end
+
+[ss, M0] = T1projres(u_best, t, y_best);
+
+x = [M0(:)'; exp(u_best(:))'];
+x = x(:);
+Mfit = T1func(x, TI, mag, ncomps);
+
+%------------------------------------------------------------
+% Projected residual for log T1 vector u
+%------------------------------------------------------------
+function [ss, M0] = T1projres(u, t, y)
+
+B = 1 - 2 * exp(-t * (1 ./ exp(u(:)')));
+M0 = B \ y;
+ss = sum((y - B * M0).^2);
+
+%------------------------------------------------------------
+% Closed form starting estimates for ncomps components
+%------------------------------------------------------------
+function [M0guess, T1guess] = T1Fit_init(M, TI, ncomps, mag)
+
+if mag == 1
+  P0 = relaxinit('absir', TI, M(:)', [0 -1 0], [Inf 1 Inf]);
+else
+  P0 = relaxinit('ir', TI, M(:)', [-Inf -1 0], [Inf 1 Inf]);
+end
+
+if ncomps == 1
+  T1guess = P0(3);
+else
+  T1guess = P0(3) * logspace(-0.5, 0.5, ncomps)';
+end
+M0guess = P0(1) / ncomps * ones(ncomps,1);
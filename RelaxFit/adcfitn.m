@@ -1,5 +1,5 @@
-function [ADC, S0, Mask] = adcfitn(b, S, verbose)
-% [ADC, S0, Mask] = t2fitn(TE, S, verbose)
+function [ADC, S0, Mask] = adcfitn(b, S, verbose, mask)
+% [ADC, S0, Mask] = adcfitn(b, S, verbose, mask)
 %
 % Fit the ADC contrast equation in log-linear space:
 %
@@ -10,14 +10,19 @@ function [ADC, S0, Mask] = adcfitn(b, S, verbose)
 % ARGS:
 % b = b-factor vector in s/mm^2
 % S = N-D matrix with echo time as final dimension
+% mask = fit mask replacing the relative threshold, eg a global mask
+%        from streamfitn [10% of the maximum of the mean over b]
 %
 % RETURNS:
-% S0  = S(b=0) matrix
+% S0  = log(S(b=0)) matrix, the intercept of the log-linear fit
 % ADC = ADC matrix in mm^2/s
 %
 % AUTHOR : Mike Tyszka, Ph.D.
 % PLACE  : Caltech BIC
 % DATES  : 04/06/2004 JMT Adapt from t2fitn.m (JMT)
+%          10/19/2026 JMT Mask before log, regress without transposed copies
+%          10/19/2026 JMT Keep the log intercept for S0 as before
+%          10/19/2026 JMT Optional fit mask
 %
 % The MIT License (MIT)
 %
@@ -38,6 +43,7 @@ function [ADC, S0, Mask] = adcfitn(b, S, verbose)
 
 % Default args
 if nargin < 3 verbose = 0; end
+if nargin < 4 mask = []; end
 
 % Get dimensions
 dims = size(S);
@@ -59,25 +65,34 @@ else
   nb = nb1;
 end
 
-% Force b to be a column vector
-b = b(:);
-
-% Reshape and take log of S(b)
-S  = reshape(S, [nvox nb])';
-logS = log(S);
+% Check that a supplied mask matches the voxel count
+if numel(mask) > 0 && numel(mask) ~= nvox
+  fprintf('Mask does not match the spatial dimensions of the data\n');
+  return
+end
 
-% Calculate regression coefficients
-[S0,ADC,r] = lrn(b,logS);
+% Centered b as a column vector
+b = b(:);
+bm = mean(b);
+bc = b - bm;
 
-ADC = -ADC;
+% Reshape without copying and make space for results
+S = reshape(S, [nvox nb]);
+S0 = zeros(nvox,1);
+ADC = zeros(nvox,1);
 
-% Create a 10% mask from the mean image over b
-mS = mean(S,1);
-Mask = mS > max(mS(:)) * 0.1;
+% Create a 10% mask from the mean image over b unless one was supplied
+if isempty(mask)
+  mS = mean(S,2);
+  Mask = mS > max(mS(:)) * 0.1;
+else
+  Mask = logical(mask(:));
+end
 
-% Apply mask
-S0 = S0 .* Mask;
-ADC = ADC .* Mask;
+% Log-linear regression over mask voxels only, in place
+S = log(double(S(Mask,:)));
+ADC(Mask) = -(S * bc) / sum(bc.^2);
+S0(Mask) = mean(S,2) + ADC(Mask) * bm;
 
 % Reshape maps back to Ndims-1
 vdims = dims(1:(ndims-1));
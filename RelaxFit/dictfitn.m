@@ -0,0 +1,359 @@
+function [T1, M0, T2, B1, score] = dictfitn(model, seq, S, opts)
+% [T1, M0, T2, B1, score] = dictfitn(model, seq, S, opts)
+%
+% Dictionary matching relaxometry. The signal model is fixed by the
+% sequence timings, so signal curves are precomputed over a T1 (and,
+% for SPGR, T2* and B1 flip scale) grid, normalized, and every voxel
+% is matched to the atom with the largest inner product. M0 follows
+% from the projection onto the matched atom.
+%
+% Voxels are matched in blocks by dense matrix products, which MATLAB
+% runs through its multithreaded SIMD BLAS. Dictionaries are cached on
+% disk keyed by the model, sequence parameters and grids, so repeat
+% calls with the same protocol skip the build.
+%
+% Models and sequence fields:
+%   'ir'    : S = M0 (1 - 2 exp(-TI/T1))                      seq.TI
+%   'absir' : |ir|                                            seq.TI
+%   'sr'    : S = M0 (1 - exp(-TR/T1))                        seq.TR
+%   'spgr'  : spgreq(TR, TE, B1 * alpha, T1, T2s, M0)         seq.TR, seq.TE, seq.alpha
+%
+% ARGS:
+% model = 'ir', 'absir', 'sr' or 'spgr'
+% seq   = sequence parameter structure (times in ms, flip angles in degrees)
+% S     = N-D matrix with samples as final dimension
+% opts  = optional structure with fields:
+%   T1       = T1 grid (ms) [logspace(1, log10(5000), 400)]
+%   T2       = T2* grid for SPGR with varying TE (ms) [logspace(0, log10(500), 60)]
+%   B1       = flip angle scale grid for SPGR [1]
+%   blocksize= maximum voxels per matching block [4096]
+%   polish   = refine matches by local nonlinear fit (ir, absir, sr) or
+%              parabolic interpolation of the match score over a log-spaced
+%              T1 grid (spgr) [0]
+%   cachedir = on-disk dictionary cache, '' to disable [fullfile(tempdir, 'dictfitn')]
+%
+% RETURNS:
+% T1    = T1 map (ms)
+% M0    = M0 map
+% T2    = T2* map for SPGR with varying TE, otherwise empty
+% B1    = flip angle scale map for SPGR, otherwise empty
+% score = normalized match score (cosine similarity, 1 = perfect)
+%
+% AUTHOR : Mike Tyszka, Ph.D.
+% PLACE  : Caltech BIC
+% DATES  : 10/19/2026 JMT From scratch
+%          10/19/2026 JMT No Jacobian in the IR polish fallback
+%          10/19/2026 JMT SPGR polish recomputes M0 from the interpolated atom
+% REFS   : Ma D et al. Nature 2013; 495:187-192
+%
+% The MIT License (MIT)
+%
+% Copyright (c) 2016 Mike Tyszka
+%
+%   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+%   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+%   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+%   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+%
+%   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+%   Software.
+%
+%   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+%   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+%   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+%   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+% Default options
+if nargin < 4 opts = struct(); end
+if ~isfield(opts, 'T1') opts.T1 = logspace(1, log10(5000), 400); end
+if ~isfield(opts, 'T2') opts.T2 = logspace(0, log10(500), 60); end
+if ~isfield(opts, 'B1') opts.B1 = 1; end
+if ~isfield(opts, 'blocksize') opts.blocksize = 4096; end
+if ~isfield(opts, 'polish') opts.polish = 0; end
+if ~isfield(opts, 'cachedir') opts.cachedir = fullfile(tempdir, 'dictfitn'); end
+
+% Get dimensions
+dims = size(S);
+ndims = length(dims);
+nvox = prod(dims(1:(ndims-1)));
+nt = dims(ndims);
+
+% Sample times and grids for this model
+[t, grids] = dict_setup(model, seq, opts);
+
+if length(t) ~= nt
+  fprintf('Sequence parameters do not match final dimension of data\n');
+  T1 = []; M0 = []; T2 = []; B1 = []; score = [];
+  return
+end
+
+% Load or build the dictionary
+[D, G] = dict_load(model, seq, grids, opts.cachedir);
+natoms = size(D,2);
+
+% Magnitude models match magnitude data
+S = double(reshape(S, [nvox nt]));
+if any(strcmp(model, {'absir', 'spgr'}))
+  S = abs(S);
+end
+
+% Unit norm atoms, keeping the norms to recover M0
+dnorm = sqrt(sum(D.^2, 1));
+Dn = D ./ repmat(dnorm + eps, nt, 1);
+
+% Limit each block of inner products to about 64 MB
+opts.blocksize = max(1, min(opts.blocksize, floor(8e6 / natoms)));
+
+imatch = zeros(nvox,1);
+score = zeros(nvox,1);
+M0 = zeros(nvox,1);
+
+% Blocked maximum inner product search
+for v0 = 1:opts.blocksize:nvox
+
+  v = v0:min(v0 + opts.blocksize - 1, nvox);
+
+  Sb = S(v,:);
+  snorm = sqrt(sum(Sb.^2, 2));
+
+  % Signed inner products : a voxel matches its atom with the same polarity
+  IP = Sb * Dn;
+  [ipmax, k] = max(IP, [], 2);
+
+  imatch(v) = k;
+  score(v) = ipmax ./ (snorm + eps);
+  M0(v) = ipmax ./ (dnorm(k)' + eps);
+
+end
+
+% Matched grid parameters
+T1 = G(imatch,1);
+T2 = G(imatch,2);
+B1 = G(imatch,3);
+
+if opts.polish
+  [T1, M0] = dict_polish(model, seq, t, S, T1, M0, Dn, G, imatch, grids, opts.blocksize);
+end
+
+% Reshape maps back to Ndims-1
+vdims = dims(1:(ndims-1));
+if length(vdims) == 1 vdims = [vdims 1]; end
+T1 = reshape(T1, vdims);
+M0 = reshape(M0, vdims);
+score = reshape(score, vdims);
+
+if strcmp(model, 'spgr')
+  B1 = reshape(B1, vdims);
+  if length(grids.T2) > 1
+    T2 = reshape(T2, vdims);
+  else
+    T2 = [];
+  end
+else
+  T2 = [];
+  B1 = [];
+end
+
+%------------------------------------------------------------
+% Sample times and parameter grids for each model
+%------------------------------------------------------------
+function [t, grids] = dict_setup(model, seq, opts)
+
+grids.T1 = opts.T1(:)';
+grids.T2 = Inf;
+grids.B1 = 1;
+
+switch model
+  case {'ir', 'absir'}
+    t = seq.TI(:)';
+  case 'sr'
+    t = seq.TR(:)';
+  case 'spgr'
+    n = max([numel(seq.TR) numel(seq.TE) numel(seq.alpha)]);
+    t = 1:n;
+    if numel(unique(seq.TE)) > 1
+      grids.T2 = opts.T2(:)';
+    end
+    grids.B1 = opts.B1(:)';
+  otherwise
+    error('dictfitn : unknown model %s', model);
+end
+
+%------------------------------------------------------------
+% Cached dictionary lookup
+% The full key is stored with the dictionary and compared on
+% load, so a checksum collision only costs a rebuild.
+%------------------------------------------------------------
+function [D, G] = dict_load(model, seq, grids, cachedir)
+
+persistent last
+
+key = dict_key(model, seq, grids);
+
+if ~isempty(last) && strcmp(last.key, key)
+  D = last.D; G = last.G;
+  return
+end
+
+fname = '';
+if ~isempty(cachedir)
+  fname = fullfile(cachedir, sprintf('%s_%08x.mat', model, dict_checksum(key)));
+  if exist(fname, 'file')
+    c = load(fname);
+    if isfield(c, 'key') && strcmp(c.key, key)
+      D = c.D; G = c.G;
+      last = c;
+      return
+    end
+  end
+end
+
+[D, G] = dict_build(model, seq, grids);
+
+if ~isempty(fname)
+  if ~exist(cachedir, 'dir') mkdir(cachedir); end
+  try
+    save(fname, 'key', 'D', 'G');
+  catch
+    fprintf('dictfitn : could not write dictionary cache %s\n', fname);
+  end
+end
+
+last.key = key; last.D = D; last.G = G;
+
+%------------------------------------------------------------
+% Key string from model, sequence parameters and grids
+%------------------------------------------------------------
+function key = dict_key(model, seq, grids)
+
+key = model;
+f = sort(fieldnames(seq));
+for i = 1:length(f)
+  key = [key sprintf('|%s:', f{i}) sprintf('%.10g,', seq.(f{i}))];
+end
+key = [key '|T1:' sprintf('%.10g,', grids.T1)];
+key = [key '|T2:' sprintf('%.10g,', grids.T2)];
+key = [key '|B1:' sprintf('%.10g,', grids.B1)];
+
+%------------------------------------------------------------
+% 32-bit Adler-style checksum of a string
+%------------------------------------------------------------
+function c = dict_checksum(str)
+
+d = double(str);
+a = mod(1 + cumsum(d), 65521);
+b = mod(sum(a), 65521);
+c = b * 65536 + a(end);
+
+%------------------------------------------------------------
+% Dictionary atoms as columns of D [nt x natoms] with grid
+% parameters [T1 T2 B1] in the rows of G
+%------------------------------------------------------------
+function [D, G] = dict_build(model, seq, grids)
+
+[T1g, T2g, B1g] = ndgrid(grids.T1, grids.T2, grids.B1);
+G = [T1g(:) T2g(:) B1g(:)];
+D = dict_signal(model, seq, G);
+
+%------------------------------------------------------------
+% Model signals as columns [nt x n] for parameter rows [T1 T2 B1]
+%------------------------------------------------------------
+function D = dict_signal(model, seq, G)
+
+T1 = G(:,1)';
+
+switch model
+
+  case 'ir'
+    D = 1 - 2 * exp(-seq.TI(:) * (1 ./ T1));
+
+  case 'absir'
+    D = abs(1 - 2 * exp(-seq.TI(:) * (1 ./ T1)));
+
+  case 'sr'
+    D = 1 - exp(-seq.TR(:) * (1 ./ T1));
+
+  case 'spgr'
+    n = max([numel(seq.TR) numel(seq.TE) numel(seq.alpha)]);
+    TR = seq.TR(:) .* ones(n,1);
+    TE = seq.TE(:) .* ones(n,1);
+    alpha = seq.alpha(:) .* ones(n,1) * pi / 180;
+    E1 = exp(-TR * (1 ./ T1));
+    E2s = exp(-TE * (1 ./ G(:,2)'));
+    a = alpha * G(:,3)';
+    D = (1 - E1) .* sin(a) ./ (1 - E1 .* cos(a)) .* E2s;
+
+end
+
+%------------------------------------------------------------
+% Local refinement of the dictionary match
+%------------------------------------------------------------
+function [T1, M0] = dict_polish(model, seq, t, S, T1, M0, Dn, G, imatch, grids, blocksize)
+
+nvox = size(S,1);
+
+switch model
+
+  case {'ir', 'absir', 'sr'}
+
+    % Nonlinear fit from the matched atom, inversion efficiency free for IR
+    ok = M0 > 0;
+    switch model
+      case 'sr'
+        P0 = [M0(ok) T1(ok) zeros(sum(ok),1)];
+        lb = [0 0 -Inf]; ub = [Inf Inf Inf];
+        iT = 2;
+      otherwise
+        P0 = [M0(ok) -ones(sum(ok),1) T1(ok)];
+        lb = [0 -1 0]; ub = [Inf 1 Inf];
+        iT = 3;
+    end
+
+    if exist('relaxfit_mex','file') == 3
+      P = relaxfit_mex(model, t, S(ok,:), P0, lb, ub);
+    else
+      P = P0;
+      % Only the SR contrast function returns a Jacobian
+      jac = 'off';
+      if strcmp(model, 'sr') jac = 'on'; end
+      opt = optimset('lsqcurvefit');
+      opt = optimset(opt, 'Display', 'off', 'Jacobian', jac, 'TolX', 1e-6, 'TolFun', 1e-6);
+      fn = struct('ir', 'lsq_ircontrast', 'absir', 'lsq_absircontrast', 'sr', 'lsq_srcontrast');
+      iv = find(ok);
+      for j = 1:length(iv)
+        P(j,:) = lsqcurvefit(fn.(model), P0(j,:), t, S(iv(j),:), lb, ub, opt);
+      end
+    end
+
+    M0(ok) = P(:,1);
+    T1(ok) = P(:,iT);
+
+  case 'spgr'
+
+    % Parabolic interpolation of the score in log T1 about the match,
+    % then M0 by projection onto the interpolated atom
+    nT1 = length(grids.T1);
+    [i1, rest] = ind2sub([nT1 size(G,1)/nT1], imatch);
+    in = i1 > 1 & i1 < nT1;
+    u = log(grids.T1(:));
+
+    for v0 = 1:blocksize:nvox
+      v = (v0:min(v0 + blocksize - 1, nvox))';
+      v = v(in(v));
+      if isempty(v) continue; end
+      km = sub2ind([nT1 size(G,1)/nT1], i1(v) - 1, rest(v));
+      kp = sub2ind([nT1 size(G,1)/nT1], i1(v) + 1, rest(v));
+      sm = sum(S(v,:) .* Dn(:,km)', 2);
+      s0 = sum(S(v,:) .* Dn(:,imatch(v))', 2);
+      sp = sum(S(v,:) .* Dn(:,kp)', 2);
+      den = sm - 2 * s0 + sp;
+      d = zeros(size(v));
+      ok = den < 0;
+      d(ok) = 0.5 * (sm(ok) - sp(ok)) ./ den(ok);
+      d = max(min(d, 0.5), -0.5);
+      T1(v) = exp(u(i1(v)) + d .* (u(i1(v) + 1) - u(i1(v))));
+      Dv = dict_signal(model, seq, [T1(v) G(imatch(v),2) G(imatch(v),3)]);
+      M0(v) = sum(S(v,:) .* Dv', 2) ./ (sum(Dv.^2, 1)' + eps);
+    end
+
+end
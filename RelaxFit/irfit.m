@@ -1,5 +1,5 @@
-function [M0, T1, alpha] = irfit(Mz, TI, modflag)
-% [M0, T1, alpha] = irfit(Mz, TI, modflag)
+function [M0, T1, alpha] = irfit(Mz, TI, modflag, x0)
+% [M0, T1, alpha] = irfit(Mz, TI, modflag, x0)
 %
 % Fit the IR recovery equation to Mz(TI)
 %
@@ -14,11 +14,13 @@ function [M0, T1, alpha] = irfit(Mz, TI, modflag)
 % Mz = Mz(TI) vector
 % TI = Inversion time vector (ms)
 % modflag = 0 if Mz is signed, 1 if |Mz| is provided
+% x0 = optional initial estimates [M0 alpha T1] [T1 from TI at minimum |Mz|]
 %
 % AUTHOR : Mike Tyszka, Ph.D.
 % PLACE  : Caltech BIC
 % DATES  : 11/09/2000 From scratch
 %          09/06/2001 Update for use with T1 mapping
+%          10/19/2026 JMT Optional initial estimates
 %
 % The MIT License (MIT)
 %
@@ -44,8 +46,10 @@ options.TolFun = 1e-3;
 
 % Initial guess at parameters
 % Guess T1 from TI for the minimum |Mz|
-[minMz, imin] = min(abs(Mz));
-x0 = [max(abs(Mz)) -1 TI(imin)];
+if nargin < 4 || isempty(x0)
+  [minMz, imin] = min(abs(Mz));
+  x0 = [max(abs(Mz)) -1 TI(imin)];
+end
 xmin = [0 -1 0];
 xmax = [Inf 1 Inf];
 
@@ -1,5 +1,5 @@
-function [S0, T1, Mask] = irfitn(IR, TI)
-% [S0, T1, Mask] = irfitn(IR, TI)
+function [S0, T1, Mask, Q] = irfitn(IR, TI, method, verbose, mask)
+% [S0, T1, Mask, Q] = irfitn(IR, TI, method, verbose, mask)
 %
 % Fit the IR contrast equation:
 %
@@ -10,15 +10,27 @@ function [S0, T1, Mask] = irfitn(IR, TI)
 % ARGS:
 % IR = N-D matrix with inversion time as final dimension
 % TI = Inversion times for each time point
+% method = 'lsq' or 'varpro' (S0 and alpha solved in closed form, T1 searched) ['lsq']
+% verbose = 0 (none) or 1 (progress and timing reports) [1]
+% mask = fit mask replacing the relative threshold, eg a global mask
+%        from streamfitn [25% of the maximum at the longest TI]
 %
 % RETURNS:
 % S0 = S(TI=Inf) matrix
 % T1 = T1 matrix (ms)
 % Mask = fit mask used to reduce voxel count
+% Q    = Cramer-Rao variance, residual and iteration maps from relaxfit_mex
+%        (see relaxstats), parameters ordered [S0 alpha T1]. Empty without the MEX
 %
 % AUTHOR : Mike Tyszka, Ph.D.
 % PLACE  : Caltech BIC
 % DATES  : 09/06/2001 Adapt from srfit.m
+%          10/19/2026 JMT Use threaded relaxfit_mex when compiled
+%          10/19/2026 JMT Add varpro method
+%          10/19/2026 JMT Vectorized null point initial estimates
+%          10/19/2026 JMT Throttled progress reports replace per-voxel waitbar
+%          10/19/2026 JMT Return Cramer-Rao variance and fit quality maps
+%          10/19/2026 JMT Optional fit mask
 %
 % The MIT License (MIT)
 %
@@ -37,6 +49,11 @@ function [S0, T1, Mask] = irfitn(IR, TI)
 %   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
 %   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
+% Default args
+if nargin < 3 method = 'lsq'; end
+if nargin < 4 verbose = 1; end
+if nargin < 5 mask = []; end
+
 % Get dimensions
 dims = size(IR);
 ndims = length(dims);
@@ -47,6 +64,9 @@ nti2 = length(TI);
 % Default returns
 S0 = [];
 T1 = [];
+Mask = [];
+Q = [];
+V = [];
 
 % Check that enough TI values were provided
 if ~isequal(nti1, nti2)
@@ -56,28 +76,70 @@ else
   nt = nti1;
 end
 
+% Check that a supplied mask matches the voxel count
+if numel(mask) > 0 && numel(mask) ~= nvox
+  fprintf('Mask does not match the spatial dimensions of the data\n');
+  return
+end
+
 % Reshape and make space for results
 IR = reshape(IR, [nvox nt]);
 S0 = zeros(nvox,1);
 T1 = zeros(nvox,1);
 
-% Create a mask from the image with the greatest TR
-[maxTI, tmax] = max(TI(:));
-maxIR = IR(:,tmax);
-IRthresh = max(maxIR(:)) * 0.25;
-Mask = maxIR > IRthresh;
+% Create a mask from the image with the greatest TI unless one was supplied
+if isempty(mask)
+  [maxTI, tmax] = max(TI(:));
+  maxIR = IR(:,tmax);
+  IRthresh = max(maxIR(:)) * 0.25;
+  Mask = maxIR > IRthresh;
+else
+  Mask = logical(mask(:));
+end
 
 nmask = sum(Mask);
 
-% Fit SR equation to each voxel in turn
-hwb = waitbar(0,'');
-for v = 1:nvox
-  waitbar(v/nvox,hwb,sprintf('Fitting IR equation : %d/%d', v, nvox));
-  if Mask(v)
-    [S0(v), T1(v), alpha] = irfit(IR(v,:), TI, 1);
+pr = fitprogress('start', 'irfitn', nmask, verbose > 0);
+
+% Variable projection, threaded relaxfit_mex or per-voxel lsqcurvefit
+if strcmp(method, 'varpro')
+
+  % Variable projection with polarity restoration needs no initial estimates
+  [P, resnorm, niter, V] = varprofitn('absir', TI, IR(Mask,:), [0 -1 0], [Inf 1 Inf]);
+
+  S0(Mask) = P(:,1);
+  T1(Mask) = P(:,3);
+
+elseif exist('relaxfit_mex','file') == 3
+
+  % Null point T1 and polarity restored M0, alpha for all mask voxels
+  pr = fitprogress('stage', pr, 'init');
+  IRm = double(IR(Mask,:));
+  P0 = relaxinit('absir', TI, IRm, [0 -1 0], [Inf 1 Inf]);
+
+  pr = fitprogress('stage', pr, 'fit');
+  [P, resnorm, niter, V] = relaxfit_mex('absir', TI(:)', IRm, P0, [0 -1 0], [Inf 1 Inf]);
+
+  S0(Mask) = P(:,1);
+  T1(Mask) = P(:,3);
+
+else
+
+  % Fit IR equation to each mask voxel in turn from the closed form estimates
+  pr = fitprogress('stage', pr, 'init');
+  P0 = relaxinit('absir', TI, IR(Mask,:), [0 -1 0], [Inf 1 Inf]);
+
+  pr = fitprogress('stage', pr, 'fit');
+  vm = find(Mask);
+  for k = 1:nmask
+    v = vm(k);
+    [S0(v), T1(v), alpha] = irfit(IR(v,:), TI, 1, P0(k,:));
+    if k >= pr.next, pr = fitprogress('update', pr, k); end
   end
+
 end
-close(hwb);
+
+fitprogress('done', pr);
 
 % Reshape maps back to Ndims-1
 vdims = dims(1:(ndims-1));
@@ -85,3 +147,7 @@ S0 = reshape(S0, vdims);
 T1 = reshape(T1, vdims);
 Mask = reshape(Mask, vdims);
 
+% Cramer-Rao variance, residual and iteration maps from the native fit
+if ~isempty(V)
+  Q = relaxstats(Mask, V, resnorm, niter);
+end
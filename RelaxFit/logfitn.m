@@ -1,5 +1,5 @@
-function [S0, T2, Mask] = logfitn(TE, S, verbose)
-% [S0, T2, Mask] = t2fitn(TE, S, verbose)
+function [S0, T2, Mask] = logfitn(TE, S, verbose, mask)
+% [S0, T2, Mask] = logfitn(TE, S, verbose, mask)
 %
 % Fit the T2 contrast equation in log-linear space:
 %
@@ -10,6 +10,8 @@ function [S0, T2, Mask] = logfitn(TE, S, verbose)
 % ARGS:
 % TE = echo time vector for the final dimension (ms)
 % S  = N-D matrix with echo time as final dimension
+% mask = fit mask replacing the relative threshold, eg a global mask
+%        from streamfitn [10% of the maximum of the mean over TE]
 %
 % RETURNS:
 % S0 = S(TE=0) matrix
@@ -18,6 +20,8 @@ function [S0, T2, Mask] = logfitn(TE, S, verbose)
 % AUTHOR : Mike Tyszka, Ph.D.
 % PLACE  : Caltech BIC
 % DATES  : 04/06/2004 JMT Adapt from t2fitn.m (JMT)
+%          10/19/2026 JMT Throttled progress reports replace per-voxel waitbar
+%          10/19/2026 JMT Optional fit mask
 %
 % The MIT License (MIT)
 %
@@ -38,6 +42,7 @@ function [S0, T2, Mask] = logfitn(TE, S, verbose)
 
 % Default args
 if nargin < 3 verbose = 0; end
+if nargin < 4 mask = []; end
 
 % Get dimensions
 dims = size(S);
@@ -59,6 +64,12 @@ else
   nte = nte1;
 end
 
+% Check that a supplied mask matches the voxel count
+if numel(mask) > 0 && numel(mask) ~= nvox
+  fprintf('Mask does not match the spatial dimensions of the data\n');
+  return
+end
+
 % Reshape and take log of S(TE)
 S  = reshape(S, [nvox nte]);
 logS = log(S);
@@ -66,38 +77,45 @@ logS = log(S);
 S0 = zeros(nvox,1);
 T2 = zeros(nvox,1);
 
-% Create a 10% mask from the mean image
-mS = mean(S,2);
-Mask = mS > max(mS(:)) * 0.1;
+% Create a 10% mask from the mean image unless one was supplied
+if isempty(mask)
+  mS = mean(S,2);
+  Mask = mS > max(mS(:)) * 0.1;
+else
+  Mask = logical(mask(:));
+end
 
 nmask = sum(Mask);
 
-hwb = waitbar(0,'');
-
-for v = 1:nvox
-
-  f = v/nvox;
-  waitbar(f,hwb,sprintf('Fitting voxel %d of %d - %0.0f%% complete',v,nvox,f*100));
-    
-  if Mask(v)
-    
-    p = polyfit(TE,logS(v,:),1);
-    S_fit = polyval(p, TE);
-    T2(v) = -1/p(1);
-    S0(v) = p(2);
-    
-    if verbose
+pr = fitprogress('start', 'logfitn', nmask, verbose > 0);
+
+vm = find(Mask);
+
+for k = 1:nmask
+
+  v = vm(k);
+
+  p = polyfit(TE,logS(v,:),1);
+  S_fit = polyval(p, TE);
+  T2(v) = -1/p(1);
+  S0(v) = p(2);
+
+  if k >= pr.next
+
+    pr = fitprogress('update', pr, k);
+
+    if pr.reported
       figure(10); clf;
       plot(TE,log(S(v,:)),'o',TE,S_fit);
       title(sprintf('T_2 = %0.3f\n', T2(v)));
       drawnow;
     end
-    
+
   end
-  
+
 end
 
-close(hwb);
+fitprogress('done', pr);
 
 % Reshape maps back to Ndims-1
 vdims = dims(1:(ndims-1));
@@ -1,5 +1,5 @@
-function [S0, T2] = mefit(ME, TE)
-% [S0, T2] = mefit(ME, TE)
+function [S0, T2] = mefit(ME, TE, x0)
+% [S0, T2] = mefit(ME, TE, x0)
 %
 % Fit the T2 contrast equation:
 %
@@ -10,6 +10,7 @@ function [S0, T2] = mefit(ME, TE)
 % ARGS:
 % ME = N-D matrix with echo time as final dimension
 % TE = echo time vector for the final dimension
+% x0 = optional initial estimates [S0 T2] [first echo and shortest TE]
 %
 % RETURNS:
 % S0 = S(TE=0) matrix
@@ -18,6 +19,7 @@ function [S0, T2] = mefit(ME, TE)
 % AUTHOR : Mike Tyszka, Ph.D.
 % PLACE  : Caltech BIC
 % DATES  : 09/06/2001 Adapt from irfit
+%          10/19/2026 JMT Optional initial estimates
 %
 % The MIT License (MIT)
 %
@@ -39,7 +41,9 @@ function [S0, T2] = mefit(ME, TE)
 options = optimset('lsqcurvefit');
 options.Display = 'none';
 
-x0   = [ME(1) min(TE)];
+if nargin < 3 || isempty(x0)
+  x0 = [ME(1) min(TE)];
+end
 xmin = [0 0];
 xmax = [Inf Inf];
 
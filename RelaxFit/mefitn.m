@@ -1,5 +1,5 @@
-function [S0, T2, Mask] = mefitn(ME, TE)
-% [S0, T2, Mask] = mefitn(ME, TE)
+function [S0, T2, Mask, Q] = mefitn(ME, TE, verbose, mask)
+% [S0, T2, Mask, Q] = mefitn(ME, TE, verbose, mask)
 %
 % Fit the ME contrast equation:
 %
@@ -10,15 +10,25 @@ function [S0, T2, Mask] = mefitn(ME, TE)
 % ARGS:
 % ME = N-D matrix with inversion time as final dimension
 % TE = Inversion times for each time point
+% verbose = 0 (none) or 1 (progress and timing reports) [1]
+% mask = fit mask replacing the relative threshold, eg a global mask
+%        from streamfitn [25% of the maximum at the shortest TE]
 %
 % RETURNS:
 % S0 = S(TE=Inf) matrix
 % T2 = T2 matrix (ms)
 % Mask = fit mask used to reduce voxel count
+% Q    = Cramer-Rao variance, residual and iteration maps from relaxfit_mex
+%        (see relaxstats), parameters ordered [S0 T2]. Empty without the MEX
 %
 % AUTHOR : Mike Tyszka, Ph.D.
 % PLACE  : Caltech BIC
 % DATES  : 09/06/2001 Adapt from srfit.m
+%          10/19/2026 JMT Use threaded relaxfit_mex when compiled
+%          10/19/2026 JMT Vectorized log-linear initial estimates
+%          10/19/2026 JMT Throttled progress reports replace per-voxel waitbar
+%          10/19/2026 JMT Return Cramer-Rao variance and fit quality maps
+%          10/19/2026 JMT Optional fit mask
 %
 % The MIT License (MIT)
 %
@@ -37,6 +47,10 @@ function [S0, T2, Mask] = mefitn(ME, TE)
 %   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
 %   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
+% Default args
+if nargin < 3 verbose = 1; end
+if nargin < 4 mask = []; end
+
 % Get dimensions
 dims = size(ME);
 ndims = length(dims);
@@ -47,6 +61,9 @@ nti2 = length(TE);
 % Default returns
 S0 = [];
 T2 = [];
+Mask = [];
+Q = [];
+V = [];
 
 % Check that enough TE values were provided
 if ~isequal(nti1, nti2)
@@ -56,6 +73,12 @@ else
   nt = nti1;
 end
 
+% Check that a supplied mask matches the voxel count
+if numel(mask) > 0 && numel(mask) ~= nvox
+  fprintf('Mask does not match the spatial dimensions of the data\n');
+  return
+end
+
 % Reshape and make space for results
 ME = reshape(ME, [nvox nt]);
 S0 = zeros(nvox,1);
@@ -66,23 +89,47 @@ T2 = zeros(nvox,1);
 %TE = TE(5:nt);
 %nt = nt - 4;
 
-% Create a mask from the image with the shortest TE
-[minTE, tmin] = min(TE(:));
-maxME = ME(:,tmin);
-MEthresh = max(maxME(:)) * 0.25;
-Mask = maxME > MEthresh;
+% Create a mask from the image with the shortest TE unless one was supplied
+if isempty(mask)
+  [minTE, tmin] = min(TE(:));
+  maxME = ME(:,tmin);
+  MEthresh = max(maxME(:)) * 0.25;
+  Mask = maxME > MEthresh;
+else
+  Mask = logical(mask(:));
+end
 
 nmask = sum(Mask);
 
-% Fit ME equation to each voxel in turn
-hwb = waitbar(0,'');
-for v = 1:nvox
-  waitbar(v/nvox,hwb,sprintf('Fitting ME equation : %d/%d', v, nvox));
-  if Mask(v)
-    [S0(v), T2(v)] = mefit(ME(v,:), TE);
+pr = fitprogress('start', 'mefitn', nmask, verbose > 0);
+
+% Weighted log-linear initial estimates for all mask voxels
+pr = fitprogress('stage', pr, 'init');
+P0 = relaxinit('exp', TE, ME(Mask,:), [0 0], [Inf Inf]);
+
+pr = fitprogress('stage', pr, 'fit');
+
+% Native threaded fit of all mask voxels when compiled
+if exist('relaxfit_mex','file') == 3
+
+  [P, resnorm, niter, V] = relaxfit_mex('exp', TE(:)', double(ME(Mask,:)), P0, [0 0], [Inf Inf]);
+
+  S0(Mask) = P(:,1);
+  T2(Mask) = P(:,2);
+
+else
+
+  % Fit ME equation to each mask voxel in turn
+  vm = find(Mask);
+  for k = 1:nmask
+    v = vm(k);
+    [S0(v), T2(v)] = mefit(ME(v,:), TE, P0(k,:));
+    if k >= pr.next, pr = fitprogress('update', pr, k); end
   end
+
 end
-close(hwb);
+
+fitprogress('done', pr);
 
 % Reshape maps back to Ndims-1
 vdims = dims(1:(ndims-1));
@@ -90,3 +137,7 @@ S0 = reshape(S0, vdims);
 T2 = reshape(T2, vdims);
 Mask = reshape(Mask, vdims);
 
+% Cramer-Rao variance, residual and iteration maps from the native fit
+if ~isempty(V)
+  Q = relaxstats(Mask, V, resnorm, niter);
+end
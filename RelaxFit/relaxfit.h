@@ -0,0 +1,662 @@
+/************************************************************
+ * Relaxometry signal models and bounded Levenberg-Marquardt
+ * solver for relaxfit_mex.c
+ *
+ * Models (t in the same units as the returned time constant):
+ *
+ *   exp   : S = M0 * exp(-t/T)                      p = [M0 T]
+ *   expc  : S = M0 * exp(-t/T) + C                  p = [M0 T C]
+ *   ir    : S = M0 * (1 + (alpha - 1) exp(-t/T1))   p = [M0 alpha T1]
+ *   absir : S = |M0 * (1 + (alpha - 1) exp(-t/T1))| p = [M0 alpha T1]
+ *   sr    : S = A * (1 - exp(-t/T1)) + C            p = [A T1 C]
+ *
+ * matching lsq_t2contrast, lsq_mecontrast, lsq_ircontrast,
+ * lsq_absircontrast and lsq_srcontrast.
+ *
+ * Every model is linear in all parameters but the time constant,
+ * so each also supplies its linear basis for variable projection
+ * (rf_varpro_fit), which searches the time constant alone.
+ *
+ * Both solvers leave the Jacobian at the fitted parameters in their
+ * workspace, from which rf_crlb gives the Cramer-Rao parameter
+ * variances without further model evaluations.
+ *
+ * AUTHOR : Mike Tyszka, Ph.D.
+ * PLACE  : Caltech BIC
+ * DATES  : 10/19/2026 JMT From scratch
+ *          10/19/2026 JMT Add variable projection solver
+ *          10/19/2026 JMT Add Cramer-Rao variances from the final Jacobian
+ *          10/19/2026 JMT Header helpers static inline
+ * REFS   : Golub G, Pereyra V. Inverse Problems 2003; 19:R1-R26
+ *          Barral JK et al. Magn Reson Med 2010; 64:1057-1067
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Mike Tyszka
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ *   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ *   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ *   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ *   Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ *   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ *   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ************************************************************/
+
+#ifndef RELAXFIT_H
+#define RELAXFIT_H
+
+#include <math.h>
+#include <string.h>
+
+/* Maximum number of model parameters */
+#define RF_MAXP 8
+
+/* Smallest time constant passed to exp(-t/T) */
+#define RF_TMIN 1e-9
+
+/* Maximum number of linear (amplitude) parameters */
+#define RF_MAXL 2
+
+/* Log-spaced time constants in the VARPRO starting grid */
+#define RF_NGRID 32
+
+/* Model evaluation: f[nt] and column-major Jacobian J[nt x np] (J may be NULL) */
+typedef void (*rf_eval_fn)(const double *p, const double *t, int nt, double *f, double *J);
+
+/* Linear basis B[nt x nl] for time constant T */
+typedef void (*rf_basis_fn)(double T, const double *t, int nt, double *B);
+
+/* Model parameters p[np] from linear coefficients c[nl] and T */
+typedef void (*rf_unpack_fn)(const double *c, double T, double *p);
+
+typedef struct {
+  const char *name;
+  int np;
+  rf_eval_fn eval;
+  int nl;             /* number of linear parameters */
+  int iT;             /* index of the time constant in p */
+  int polarity;       /* magnitude data needing polarity restoration */
+  rf_basis_fn basis;
+  rf_unpack_fn unpack;
+} rf_model;
+
+/************************************************************
+ * Model functions with analytic Jacobians
+ ************************************************************/
+
+static inline void rf_exp(const double *p, const double *t, int nt, double *f, double *J)
+{
+  double M0 = p[0], T = (p[1] > RF_TMIN) ? p[1] : RF_TMIN;
+  double E;
+  int k;
+
+  for (k = 0; k < nt; k++) {
+    E = exp(-t[k] / T);
+    f[k] = M0 * E;
+    if (J) {
+      J[k]      = E;
+      J[k + nt] = M0 * E * t[k] / (T * T);
+    }
+  }
+}
+
+static inline void rf_expc(const double *p, const double *t, int nt, double *f, double *J)
+{
+  double M0 = p[0], T = (p[1] > RF_TMIN) ? p[1] : RF_TMIN, C = p[2];
+  double E;
+  int k;
+
+  for (k = 0; k < nt; k++) {
+    E = exp(-t[k] / T);
+    f[k] = M0 * E + C;
+    if (J) {
+      J[k]        = E;
+      J[k + nt]   = M0 * E * t[k] / (T * T);
+      J[k + 2*nt] = 1.0;
+    }
+  }
+}
+
+static inline void rf_ir(const double *p, const double *t, int nt, double *f, double *J)
+{
+  double M0 = p[0], a = p[1], T1 = (p[2] > RF_TMIN) ? p[2] : RF_TMIN;
+  double E;
+  int k;
+
+  for (k = 0; k < nt; k++) {
+    E = exp(-t[k] / T1);
+    f[k] = M0 * (1.0 + (a - 1.0) * E);
+    if (J) {
+      J[k]        = 1.0 + (a - 1.0) * E;
+      J[k + nt]   = M0 * E;
+      J[k + 2*nt] = M0 * (a - 1.0) * E * t[k] / (T1 * T1);
+    }
+  }
+}
+
+static inline void rf_absir(const double *p, const double *t, int nt, double *f, double *J)
+{
+  int k;
+
+  rf_ir(p, t, nt, f, J);
+
+  for (k = 0; k < nt; k++) {
+    if (f[k] < 0.0) {
+      f[k] = -f[k];
+      if (J) {
+	J[k]        = -J[k];
+	J[k + nt]   = -J[k + nt];
+	J[k + 2*nt] = -J[k + 2*nt];
+      }
+    }
+  }
+}
+
+static inline void rf_sr(const double *p, const double *t, int nt, double *f, double *J)
+{
+  double A = p[0], T1 = (p[1] > RF_TMIN) ? p[1] : RF_TMIN, C = p[2];
+  double E;
+  int k;
+
+  for (k = 0; k < nt; k++) {
+    E = exp(-t[k] / T1);
+    f[k] = A * (1.0 - E) + C;
+    if (J) {
+      J[k]        = 1.0 - E;
+      J[k + nt]   = -A * E * t[k] / (T1 * T1);
+      J[k + 2*nt] = 1.0;
+    }
+  }
+}
+
+/************************************************************
+ * Linear bases and coefficient unpacking for VARPRO
+ ************************************************************/
+
+static inline void rf_basis_exp(double T, const double *t, int nt, double *B)
+{
+  int k;
+  for (k = 0; k < nt; k++) B[k] = exp(-t[k] / T);
+}
+
+static inline void rf_basis_expc(double T, const double *t, int nt, double *B)
+{
+  int k;
+  for (k = 0; k < nt; k++) {
+    B[k]      = exp(-t[k] / T);
+    B[k + nt] = 1.0;
+  }
+}
+
+/* M0 * (1 + (alpha - 1) E) = c0 + c1 E */
+static inline void rf_basis_ir(double T, const double *t, int nt, double *B)
+{
+  int k;
+  for (k = 0; k < nt; k++) {
+    B[k]      = 1.0;
+    B[k + nt] = exp(-t[k] / T);
+  }
+}
+
+static inline void rf_basis_sr(double T, const double *t, int nt, double *B)
+{
+  int k;
+  for (k = 0; k < nt; k++) {
+    B[k]      = 1.0 - exp(-t[k] / T);
+    B[k + nt] = 1.0;
+  }
+}
+
+static inline void rf_unpack_exp(const double *c, double T, double *p)
+{
+  p[0] = c[0]; p[1] = T;
+}
+
+static inline void rf_unpack_expc(const double *c, double T, double *p)
+{
+  p[0] = c[0]; p[1] = T; p[2] = c[1];
+}
+
+static inline void rf_unpack_ir(const double *c, double T, double *p)
+{
+  p[0] = c[0];
+  p[1] = (c[0] != 0.0) ? 1.0 + c[1] / c[0] : -1.0;
+  p[2] = T;
+}
+
+static const rf_model rf_models[] = {
+  {"exp",   2, rf_exp,   1, 1, 0, rf_basis_exp,  rf_unpack_exp},
+  {"expc",  3, rf_expc,  2, 1, 0, rf_basis_expc, rf_unpack_expc},
+  {"ir",    3, rf_ir,    2, 2, 0, rf_basis_ir,   rf_unpack_ir},
+  {"absir", 3, rf_absir, 2, 2, 1, rf_basis_ir,   rf_unpack_ir},
+  {"sr",    3, rf_sr,    2, 1, 0, rf_basis_sr,   rf_unpack_expc},
+  {NULL,    0, NULL,     0, 0, 0, NULL,          NULL}
+};
+
+static inline const rf_model *rf_find_model(const char *name)
+{
+  int i;
+
+  for (i = 0; rf_models[i].name != NULL; i++) {
+    if (strcmp(rf_models[i].name, name) == 0) return &rf_models[i];
+  }
+
+  return NULL;
+}
+
+/************************************************************
+ * Solve A x = b in place for small SPD A[n x n] by Cholesky
+ * Returns 0 if A is not positive definite
+ ************************************************************/
+static inline int rf_cholsolve(double *A, double *b, int n)
+{
+  int i, j, k;
+  double s;
+
+  for (j = 0; j < n; j++) {
+    s = A[j + j*n];
+    for (k = 0; k < j; k++) s -= A[j + k*n] * A[j + k*n];
+    if (s <= 0.0) return 0;
+    A[j + j*n] = sqrt(s);
+    for (i = j+1; i < n; i++) {
+      s = A[i + j*n];
+      for (k = 0; k < j; k++) s -= A[i + k*n] * A[j + k*n];
+      A[i + j*n] = s / A[j + j*n];
+    }
+  }
+
+  /* Forward then back substitution with L and L' */
+  for (i = 0; i < n; i++) {
+    s = b[i];
+    for (k = 0; k < i; k++) s -= A[i + k*n] * b[k];
+    b[i] = s / A[i + i*n];
+  }
+  for (i = n-1; i >= 0; i--) {
+    s = b[i];
+    for (k = i+1; k < n; k++) s -= A[k + i*n] * b[k];
+    b[i] = s / A[i + i*n];
+  }
+
+  return 1;
+}
+
+static inline double rf_clamp(double x, double lo, double hi)
+{
+  return (x < lo) ? lo : ((x > hi) ? hi : x);
+}
+
+/************************************************************
+ * Sum of squared residuals s - f, residual returned in r
+ ************************************************************/
+static inline double rf_resid(const double *s, const double *f, double *r, int nt)
+{
+  double ss = 0.0;
+  int k;
+
+  for (k = 0; k < nt; k++) {
+    r[k] = s[k] - f[k];
+    ss += r[k] * r[k];
+  }
+
+  return ss;
+}
+
+/************************************************************
+ * Bounded Levenberg-Marquardt fit of model m to s[nt]
+ *
+ * p[np] holds the starting estimate on entry and the fit on
+ * exit. Steps are projected onto [lb, ub]. work must hold
+ * nt * (np + 3) doubles, and on return work + 3 nt holds the
+ * Jacobian at p (nt x np). Returns the residual sum of squares
+ * and the number of iterations in *niter.
+ ************************************************************/
+static inline double rf_lm_fit(const rf_model *m, const double *t, const double *s, int nt,
+			double *p, const double *lb, const double *ub,
+			int maxit, double tol, double *work, int *niter)
+{
+  int np = m->np;
+  double *f  = work;
+  double *r  = f + nt;
+  double *fn = r + nt;
+  double *J  = fn + nt;
+  double A[RF_MAXP * RF_MAXP], Al[RF_MAXP * RF_MAXP];
+  double g[RF_MAXP], d[RF_MAXP], pn[RF_MAXP];
+  double lambda = 1e-3;
+  double ss, ssn, dp, pp;
+  int i, j, k, it, accepted;
+
+  for (i = 0; i < np; i++) p[i] = rf_clamp(p[i], lb[i], ub[i]);
+
+  m->eval(p, t, nt, f, J);
+  ss = rf_resid(s, f, r, nt);
+
+  for (it = 0; it < maxit; it++) {
+
+    /* Normal equations J'J d = J'r */
+    for (i = 0; i < np; i++) {
+      g[i] = 0.0;
+      for (k = 0; k < nt; k++) g[i] += J[k + i*nt] * r[k];
+      for (j = 0; j <= i; j++) {
+	A[i + j*np] = 0.0;
+	for (k = 0; k < nt; k++) A[i + j*np] += J[k + i*nt] * J[k + j*nt];
+	A[j + i*np] = A[i + j*np];
+      }
+    }
+
+    accepted = 0;
+
+    while (lambda < 1e12) {
+
+      memcpy(Al, A, np * np * sizeof(double));
+      for (i = 0; i < np; i++) {
+	Al[i + i*np] += lambda * A[i + i*np] + 1e-15;
+	d[i] = g[i];
+      }
+
+      if (rf_cholsolve(Al, d, np)) {
+
+	for (i = 0; i < np; i++) pn[i] = rf_clamp(p[i] + d[i], lb[i], ub[i]);
+
+	m->eval(pn, t, nt, fn, NULL);
+	ssn = 0.0;
+	for (k = 0; k < nt; k++) ssn += (s[k] - fn[k]) * (s[k] - fn[k]);
+
+	if (ssn < ss) {
+	  accepted = 1;
+	  break;
+	}
+      }
+
+      lambda *= 10.0;
+    }
+
+    if (!accepted) break;
+
+    /* Relative parameter change for convergence test */
+    dp = 0.0; pp = 0.0;
+    for (i = 0; i < np; i++) {
+      dp += (pn[i] - p[i]) * (pn[i] - p[i]);
+      pp += p[i] * p[i];
+      p[i] = pn[i];
+    }
+
+    m->eval(p, t, nt, f, J);
+    ssn = rf_resid(s, f, r, nt);
+
+    lambda = (lambda > 1e-12) ? lambda / 10.0 : lambda;
+
+    if (sqrt(dp) <= tol * (sqrt(pp) + tol) || ss - ssn <= tol * ss) {
+      ss = ssn;
+      it++;
+      break;
+    }
+
+    ss = ssn;
+  }
+
+  *niter = it;
+
+  return ss;
+}
+
+/************************************************************
+ * Projected residual sum of squares for time constant T
+ * The linear coefficients minimising |s - B c| are returned
+ * in c. work must hold nt * nl doubles.
+ ************************************************************/
+static inline double rf_projres(const rf_model *m, double T, const double *t,
+			 const double *s, int nt, double *c, double *work)
+{
+  int nl = m->nl;
+  double *B = work;
+  double G[RF_MAXL * RF_MAXL];
+  double ss = 0.0;
+  int i, j, k;
+
+  m->basis(T, t, nt, B);
+
+  for (k = 0; k < nt; k++) ss += s[k] * s[k];
+
+  for (i = 0; i < nl; i++) {
+    c[i] = 0.0;
+    for (k = 0; k < nt; k++) c[i] += B[k + i*nt] * s[k];
+    for (j = 0; j <= i; j++) {
+      G[i + j*nl] = 0.0;
+      for (k = 0; k < nt; k++) G[i + j*nl] += B[k + i*nt] * B[k + j*nt];
+      G[j + i*nl] = G[i + j*nl];
+    }
+  }
+
+  /* Degenerate basis (eg T far beyond the sampled times) */
+  for (i = 0; i < nl; i++) G[i + i*nl] *= 1.0 + 1e-12;
+  if (!rf_cholsolve(G, c, nl)) {
+    for (i = 0; i < nl; i++) c[i] = 0.0;
+    return ss;
+  }
+
+  /* |s - B c|^2 = s's - c'B's at the least squares solution */
+  for (i = 0; i < nl; i++) {
+    double bs = 0.0;
+    for (k = 0; k < nt; k++) bs += B[k + i*nt] * s[k];
+    ss -= c[i] * bs;
+  }
+
+  return (ss > 0.0) ? ss : 0.0;
+}
+
+/************************************************************
+ * Minimise the projected residual over log T in [ulo, uhi]
+ * by Brent's method, starting from the best grid point u0
+ ************************************************************/
+static inline double rf_brent(const rf_model *m, const double *t, const double *s, int nt,
+		       double ulo, double uhi, double u0, double tol,
+		       double *c, double *work, int *niter)
+{
+  const double cg = 0.3819660112501051;
+  double a = ulo, b = uhi;
+  double x = u0, w = u0, v = u0, u;
+  double fx, fw, fv, fu;
+  double d = 0.0, e = 0.0, xm, tol1, tol2, r, q, pp, cu[RF_MAXL];
+  int it, i;
+
+  fx = fw = fv = rf_projres(m, exp(x), t, s, nt, c, work);
+
+  for (it = 0; it < 100; it++) {
+
+    xm = 0.5 * (a + b);
+    tol1 = tol * fabs(x) + 1e-10;
+    tol2 = 2.0 * tol1;
+    if (fabs(x - xm) <= tol2 - 0.5 * (b - a)) break;
+
+    if (fabs(e) > tol1) {
+
+      /* Parabolic step through x, w and v */
+      r = (x - w) * (fx - fv);
+      q = (x - v) * (fx - fw);
+      pp = (x - v) * q - (x - w) * r;
+      q = 2.0 * (q - r);
+      if (q > 0.0) pp = -pp;
+      q = fabs(q);
+      r = e;
+      e = d;
+
+      if (fabs(pp) >= fabs(0.5 * q * r) || pp <= q * (a - x) || pp >= q * (b - x)) {
+	e = (x >= xm) ? a - x : b - x;
+	d = cg * e;
+      } else {
+	d = pp / q;
+	u = x + d;
+	if (u - a < tol2 || b - u < tol2) d = (xm >= x) ? tol1 : -tol1;
+      }
+
+    } else {
+
+      /* Golden section step */
+      e = (x >= xm) ? a - x : b - x;
+      d = cg * e;
+
+    }
+
+    u = (fabs(d) >= tol1) ? x + d : x + ((d > 0.0) ? tol1 : -tol1);
+    fu = rf_projres(m, exp(u), t, s, nt, cu, work);
+
+    if (fu <= fx) {
+      if (u >= x) a = x; else b = x;
+      v = w; fv = fw;
+      w = x; fw = fx;
+      x = u; fx = fu;
+      for (i = 0; i < m->nl; i++) c[i] = cu[i];
+    } else {
+      if (u < x) a = u; else b = u;
+      if (fu <= fw || w == x) {
+	v = w; fv = fw;
+	w = u; fw = fu;
+      } else if (fu <= fv || v == x || v == w) {
+	v = u; fv = fu;
+      }
+    }
+  }
+
+  *niter += it;
+
+  return x;
+}
+
+/************************************************************
+ * Variable projection fit of model m to s[nt]
+ *
+ * The linear parameters are eliminated in closed form, so only
+ * the time constant is searched: first over a log-spaced grid
+ * spanning its bounds, then by Brent's method in the bracketing
+ * grid interval. Magnitude IR data are polarity restored about
+ * the smallest sample, trying it as the last inverted and the
+ * first recovered point. Infinite bounds on the time constant
+ * default to [1e-3, 1e3] times the longest sample time. The
+ * linear parameters are clamped to their bounds afterwards.
+ *
+ * work must hold nt * (np + 3) doubles, and on return work + 3 nt
+ * holds the Jacobian at p as for rf_lm_fit. Returns the residual
+ * sum of squares and the number of Brent iterations in *niter.
+ ************************************************************/
+static inline double rf_varpro_fit(const rf_model *m, const double *t, const double *s, int nt,
+			    double *p, const double *lb, const double *ub,
+			    double tol, double *work, int *niter)
+{
+  int iT = m->iT, np = m->np;
+  double *B  = work;
+  double *sp = B + nt * RF_MAXL;
+  double c[RF_MAXL], cbest[RF_MAXL];
+  double tmax = 0.0, Tlo, Thi, ulo, uhi, du, u, ubest = 0.0, ss, ssbest;
+  double tnull = 0.0, amin;
+  int k, g, gbest, npol, pol, i;
+
+  for (k = 0; k < nt; k++) if (fabs(t[k]) > tmax) tmax = fabs(t[k]);
+  if (tmax <= 0.0) tmax = 1.0;
+
+  Tlo = (lb[iT] > RF_TMIN) ? lb[iT] : RF_TMIN;
+  Thi = ub[iT];
+  if (Tlo < 1e-3 * tmax && lb[iT] <= 0.0) Tlo = 1e-3 * tmax;
+  if (Thi > 1e3 * tmax) Thi = 1e3 * tmax;
+  if (Thi <= Tlo) Thi = Tlo * 10.0;
+
+  ulo = log(Tlo);
+  uhi = log(Thi);
+  du = (uhi - ulo) / (RF_NGRID - 1);
+
+  /* Smallest magnitude sample is nearest the IR null */
+  if (m->polarity) {
+    amin = fabs(s[0]);
+    tnull = t[0];
+    for (k = 1; k < nt; k++) {
+      if (fabs(s[k]) < amin) { amin = fabs(s[k]); tnull = t[k]; }
+    }
+  }
+  npol = m->polarity ? 2 : 1;
+
+  ssbest = -1.0;
+  *niter = 0;
+
+  for (pol = 0; pol < npol; pol++) {
+
+    /* Invert samples before (pol = 0) or up to (pol = 1) the null */
+    for (k = 0; k < nt; k++) {
+      if (m->polarity && (t[k] < tnull || (pol == 1 && t[k] == tnull))) {
+	sp[k] = -fabs(s[k]);
+      } else {
+	sp[k] = m->polarity ? fabs(s[k]) : s[k];
+      }
+    }
+
+    gbest = 0;
+    ss = -1.0;
+    for (g = 0; g < RF_NGRID; g++) {
+      double sg = rf_projres(m, exp(ulo + g * du), t, sp, nt, c, B);
+      if (ss < 0.0 || sg < ss) { ss = sg; gbest = g; }
+    }
+
+    u = ulo + gbest * du;
+    u = rf_brent(m, t, sp, nt,
+		 (gbest > 0) ? u - du : ulo, (gbest < RF_NGRID-1) ? u + du : uhi,
+		 u, tol, c, B, niter);
+    ss = rf_projres(m, exp(u), t, sp, nt, c, B);
+
+    if (ssbest < 0.0 || ss < ssbest) {
+      ssbest = ss;
+      ubest = u;
+      for (i = 0; i < m->nl; i++) cbest[i] = c[i];
+    }
+  }
+
+  m->unpack(cbest, exp(ubest), p);
+  for (i = 0; i < np; i++) p[i] = rf_clamp(p[i], lb[i], ub[i]);
+
+  /* Residual and Jacobian of the clamped parameters against the data */
+  m->eval(p, t, nt, B, B + 3 * nt);
+  ss = 0.0;
+  for (k = 0; k < nt; k++) ss += (s[k] - B[k]) * (s[k] - B[k]);
+
+  return ss;
+}
+
+/************************************************************
+ * Cramer-Rao variances of the fitted parameters from the
+ * Jacobian J (nt x np) at convergence
+ *
+ *   var = s2 diag((J'J)^-1), s2 = ss / (nt - np)
+ *
+ * with the noise variance s2 estimated from the residual sum of
+ * squares. NaN where J'J is singular or nt <= np.
+ ************************************************************/
+static inline void rf_crlb(const double *J, int nt, int np, double ss, double *var)
+{
+  double A[RF_MAXP * RF_MAXP], L[RF_MAXP * RF_MAXP], e[RF_MAXP];
+  double s2 = (nt > np) ? ss / (nt - np) : NAN;
+  int i, j, k;
+
+  for (i = 0; i < np; i++) {
+    for (j = 0; j <= i; j++) {
+      A[i + j*np] = 0.0;
+      for (k = 0; k < nt; k++) A[i + j*np] += J[k + i*nt] * J[k + j*nt];
+      A[j + i*np] = A[i + j*np];
+    }
+  }
+
+  /* Diagonal of the inverse, one column at a time */
+  for (i = 0; i < np; i++) {
+    memcpy(L, A, np * np * sizeof(double));
+    for (j = 0; j < np; j++) e[j] = (j == i) ? 1.0 : 0.0;
+    if (!rf_cholsolve(L, e, np)) {
+      for (j = 0; j < np; j++) var[j] = NAN;
+      return;
+    }
+    var[i] = s2 * e[i];
+  }
+}
+
+#endif /* RELAXFIT_H */
@@ -0,0 +1,245 @@
+/************************************************************
+ * C source for relaxfit_mex MEX object
+ *
+ * SYNTAX: [P, resnorm, niter, V] = relaxfit_mex(model, t, S, P0, lb, ub)
+ *         [P, resnorm, niter, V] = relaxfit_mex(model, t, S, P0, lb, ub, maxit, tol, nthreads, method)
+ *
+ * Voxelwise nonlinear least squares fit of a relaxation model
+ * to every row of S. Each voxel is fitted independently by
+ * bounded Levenberg-Marquardt with analytic Jacobians, and the
+ * voxels are distributed over POSIX threads.
+ *
+ * With method 'varpro' the linear parameters (amplitudes and
+ * offsets) are solved in closed form and only the time constant
+ * is searched, so no starting estimates are needed and P0 may be
+ * empty.
+ *
+ * model    = 'exp', 'expc', 'ir', 'absir' or 'sr' (see relaxfit.h)
+ * t        = sample times (1 x nt)
+ * S        = signal, one voxel per row (nvox x nt)
+ * P0       = starting estimates, one voxel per row (nvox x np)
+ * lb, ub   = parameter bounds (1 x np)
+ * maxit    = maximum LM iterations per voxel [100]
+ * tol      = relative parameter and residual tolerance [1e-6]
+ * nthreads = number of threads, 0 for all processors [0]
+ * method   = 'lm' or 'varpro' ['lm']
+ *
+ * P        = fitted parameters (nvox x np)
+ * resnorm  = residual sum of squares (nvox x 1)
+ * niter    = LM or Brent iterations used (nvox x 1)
+ * V        = Cramer-Rao parameter variances (nvox x np), optional
+ *            s2 diag(inv(J'J)) from the Jacobian J at convergence,
+ *            with noise variance s2 = resnorm / (nt - np)
+ *
+ * BUILD  : mex relaxfit_mex.c (link -lpthread where libc does not include it)
+ *
+ * AUTHOR : Mike Tyszka, Ph.D.
+ * PLACE  : Caltech BIC
+ * DATES  : 10/19/2026 JMT From scratch
+ *          10/19/2026 JMT Add varpro method
+ *          10/19/2026 JMT Optional Cramer-Rao variance output
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Mike Tyszka
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ *   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ *   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ *   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ *   Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ *   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ *   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ************************************************************/
+
+#include <stdlib.h>
+#include <math.h>
+#include "mex.h"
+
+#include "relaxfit.h"
+#include "voxthreads.h"
+
+/* Input Arguments */
+
+#define	MODEL_IN    prhs[0]
+#define	t_IN        prhs[1]
+#define	S_IN        prhs[2]
+#define	P0_IN       prhs[3]
+#define	LB_IN       prhs[4]
+#define	UB_IN       prhs[5]
+#define	MAXIT_IN    prhs[6]
+#define	TOL_IN      prhs[7]
+#define	NTHREADS_IN prhs[8]
+#define	METHOD_IN   prhs[9]
+
+/* Output Arguments */
+
+#define	P_OUT       plhs[0]
+#define	RESNORM_OUT plhs[1]
+#define	NITER_OUT   plhs[2]
+#define	V_OUT       plhs[3]
+
+/* Shared fitting context, read-only except for the output rows */
+typedef struct {
+  const rf_model *m;
+  const double *t;
+  const double *S;
+  const double *P0;
+  const double *lb;
+  const double *ub;
+  double *P;
+  double *resnorm;
+  double *niter;
+  double *var;
+  int nvox;
+  int nt;
+  int maxit;
+  double tol;
+  int varpro;
+  double *work[VOX_MAXTHREADS];
+} rf_context;
+
+static void rf_worker(void *, int, int, int);
+
+/************************************************************
+ * Entry point for MEX call
+ ************************************************************/
+void mexFunction(int nlhs, mxArray *plhs[],
+		 int nrhs, const mxArray *prhs[])
+{
+  rf_context ctx;
+  char name[16], method[16];
+  int np, nthreads, n, ok;
+  size_t nwork;
+
+  /* Check for proper number of arguments */
+
+  if (nrhs < 6 || nrhs > 10 || nlhs > 4) {
+    mexErrMsgTxt("SYNTAX: [P,resnorm,niter,V] = relaxfit_mex(model,t,S,P0,lb,ub[,maxit,tol,nthreads,method])");
+  }
+
+  if (!mxIsChar(MODEL_IN) || mxGetString(MODEL_IN, name, sizeof(name)) != 0)
+    mexErrMsgTxt("relaxfit_mex : model must be a string");
+
+  ctx.m = rf_find_model(name);
+  if (ctx.m == NULL)
+    mexErrMsgTxt("relaxfit_mex : unknown model");
+
+  ctx.varpro = 0;
+  if (nrhs > 9) {
+    if (!mxIsChar(METHOD_IN) || mxGetString(METHOD_IN, method, sizeof(method)) != 0)
+      mexErrMsgTxt("relaxfit_mex : method must be a string");
+    if (strcmp(method, "varpro") == 0) {
+      ctx.varpro = 1;
+    } else if (strcmp(method, "lm") != 0) {
+      mexErrMsgTxt("relaxfit_mex : method must be 'lm' or 'varpro'");
+    }
+  }
+
+  if (!mxIsDouble(S_IN) || mxIsComplex(S_IN) || !mxIsDouble(P0_IN) || !mxIsDouble(t_IN))
+    mexErrMsgTxt("relaxfit_mex : t, S and P0 must be real double");
+
+  np = ctx.m->np;
+  ctx.nt = (int)mxGetNumberOfElements(t_IN);
+  ctx.nvox = (int)mxGetM(S_IN);
+
+  if ((int)mxGetN(S_IN) != ctx.nt)
+    mexErrMsgTxt("relaxfit_mex : S must have one column per sample time");
+
+  if (!(ctx.varpro && mxIsEmpty(P0_IN)) &&
+      ((int)mxGetM(P0_IN) != ctx.nvox || (int)mxGetN(P0_IN) != np))
+    mexErrMsgTxt("relaxfit_mex : P0 must be nvox x np");
+
+  if ((int)mxGetNumberOfElements(LB_IN) != np || (int)mxGetNumberOfElements(UB_IN) != np)
+    mexErrMsgTxt("relaxfit_mex : lb and ub must have np elements");
+
+  ctx.t = mxGetPr(t_IN);
+  ctx.S = mxGetPr(S_IN);
+  ctx.P0 = mxIsEmpty(P0_IN) ? NULL : mxGetPr(P0_IN);
+  ctx.lb = mxGetPr(LB_IN);
+  ctx.ub = mxGetPr(UB_IN);
+
+  ctx.maxit = (nrhs > 6) ? (int)mxGetScalar(MAXIT_IN) : 100;
+  ctx.tol = (nrhs > 7) ? mxGetScalar(TOL_IN) : 1e-6;
+  nthreads = vox_nthreads((nrhs > 8) ? (int)mxGetScalar(NTHREADS_IN) : 0);
+
+  P_OUT = mxCreateDoubleMatrix(ctx.nvox, np, mxREAL);
+  RESNORM_OUT = mxCreateDoubleMatrix(ctx.nvox, 1, mxREAL);
+  NITER_OUT = mxCreateDoubleMatrix(ctx.nvox, 1, mxREAL);
+
+  ctx.P = mxGetPr(P_OUT);
+  ctx.resnorm = mxGetPr(RESNORM_OUT);
+  ctx.niter = mxGetPr(NITER_OUT);
+
+  /* Variances only when requested */
+  ctx.var = NULL;
+  if (nlhs > 3) {
+    V_OUT = mxCreateDoubleMatrix(ctx.nvox, np, mxREAL);
+    ctx.var = mxGetPr(V_OUT);
+  }
+
+  if (ctx.nvox < 1 || ctx.nt < 1) return;
+
+  /* Fewer threads than chunks is pointless */
+  if (nthreads > (ctx.nvox + VOX_MINCHUNK - 1) / VOX_MINCHUNK)
+    nthreads = (ctx.nvox + VOX_MINCHUNK - 1) / VOX_MINCHUNK;
+
+  /* Per-thread workspace: signal, model, residual, trial and Jacobian */
+  nwork = (size_t)ctx.nt * (np + 4);
+  ok = 1;
+  for (n = 0; n < nthreads; n++) {
+    ctx.work[n] = (double *)malloc(nwork * sizeof(double));
+    if (ctx.work[n] == NULL) ok = 0;
+  }
+
+  if (ok) vox_parallel(ctx.nvox, nthreads, rf_worker, &ctx);
+
+  for (n = 0; n < nthreads; n++) free(ctx.work[n]);
+
+  if (!ok) mexErrMsgTxt("relaxfit_mex : out of memory");
+
+  return;
+}
+
+/************************************************************
+ * Fit voxels [v0, v1) on thread tid
+ ************************************************************/
+static void rf_worker(void *arg, int v0, int v1, int tid)
+{
+  rf_context *ctx = (rf_context *)arg;
+  int np = ctx->m->np;
+  int nt = ctx->nt;
+  int nvox = ctx->nvox;
+  double *s = ctx->work[tid];
+  double p[RF_MAXP], var[RF_MAXP];
+  int v, k, i, it;
+
+  for (v = v0; v < v1; v++) {
+
+    /* Gather this voxel's samples from the column-major S */
+    for (k = 0; k < nt; k++) s[k] = ctx->S[v + k * nvox];
+
+    if (ctx->varpro) {
+      ctx->resnorm[v] = rf_varpro_fit(ctx->m, ctx->t, s, nt, p, ctx->lb, ctx->ub,
+				      ctx->tol, s + nt, &it);
+    } else {
+      for (i = 0; i < np; i++) p[i] = ctx->P0[v + i * nvox];
+      ctx->resnorm[v] = rf_lm_fit(ctx->m, ctx->t, s, nt, p, ctx->lb, ctx->ub,
+				  ctx->maxit, ctx->tol, s + nt, &it);
+    }
+    ctx->niter[v] = it;
+
+    for (i = 0; i < np; i++) ctx->P[v + i * nvox] = p[i];
+
+    /* Jacobian at the fit is left after signal, model and residuals */
+    if (ctx->var) {
+      rf_crlb(s + 4 * nt, nt, np, ctx->resnorm[v], var);
+      for (i = 0; i < np; i++) ctx->var[v + i * nvox] = var[i];
+    }
+  }
+}
@@ -0,0 +1,190 @@
+function P0 = relaxinit(model, t, S, lb, ub)
+% P0 = relaxinit(model, t, S, lb, ub)
+%
+% Closed form starting estimates for the RelaxFit models, computed for
+% every row of S in a single vectorized pass ahead of nonlinear
+% refinement by relaxfit_mex or lsqcurvefit.
+%
+% The time constant comes from
+%   exp         : log-linear regression weighted by S^2
+%   expc, ir, sr: three point analytic solution of S = a + b exp(-t/T)
+%                 from the first, last and interpolated mid-range samples
+%   absir       : the null point, T1 = TI(min |S|) / ln 2
+% and the amplitudes and offset from linear least squares against all
+% samples for that time constant (with polarity restoration for absir).
+%
+% ARGS:
+% model = 'exp', 'expc', 'ir', 'absir' or 'sr' (see varprofitn)
+% t     = sample times (1 x nt)
+% S     = signal, one voxel per row (nvox x nt)
+% lb,ub = optional parameter bounds to clamp the estimates (1 x np)
+%
+% RETURNS:
+% P0    = starting parameters (nvox x np)
+%
+% AUTHOR : Mike Tyszka, Ph.D.
+% PLACE  : Caltech BIC
+% DATES  : 10/19/2026 JMT From scratch
+%
+% The MIT License (MIT)
+%
+% Copyright (c) 2016 Mike Tyszka
+%
+%   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+%   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+%   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+%   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+%
+%   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+%   Software.
+%
+%   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+%   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+%   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+%   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+% Work in ascending sample time
+[t, order] = sort(t(:)');
+S = double(S(:,order));
+[nvox, nt] = size(S);
+
+% Time constants are kept within a sensible range of the sampling
+trange = max(t(nt) - t(1), eps);
+Tmin = 1e-3 * trange;
+Tmax = 1e3 * trange;
+
+switch model
+
+  case 'exp'
+
+    % Weighted log-linear regression, skipping non-positive samples
+    W = (S.^2) .* (S > 0);
+    y = log(max(S, realmin));
+    tt = repmat(t, nvox, 1);
+    sw = sum(W, 2);
+    st = sum(W .* tt, 2);
+    stt = sum(W .* tt.^2, 2);
+    sy = sum(W .* y, 2);
+    sty = sum(W .* tt .* y, 2);
+    slope = (sw .* sty - st .* sy) ./ (sw .* stt - st.^2);
+    T = -1 ./ slope;
+    T(~(T > 0)) = Tmax;
+
+    T = min(max(T, Tmin), Tmax);
+    c = init_lin(model, T, t, S);
+    P0 = [c(:,1) T];
+
+  case {'expc', 'ir', 'sr'}
+
+    T = init_3pt(t, S);
+
+    T = min(max(T, Tmin), Tmax);
+    c = init_lin(model, T, t, S);
+    switch model
+      case 'expc'
+        P0 = [c(:,2) T c(:,1)];
+      case 'ir'
+        P0 = [c(:,1) init_alpha(c) T];
+      case 'sr'
+        P0 = [-c(:,2) T c(:,1) + c(:,2)];
+    end
+
+  case 'absir'
+
+    % Null point for complete inversion
+    S = abs(S);
+    [smin, imin] = min(S, [], 2);
+    tnull = reshape(t(imin), [nvox 1]);
+    T = tnull / log(2);
+    T(~(T > 0)) = trange / log(2);
+    T = min(max(T, Tmin), Tmax);
+
+    % Restore polarity with the null sample taken as either sign
+    before = bsxfun(@lt, t, tnull);
+    upto = bsxfun(@le, t, tnull);
+    Sa = S; Sa(before) = -S(before);
+    Sb = S; Sb(upto) = -S(upto);
+    [ca, ssa] = init_lin('ir', T, t, Sa);
+    [cb, ssb] = init_lin('ir', T, t, Sb);
+    useb = ssb < ssa;
+    c = ca;
+    c(useb,:) = cb(useb,:);
+
+    P0 = [abs(c(:,1)) init_alpha(c) T];
+
+  otherwise
+
+    error('relaxinit : unknown model %s', model);
+
+end
+
+% Clamp to any supplied bounds
+np = size(P0, 2);
+if nargin > 3 && ~isempty(lb) P0 = max(P0, repmat(lb(1:np), nvox, 1)); end
+if nargin > 4 && ~isempty(ub) P0 = min(P0, repmat(ub(1:np), nvox, 1)); end
+
+%------------------------------------------------------------
+% Three point solution for T in S = a + b exp(-t/T) using the
+% first, last and mid-range samples (interpolated if needed)
+%------------------------------------------------------------
+function T = init_3pt(t, S)
+
+nt = length(t);
+
+if nt < 3
+  T = (t(nt) - t(1)) * ones(size(S,1), 1);
+  return
+end
+
+tm = (t(1) + t(nt)) / 2;
+k = min(find(t <= tm, 1, 'last'), nt-1);
+w = (tm - t(k)) / (t(k+1) - t(k));
+
+S1 = S(:,1);
+S2 = (1 - w) * S(:,k) + w * S(:,k+1);
+S3 = S(:,nt);
+
+% Ratio of successive differences is exp(-dt/T) for equal spacing
+r = (S2 - S3) ./ (S1 - S2);
+r(isnan(r)) = 0.5;
+r = min(max(r, 1e-3), 1 - 1e-3);
+
+T = -(tm - t(1)) ./ log(r);
+
+%------------------------------------------------------------
+% Linear coefficients for fixed per-voxel T by closed form
+% normal equations. Returns c = [a b] for the model basis and
+% the residual sum of squares
+%------------------------------------------------------------
+function [c, ss] = init_lin(model, T, t, S)
+
+E = exp(-bsxfun(@rdivide, t, T));
+nvox = size(S,1);
+
+if strcmp(model, 'exp')
+  g11 = sum(E.^2, 2);
+  b1 = sum(E .* S, 2);
+  c = [b1 ./ (g11 + eps) zeros(nvox,1)];
+  ss = sum(S.^2, 2) - c(:,1) .* b1;
+  return
+end
+
+% S = a + b E for expc, ir and sr
+g11 = size(S,2);
+g12 = sum(E, 2);
+g22 = sum(E.^2, 2);
+b1 = sum(S, 2);
+b2 = sum(E .* S, 2);
+d = g11 .* g22 - g12.^2;
+d(abs(d) < eps * g11 .* g22) = Inf;
+c = [(g22 .* b1 - g12 .* b2) ./ d (g11 .* b2 - g12 .* b1) ./ d];
+ss = sum(S.^2, 2) - c(:,1) .* b1 - c(:,2) .* b2;
+
+%------------------------------------------------------------
+% Inversion efficiency alpha from S = M0 + M0 (alpha - 1) E
+%------------------------------------------------------------
+function alpha = init_alpha(c)
+
+alpha = -ones(size(c,1), 1);
+nz = c(:,1) ~= 0;
+alpha(nz) = 1 + c(nz,2) ./ c(nz,1);
@@ -0,0 +1,63 @@
+function Q = relaxstats(Mask, V, resnorm, niter, pscale, sscale)
+% Q = relaxstats(Mask, V, resnorm, niter, pscale, sscale)
+%
+% Pack per-voxel fit statistics from relaxfit_mex into N-D maps
+% matching the parameter maps of the voxelwise fitters. Unfitted
+% voxels are NaN in the variance and zero in the other maps.
+%
+% ARGS:
+% Mask    = N-D fit mask
+% V       = Cramer-Rao parameter variances for mask voxels (nmask x np)
+% resnorm = residual sum of squares for mask voxels (nmask x 1)
+% niter   = iterations used for mask voxels (nmask x 1)
+% pscale  = optional parameter scale factors undoing any data
+%           normalization (1 x np) [1]
+% sscale  = optional signal scale factor [1]
+%
+% RETURNS:
+% Q = structure with fields
+%   var     = parameter variance maps (N-D with np in the final dimension)
+%   sd      = parameter standard deviation maps (sqrt of var)
+%   resnorm = residual sum of squares map
+%   niter   = iteration count map
+%
+% AUTHOR : Mike Tyszka, Ph.D.
+% PLACE  : Caltech BIC
+% DATES  : 10/19/2026 JMT From scratch
+%
+% The MIT License (MIT)
+%
+% Copyright (c) 2016 Mike Tyszka
+%
+%   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+%   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+%   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+%   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+%
+%   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+%   Software.
+%
+%   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+%   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+%   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+%   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+np = size(V,2);
+if nargin < 5 || isempty(pscale) pscale = ones(1,np); end
+if nargin < 6 sscale = 1; end
+
+vdims = size(Mask);
+nvox = numel(Mask);
+Mask = Mask(:) ~= 0;
+
+var = NaN * ones(nvox, np);
+var(Mask,:) = V .* repmat(pscale(:)'.^2, size(V,1), 1);
+
+Q.var = reshape(var, [vdims np]);
+Q.sd = sqrt(Q.var);
+
+Q.resnorm = zeros(vdims);
+Q.resnorm(Mask) = resnorm * sscale^2;
+
+Q.niter = zeros(vdims);
+Q.niter(Mask) = niter;
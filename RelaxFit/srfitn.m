@@ -1,5 +1,5 @@
-function [S0, T1, C, Mask] = srfitn(TR, SR, verbose)
-% [S0, T1, C, Mask] = srfitn(TR, SR)
+function [S0, T1, C, Mask, Q] = srfitn(TR, SR, verbose, method, mask)
+% [S0, T1, C, Mask, Q] = srfitn(TR, SR, verbose, method, mask)
 %
 % Fit the SR contrast equation:
 %
@@ -10,17 +10,29 @@ function [S0, T1, C, Mask] = srfitn(TR, SR, verbose)
 % ARGS:
 % SR = N-D matrix with repetition time as final dimension
 % TR = Repetition times for each dataset (ms)
+% method = 'lsq' or 'varpro' (S0 and C solved in closed form, T1 searched) ['lsq']
+% mask = fit mask replacing the relative threshold, eg a global mask
+%        from streamfitn [10% of the maximum at the longest TR]
 %
 % RETURNS:
 % S0 = S(TR=Inf) matrix
 % T1 = T1 matrix (ms)
+% C  = baseline offset
 % Mask = fit mask used to reduce voxel count
+% Q    = Cramer-Rao variance, residual and iteration maps from relaxfit_mex
+%        (see relaxstats), parameters ordered [S0 T1 C]. Empty without the MEX
 % verbose = verbosity flag (0 = none, 1 = text only, 2 = text and graphs)
 %
 % AUTHOR : Mike Tyszka, Ph.D.
 % PLACE  : Caltech BIC
 % DATES  : 09/06/2001 JMT Adapt from srfit.m
 %          11/03/2004 JMT Add verbosity arg
+%          10/19/2026 JMT Use threaded relaxfit_mex when compiled
+%          10/19/2026 JMT Add varpro method
+%          10/19/2026 JMT Vectorized three point initial estimates
+%          10/19/2026 JMT Throttled progress reports with stage timing
+%          10/19/2026 JMT Return Cramer-Rao variance and fit quality maps
+%          10/19/2026 JMT Restore data scaling of S0 and C, optional fit mask
 %
 % The MIT License (MIT)
 %
@@ -41,6 +53,8 @@ function [S0, T1, C, Mask] = srfitn(TR, SR, verbose)
 
 % Default args
 if nargin < 3 verbose = 0; end
+if nargin < 4 method = 'lsq'; end
+if nargin < 5 mask = []; end
 
 % Get dimensions
 dims = size(SR);
@@ -54,6 +68,8 @@ S0 = [];
 T1 = [];
 C  = [];
 Mask = [];
+Q = [];
+V = [];
 
 % Check that enough TR values were provided
 if ~isequal(ntr1, ntr2)
@@ -63,8 +79,15 @@ else
   nt = ntr1;
 end
 
+% Check that a supplied mask matches the voxel count
+if numel(mask) > 0 && numel(mask) ~= nvox
+  fprintf('Mask does not match the spatial dimensions of the data\n');
+  return
+end
+
 % Normalize maximum SR data to 1.0
-SR = SR / max(SR(:));
+sf = max(SR(:));
+SR = SR / sf;
 
 % Reshape and make space for results
 SR = reshape(SR, [nvox nt]);
@@ -72,14 +95,28 @@ S0 = zeros(nvox,1);
 T1 = zeros(nvox,1);
 C  = zeros(nvox,1);
 
-% Create a mask from the image with the greatest TR
-[maxTR, tmax] = max(TR(:));
-maxSR = SR(:,tmax);
-SRthresh = max(maxSR(:)) * 0.1;
-Mask = maxSR > SRthresh;
+% Create a mask from the image with the greatest TR unless one was supplied
+if isempty(mask)
+  [maxTR, tmax] = max(TR(:));
+  maxSR = SR(:,tmax);
+  SRthresh = max(maxSR(:)) * 0.1;
+  Mask = maxSR > SRthresh;
+else
+  Mask = logical(mask(:));
+end
 
 nmask = sum(Mask);
 
+pr = fitprogress('start', 'srfitn', nmask, verbose > 0);
+
+% Three point closed form initial estimates for all mask voxels
+if ~strcmp(method, 'varpro')
+  pr = fitprogress('stage', pr, 'init');
+  P0 = relaxinit('sr', TR, SR(Mask,:));
+end
+
+pr = fitprogress('stage', pr, 'fit');
+
 % Setup optimization options
 options = optimset('lsqcurvefit');
 options = optimset(options,...
@@ -89,62 +126,78 @@ options = optimset(options,...
   'Display','off');
 mode = 'unconstrained';
 
-%
-% Fit SR equation to each voxel in turn
-%
+% Variable projection, threaded relaxfit_mex or per-voxel lsqcurvefit
+if strcmp(method, 'varpro')
+
+  % Variable projection needs no initial estimates
+  [P, resnorm, niter, V] = varprofitn('sr', TR, SR(Mask,:), [-Inf 0 -Inf], [Inf Inf Inf]);
 
-fprintf('\n');
-fprintf('-------------------\n');
-fprintf('Start curve fitting\n');
-fprintf('-------------------\n');
-fprintf('\n');
+  S0(Mask) = P(:,1);
+  T1(Mask) = P(:,2);
+  C(Mask)  = P(:,3);
 
-% Start clock
-t0 = clock;
+elseif exist('relaxfit_mex','file') == 3
 
-% Update interval in voxels
-dv = round(nmask / 100);
+  [P, resnorm, niter, V] = relaxfit_mex('sr', TR(:)', double(SR(Mask,:)), P0, [-Inf -Inf -Inf], [Inf Inf Inf]);
 
-for v = 1:nvox
-  
-  if Mask(v)
+  S0(Mask) = P(:,1);
+  T1(Mask) = P(:,2);
+  C(Mask)  = P(:,3);
+
+  if verbose > 0
+    fprintf('srfitn : %0.1f iterations/voxel\n', mean(niter));
+  end
+
+else
+
+  %
+  % Fit SR equation to each mask voxel in turn
+  %
+
+  vm = find(Mask);
+
+  for count = 1:nmask
+
+    v = vm(count);
 
     %---------------------------------------------------
     % Fit SR T1 relaxation curve for single voxel time-course
     %---------------------------------------------------
-    
+
     SRv = SR(v,:);
-    
-    [S0(v), T1(v), C(v), s_fit] = srfit(TR,SRv,mode,options);
-
-    % Update waitbar progressand display results
-    if (mod(v,dv) == 0)
- 
-      fp = v/(nvox+eps);
-      vps = v/(etime(clock,t0)+eps);
-      res_str = sprintf('%5.1f%% done %0.3f vox/s : S0 = %0.3f T1 = %0.3fms C = %0.3f', fp*100,vps,S0(v),T1(v),C(v));
-      
-      switch verbose
-        case 1
-          disp(res_str);
-        case 2
-          figure(1); clf;
-          plot(TR, SRv, 'o', TR, s_fit);
-          set(gca,'YLim',[0 max(SRv(:)) * 1.1]);
-          title(res_str);
-          drawnow;
-        otherwise
-          % Do nothing
+
+    [S0(v), T1(v), C(v), s_fit] = srfit(TR,SRv,mode,options,P0(count,:));
+
+    % Throttled progress report and display results
+    if count >= pr.next
+
+      res_str = sprintf('S0 = %0.3f T1 = %0.3fms C = %0.3f', S0(v),T1(v),C(v));
+      pr = fitprogress('update', pr, count, res_str);
+
+      if verbose == 2 && pr.reported
+        figure(1); clf;
+        plot(TR, SRv, 'o', TR, s_fit);
+        set(gca,'YLim',[0 max(SRv(:)) * 1.1]);
+        title(res_str);
+        drawnow;
       end
 
     end
 
   end
+
 end
 
+fitprogress('done', pr);
+
 % Reshape maps back to Ndims-1
 vdims = dims(1:(ndims-1));
-S0 = reshape(S0, vdims);
+S0 = reshape(S0, vdims) * sf; % Restore scaling
 T1 = reshape(T1, vdims);
-C  = reshape(C, vdims);
+C  = reshape(C, vdims) * sf; % Restore scaling
 Mask = reshape(Mask, vdims);
+
+% Cramer-Rao variance, residual and iteration maps from the native fit
+if ~isempty(V)
+  Q = relaxstats(Mask, V, resnorm, niter, [sf 1 sf], sf);
+end
@@ -0,0 +1,364 @@
+function outnames = streamfitn(src, fitfn, names, outstem, opts)
+% outnames = streamfitn(src, fitfn, names, outstem, opts)
+%
+% Out-of-core voxelwise fitting of a 4D dataset too large to hold in
+% memory. The source is read in slabs of whole slices with all time
+% points, each slab is passed to an N-D fitting function such as
+% adcfitn or t2fitn, and the returned maps are appended slab by slab
+% to NIfTI-1 files. Peak memory depends on the slab size only.
+%
+% Left to themselves the fitters threshold each slab relative to its
+% own maximum, so the mask would change from slab to slab. Instead a
+% first pass thresholds one frame against its whole-volume maximum, and
+% each slab of that global mask is passed to fitfn as a second
+% argument. Every slab is then fitted over the same mask as a whole-
+% volume fit given that mask. The fitters return maps in data units:
+% t2fitn and srfitn undo their internal normalization. Maps therefore
+% keep one scale across slabs, apart from differences within the fit
+% tolerance. A handle taking only S falls back to each fitter's
+% per-slab threshold, and the global mask is applied to its maps. That
+% can only remove voxels: any voxel a slab drops by its own threshold
+% stays zero. When a background thread pool is available (MATLAB
+% R2021b+), the next slab is read while the current one is fitted.
+%
+% ARGS:
+% src     = uncompressed or gzipped NIfTI-1 file (.nii, .nii.gz), or
+%           Paravision scan directory containing pdata/1/2dseq
+% fitfn   = function handle returning maps for a slab S [nx ny nslab nt]
+%           and its global mask M [nx ny nslab]
+%           eg @(S, M) adcfitn(b, S, 0, M) or @(S, M) t2fitn(TE, S, 0, [], [], [], 'lsq', M)
+% names   = cell array of output map names, one per fitfn output
+%           eg {'ADC', 'S0', 'Mask'}
+% outstem = output path stem, maps written to <outstem>_<name>.nii
+% opts    = optional structure with fields:
+%   maxmem    = approximate slab memory budget in bytes [256e6]
+%   copies    = working copies of a slab made by fitfn [4]
+%   maskframe = frame used for the global mask [1]
+%   thresh    = global mask threshold relative to maskframe maximum [0.1]
+%   prefetch  = read the next slab in the background when possible [1]
+%   verbose   = progress reports with read, fit and write timing [1]
+%
+% RETURNS:
+% outnames = cell array of output map filenames
+%
+% 2dseq data are streamed in stored order, so the maps of transposed
+% reconstructions (RECO_transposition ~= 0) are not transposed back.
+%
+% AUTHOR : Mike Tyszka, Ph.D.
+% PLACE  : Caltech BIC
+% DATES  : 10/19/2026 JMT From scratch
+%          10/19/2026 JMT Pass the global mask to the fitter
+%
+% The MIT License (MIT)
+%
+% Copyright (c) 2016 Mike Tyszka
+%
+%   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+%   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+%   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+%   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+%
+%   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+%   Software.
+%
+%   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+%   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+%   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+%   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+% Default options
+if nargin < 5 opts = struct(); end
+if ~isfield(opts, 'maxmem') opts.maxmem = 256e6; end
+if ~isfield(opts, 'copies') opts.copies = 4; end
+if ~isfield(opts, 'maskframe') opts.maskframe = 1; end
+if ~isfield(opts, 'thresh') opts.thresh = 0.1; end
+if ~isfield(opts, 'prefetch') opts.prefetch = 1; end
+if ~isfield(opts, 'verbose') opts.verbose = 1; end
+
+% Open the source description (no voxel data read yet)
+s = src_open(src);
+nx = s.dims(1); ny = s.dims(2); nz = s.dims(3); nt = s.dims(4);
+
+% Slices per slab within the memory budget
+nslab = floor(opts.maxmem / (nx * ny * nt * 8 * opts.copies));
+nslab = max(1, min(nslab, nz));
+
+% Global mask threshold from one frame, read slab by slab
+fmax = -Inf;
+for z0 = 1:nslab:nz
+  z1 = min(z0 + nslab - 1, nz);
+  f = src_read(s, z0, z1, opts.maskframe);
+  fmax = max(fmax, max(f(:)));
+end
+mthresh = fmax * opts.thresh;
+
+% Open output maps and write headers
+nout = length(names);
+outnames = cell(1, nout);
+fd = zeros(1, nout);
+for m = 1:nout
+  outnames{m} = sprintf('%s_%s.nii', outstem, names{m});
+  fd(m) = nii_create(outnames{m}, [nx ny nz], s.pixdim);
+end
+
+% Background reader if available
+pool = [];
+if opts.prefetch
+  try
+    pool = backgroundPool;
+  catch
+    pool = [];
+  end
+end
+
+zstart = 1:nslab:nz;
+nslabs = length(zstart);
+
+% Fitters taking a mask get the global mask for each slab
+pass_mask = nargin(fitfn) ~= 1;
+
+pr = fitprogress('start', 'streamfitn', nz, opts.verbose > 0);
+
+if ~isempty(pool)
+  F = parfeval(pool, @src_read, 1, s, 1, min(nslab, nz), 1:nt);
+end
+
+for k = 1:nslabs
+
+  z0 = zstart(k);
+  z1 = min(z0 + nslab - 1, nz);
+
+  % Current slab, then start reading the next one
+  pr = fitprogress('stage', pr, 'read');
+  if ~isempty(pool)
+    S = fetchOutputs(F);
+    if k < nslabs
+      F = parfeval(pool, @src_read, 1, s, zstart(k+1), min(zstart(k+1) + nslab - 1, nz), 1:nt);
+    end
+  else
+    S = src_read(s, z0, z1, 1:nt);
+  end
+
+  Mask = S(:,:,:,opts.maskframe) > mthresh;
+
+  % Fit slab
+  pr = fitprogress('stage', pr, 'fit');
+  maps = cell(1, nout);
+  if pass_mask
+    [maps{:}] = fitfn(S, Mask);
+  else
+    [maps{:}] = fitfn(S);
+  end
+  clear S
+
+  % Append masked maps to the output files
+  pr = fitprogress('stage', pr, 'write');
+  for m = 1:nout
+    map = double(maps{m});
+    if isempty(map)
+      map = zeros(nx, ny, z1 - z0 + 1);
+    end
+    map = reshape(map, [nx ny z1 - z0 + 1]);
+    map(~Mask) = 0;
+    fwrite(fd(m), map, 'float32');
+  end
+
+  pr = fitprogress('update', pr, z1);
+
+end
+
+for m = 1:nout
+  fclose(fd(m));
+end
+
+fitprogress('done', pr);
+
+if isfield(s, 'tmpfile')
+  delete(s.tmpfile);
+end
+
+%------------------------------------------------------------
+% Source description for slab reads
+%------------------------------------------------------------
+function s = src_open(src)
+
+if exist(src, 'dir')
+
+  % Paravision 2dseq
+  if isequal(parxacqmeth(src),'pvm')
+    [info,status] = pvmloadinfo(src);
+    vscale = 1e-3; % microns to mm
+  else
+    [info,status] = parxloadinfo(src);
+    vscale = 1;
+  end
+  if status < 0
+    error('streamfitn : could not load information files for %s', src);
+  end
+
+  s.filename = fullfile(src,'pdata','1','2dseq');
+  s.offset = 0;
+  switch info.byteorder
+    case 'littleEndian'
+      s.byteorder = 'ieee-le';
+    otherwise
+      s.byteorder = 'ieee-be';
+  end
+  switch info.recodepth
+    case 32
+      s.precision = 'int32'; s.bytes = 4;
+    case 16
+      s.precision = 'int16'; s.bytes = 2;
+  end
+
+  d = info.recodim(:)';
+  d(end+1:4) = 1;
+  s.dims = [d(1:3) prod(d(4:end))];
+
+  % Same calibration as parxload2dseq
+  cal_min = info.map_slope(1);
+  cal_max = info.map_max(1);
+  vox_min = info.minima(1);
+  vox_max = info.maxima(1);
+  s.slope = (cal_max - cal_min) / (vox_max - vox_min);
+  s.inter = cal_min - vox_min * s.slope;
+
+  v = info.vsize(:)';
+  v(end+1:3) = 1;
+  s.pixdim = v(1:3) * vscale;
+
+else
+
+  % NIfTI-1, decompressed to a temporary file if gzipped
+  if length(src) > 3 && strcmpi(src(end-2:end), '.gz')
+    tmpdir = tempname;
+    f = gunzip(src, tmpdir);
+    s.tmpfile = f{1};
+    src = f{1};
+  end
+
+  s.filename = src;
+
+  fd = fopen(src, 'r', 'ieee-le');
+  if fd < 1
+    error('streamfitn : could not open %s', src);
+  end
+  s.byteorder = 'ieee-le';
+  if fread(fd, 1, 'int32') ~= 348
+    fclose(fd);
+    fd = fopen(src, 'r', 'ieee-be');
+    s.byteorder = 'ieee-be';
+  end
+
+  fseek(fd, 40, 'bof');
+  dim = fread(fd, 8, 'int16')';
+  fseek(fd, 70, 'bof');
+  datatype = fread(fd, 1, 'int16');
+  fseek(fd, 76, 'bof');
+  pixdim = fread(fd, 8, 'float32')';
+  fseek(fd, 108, 'bof');
+  s.offset = fread(fd, 1, 'float32');
+  slope = fread(fd, 1, 'float32');
+  inter = fread(fd, 1, 'float32');
+  fclose(fd);
+
+  d = ones(1, 7);
+  d(1:dim(1)) = dim(2:dim(1)+1);
+  s.dims = [d(1:3) prod(d(4:end))];
+  s.pixdim = pixdim(2:4);
+
+  if slope == 0
+    slope = 1; inter = 0;
+  end
+  s.slope = slope;
+  s.inter = inter;
+
+  switch datatype
+    case 2,   s.precision = 'uint8';   s.bytes = 1;
+    case 4,   s.precision = 'int16';   s.bytes = 2;
+    case 8,   s.precision = 'int32';   s.bytes = 4;
+    case 16,  s.precision = 'float32'; s.bytes = 4;
+    case 64,  s.precision = 'float64'; s.bytes = 8;
+    case 256, s.precision = 'int8';    s.bytes = 1;
+    case 512, s.precision = 'uint16';  s.bytes = 2;
+    case 768, s.precision = 'uint32';  s.bytes = 4;
+    otherwise
+      error('streamfitn : unsupported NIfTI datatype %d', datatype);
+  end
+
+end
+
+%------------------------------------------------------------
+% Read slices z0:z1 of frames ft as double [nx ny nslab nf]
+% One contiguous read per frame
+%------------------------------------------------------------
+function S = src_read(s, z0, z1, ft)
+
+nx = s.dims(1); ny = s.dims(2); nz = s.dims(3);
+nsl = z1 - z0 + 1;
+nf = length(ft);
+
+fd = fopen(s.filename, 'r', s.byteorder);
+if fd < 1
+  error('streamfitn : could not open %s', s.filename);
+end
+
+S = zeros(nx, ny, nsl, nf);
+
+for k = 1:nf
+  pos = s.offset + ((ft(k) - 1) * nz + (z0 - 1)) * nx * ny * s.bytes;
+  fseek(fd, pos, 'bof');
+  d = fread(fd, nx * ny * nsl, ['*' s.precision]);
+  S(:,:,:,k) = reshape(double(d) * s.slope + s.inter, [nx ny nsl]);
+end
+
+fclose(fd);
+
+%------------------------------------------------------------
+% Create a float32 NIfTI-1 file and write its header
+% Returns the file handle positioned at the voxel data
+%------------------------------------------------------------
+function fd = nii_create(fname, dims, pixdim)
+
+fd = fopen(fname, 'w', 'ieee-le');
+if fd < 1
+  error('streamfitn : could not open %s to write', fname);
+end
+
+dim = ones(1,8);
+dim(1) = 3;
+dim(2:4) = dims;
+pd = ones(1,8);
+pd(2:4) = pixdim;
+
+fwrite(fd, 348, 'int32');           % sizeof_hdr
+fwrite(fd, zeros(1,10), 'uint8');   % data_type
+fwrite(fd, zeros(1,18), 'uint8');   % db_name
+fwrite(fd, 0, 'int32');             % extents
+fwrite(fd, 0, 'int16');             % session_error
+fwrite(fd, 'r', 'uchar');           % regular
+fwrite(fd, 0, 'uint8');             % dim_info
+fwrite(fd, dim, 'int16');
+fwrite(fd, zeros(1,3), 'float32');  % intent_p1-3
+fwrite(fd, 0, 'int16');             % intent_code
+fwrite(fd, 16, 'int16');            % datatype float32
+fwrite(fd, 32, 'int16');            % bitpix
+fwrite(fd, 0, 'int16');             % slice_start
+fwrite(fd, pd, 'float32');
+fwrite(fd, 352, 'float32');         % vox_offset
+fwrite(fd, [1 0], 'float32');       % scl_slope, scl_inter
+fwrite(fd, 0, 'int16');             % slice_end
+fwrite(fd, 0, 'uint8');             % slice_code
+fwrite(fd, 2, 'uint8');             % xyzt_units mm
+fwrite(fd, zeros(1,4), 'float32');  % cal_max, cal_min, slice_duration, toffset
+fwrite(fd, [0 0], 'int32');         % glmax, glmin
+fwrite(fd, zeros(1,80), 'uint8');   % descrip
+fwrite(fd, zeros(1,24), 'uint8');   % aux_file
+fwrite(fd, [0 1], 'int16');         % qform_code, sform_code
+fwrite(fd, zeros(1,6), 'float32');  % quatern_b-d, qoffset_x-z
+fwrite(fd, [pd(2) 0 0 0], 'float32');
+fwrite(fd, [0 pd(3) 0 0], 'float32');
+fwrite(fd, [0 0 pd(4) 0], 'float32');
+fwrite(fd, zeros(1,16), 'uint8');   % intent_name
+fwrite(fd, ['n+1' 0], 'uchar');     % magic
+fwrite(fd, zeros(1,4), 'uint8');    % no extensions
@@ -1,5 +1,5 @@
-function [M0, T2, C, Mask] = t2fitn(TE, S, verbose, M0_0, T2_0, C_0)
-% [M0, T2, C, Mask] = t2fitn(TE, S, verbose, M0_0, T2_0, C_0)
+function [M0, T2, C, Mask, Q] = t2fitn(TE, S, verbose, M0_0, T2_0, C_0, method, mask)
+% [M0, T2, C, Mask, Q] = t2fitn(TE, S, verbose, M0_0, T2_0, C_0, method, mask)
 %
 % Fit the T2 contrast equation:
 %
@@ -11,18 +11,30 @@ function [M0, T2, C, Mask] = t2fitn(TE, S, verbose, M0_0, T2_0, C_0)
 % TE = echo time vector for the final dimension (ms)
 % S  = N-D matrix with echo time as final dimension
 % verbose = 0 (none), 1 (text), 2 (graph)
+% M0_0, T2_0, C_0 = optional initial estimate maps [relaxinit closed form estimates]
+% method = 'lsq' or 'varpro' (M0 and C solved in closed form, T2 searched) ['lsq']
+% mask = fit mask replacing the relative threshold, eg a global mask
+%        from streamfitn [10% of the maximum at the shortest TE]
 %
 % RETURNS:
 % M0 = S(TE=0) matrix
 % T2 = T2 matrix in ms
 % C  = baseline offset
 % Mask = fit mask used for calculation
+% Q    = Cramer-Rao variance, residual and iteration maps from relaxfit_mex
+%        (see relaxstats), parameters ordered [M0 T2 C]. Empty without the MEX
 %
 % AUTHOR : Mike Tyszka, Ph.D.
 % PLACE  : Caltech BIC
 % DATES  : 09/06/2001 JMT Adapt from srfit.m
 %          01/26/2004 JMT Update with mask
 %          09/19/2005 JMT Add initial value args
+%          10/19/2026 JMT Use threaded relaxfit_mex when compiled
+%          10/19/2026 JMT Add varpro method
+%          10/19/2026 JMT Vectorized closed form initial estimates
+%          10/19/2026 JMT Throttled progress reports with stage timing
+%          10/19/2026 JMT Return Cramer-Rao variance and fit quality maps
+%          10/19/2026 JMT Optional fit mask
 %
 % The MIT License (MIT)
 %
@@ -46,6 +58,8 @@ if nargin < 3 verbose = 0; end
 if nargin < 4 M0_0 = []; end
 if nargin < 5 T2_0 = []; end
 if nargin < 6 C_0 = []; end
+if nargin < 7 method = 'lsq'; end
+if nargin < 8 mask = []; end
 
 % Get dimensions
 dims = size(S);
@@ -59,6 +73,8 @@ M0 = [];
 T2 = [];
 C  = [];
 Mask = [];
+Q = [];
+V = [];
 
 % Check that enough TE values were provided
 if ~isequal(nte1, nte2)
@@ -68,6 +84,12 @@ else
   nte = nte1;
 end
 
+% Check that a supplied mask matches the voxel count
+if numel(mask) > 0 && numel(mask) ~= nvox
+  fprintf('Mask does not match the spatial dimensions of the data\n');
+  return
+end
+
 % Normalize maximum data to 1.0
 sf = max(S(:));
 S = S / sf;
@@ -83,95 +105,127 @@ M0_0 = M0_0(:);
 T2_0 = T2_0(:);
 C_0 = C_0(:);
 
-% Create a mask from the image with the shortest TE
-[minTE, tmin] = min(TE(:));
-maxS = S(:,tmin);
-Sthresh = max(maxS(:)) * 0.1;
-Mask = maxS > Sthresh;
+% Create a mask from the image with the shortest TE unless one was supplied
+if isempty(mask)
+  [minTE, tmin] = min(TE(:));
+  maxS = S(:,tmin);
+  Sthresh = max(maxS(:)) * 0.1;
+  Mask = maxS > Sthresh;
+else
+  Mask = logical(mask(:));
+end
 
 nmask = sum(Mask);
 
-% Optimization options
-mode = 'unconstrained';
-options = optimset('lsqcurvefit');
-options = optimset(options,...
-  'TolFun',1e-4,...
-  'TolX',1e-4,...
-  'Jacobian','on',...
-  'Largescale','off',...
-  'Display','off');
+pr = fitprogress('start', 't2fitn', nmask, verbose > 0);
+
+% Closed form initial estimates for all mask voxels, overridden where supplied
+if ~strcmp(method, 'varpro')
+  pr = fitprogress('stage', pr, 'init');
+  P0 = relaxinit('expc', TE, S(Mask,:));
+  P0 = init_col(P0, 1, M0_0, Mask, true);
+  P0 = init_col(P0, 2, T2_0, Mask, true);
+  P0 = init_col(P0, 3, C_0, Mask, false);
+end
+
+pr = fitprogress('stage', pr, 'fit');
+
+% Variable projection, threaded relaxfit_mex or per-voxel lsqcurvefit
+if strcmp(method, 'varpro')
 
-% Update interval in voxels
-dv = round(nmask / 100);
+  % Variable projection needs no initial estimates
+  [P, resnorm, niter, V] = varprofitn('expc', TE, S(Mask,:), [-Inf 0 -Inf], [Inf Inf Inf]);
+
+  M0(Mask) = P(:,1);
+  T2(Mask) = P(:,2);
+  C(Mask)  = P(:,3);
+
+elseif exist('relaxfit_mex','file') == 3
+
+  [P, resnorm, niter, V] = relaxfit_mex('expc', TE(:)', double(S(Mask,:)), P0, [-Inf -Inf -Inf], [Inf Inf Inf]);
+
+  M0(Mask) = P(:,1);
+  T2(Mask) = P(:,2);
+  C(Mask)  = P(:,3);
+
+  if verbose > 0
+    fprintf('t2fitn : %0.1f iterations/voxel\n', mean(niter));
+  end
+
+else
 
-% Mask voxel counter
-count = 0;
+  % Optimization options
+  mode = 'unconstrained';
+  options = optimset('lsqcurvefit');
+  options = optimset(options,...
+    'TolFun',1e-4,...
+    'TolX',1e-4,...
+    'Jacobian','on',...
+    'Largescale','off',...
+    'Display','off');
 
-% Start stopwatch for VPS
-t0 = clock;
+  vm = find(Mask);
 
-for v = 1:nvox
+  for count = 1:nmask
+
+    v = vm(count);
 
-  if Mask(v)
-    
-    % Update mask voxel counter
-    count = count + 1;
-    
     %---------------------------------------------------
     % Fit T2 relaxation curve for single voxel time-course
     %---------------------------------------------------
 
     % Extract current voxel echo train
     Sv = S(v,:);
-    
-    % Setup initial estimates if available
-    if isempty(M0_0)
-      M0_0v = [];
-    else
-      M0_0v = M0_0(v);
-    end
-    if isempty(T2_0)
-      T2_0v = [];
-    else
-      T2_0v = T2_0(v);
-    end
-    if isempty(C_0)
-      C_0v = [];
-    else
-      C_0v = C_0(v);
-    end
 
-    % Call T2 fit function
-    [M0(v), T2(v), C(v), S_fit] = t2fit(TE,Sv,mode,options,M0_0v,T2_0v,C_0v);
-
-    % Update waitbar progress
-    if (mod(v,dv) == 0)
-        
-      fp = count/(nmask+eps);
-      vps = v/(etime(clock,t0)+eps);
-      res_str = sprintf('%5.1f%% done %0.3f vox/s : M0 = %0.3f T2 = %0.3fms C = %0.3f', fp*100,vps,M0(v),T2(v),C(v));
-      
-      switch verbose
-        case 1
-          disp(res_str);
-        case 2
-          figure(1); clf;
-          plot(TE,Sv,'o',TE,S_fit);
-          set(gca,'YLim',[0 max(Sv) * 1.1]);
-          title(res_str);
-          drawnow;
-        otherwise
-          % Do nothing
+    % Call T2 fit function from the closed form estimates
+    [M0(v), T2(v), C(v), S_fit] = t2fit(TE,Sv,mode,options,P0(count,1),P0(count,2),P0(count,3));
+
+    % Throttled progress report
+    if count >= pr.next
+
+      res_str = sprintf('M0 = %0.3f T2 = %0.3fms C = %0.3f', M0(v),T2(v),C(v));
+      pr = fitprogress('update', pr, count, res_str);
+
+      if verbose == 2 && pr.reported
+        figure(1); clf;
+        plot(TE,Sv,'o',TE,S_fit);
+        set(gca,'YLim',[0 max(Sv) * 1.1]);
+        title(res_str);
+        drawnow;
       end
 
     end
 
   end
+
 end
 
+fitprogress('done', pr);
+
 % Reshape maps back to Ndims-1
 vdims = dims(1:(ndims-1));
 M0 = reshape(M0, vdims) * sf; % Restore scaling
 T2 = reshape(T2, vdims);
 C  = reshape(C,  vdims) * sf; % Restore scaling
 Mask = reshape(Mask, vdims);
+
+% Cramer-Rao variance, residual and iteration maps from the native fit
+if ~isempty(V)
+  Q = relaxstats(Mask, V, resnorm, niter, [sf 1 sf], sf);
+end
+
+%------------------------------------------------------------
+% Replace column k of P0 with supplied initial estimates x0
+% Zero estimates are ignored if zdef is true (t2fit default)
+%------------------------------------------------------------
+function P0 = init_col(P0, k, x0, Mask, zdef)
+
+if isempty(x0), return; end
+
+x0 = x0(Mask);
+if zdef
+  ok = x0 ~= 0;
+else
+  ok = true(size(x0));
+end
+P0(ok,k) = x0(ok);
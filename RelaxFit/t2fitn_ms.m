@@ -25,6 +25,7 @@ function [M0, T2, C, Mask] = t2fitn_ms(TE, S, scalefactors, verbose)
 % DATES  : 09/06/2001 JMT Adapt from srfit.m
 %          01/26/2004 JMT Update with mask
 %          09/19/2005 JMT Add initial value args
+%          10/19/2026 JMT Throttled progress reports replace waitbar
 %
 % The MIT License (MIT)
 %
@@ -44,7 +45,7 @@ function [M0, T2, C, Mask] = t2fitn_ms(TE, S, scalefactors, verbose)
 %   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 % Default args
-if nargin < 3 verbose = 0; end
+if nargin < 4 verbose = 0; end
 
 % Default returns
 M0 = [];
@@ -120,14 +121,11 @@ for sf = scalefactors
     'Largescale','off',...
     'Display','off');
 
-  % Start clock
-  t0 = clock;
-
   % Mask voxel counter
   vcount = 0;
-  
-  % Create waitbar
-  hwb = waitbar(0,'Searching for first voxel');
+
+  % Progress reports for this scale
+  pr = fitprogress('start', sprintf('t2fitn_ms scale %d', sf), nmask, verbose > 0);
   
   for yc = 1:nyd
     for xc = 1:nxd
@@ -147,43 +145,30 @@ for sf = scalefactors
         % Call T2 fit function
         [M0d(xc,yc), T2d(xc,yc), Cd(xc,yc), S_fit] = t2fit(TE,Sv,mode,options,M0_0(xc,yc),T2_0(xc,yc),C_0(xc,yc));
         
-        if mod(vcount,10) == 0
-
-          % Update waitbar progress
-          fp = vcount/(nmask+eps);
-          vps = vcount/(etime(clock,t0)+eps);
-          trem = (nmask - vcount) / vps;
-          [hr,mn,sc] = hms(trem);
-          res_str = sprintf('%5.1f%% -%02dh%02dm%0.1fs', fp*100,hr,mn,sc);
-          waitbar(fp,hwb,res_str);
-
-          switch verbose
-            case 1
-              disp(res_str);
-            case 2
-              figure(1); clf;
-              subplot(221), imagesc(Sdwn(:,:,1)); axis image off; title('S(0)');
-              subplot(222), imagesc(M0d(:,:,1)); axis image off; title('M(0)');
-              subplot(223), imagesc(T2d(:,:,1)); axis image off; title('T2');
-              subplot(224), plot(TE,Sv,'o',TE,S_fit); axis tight; title(res_str);
-              drawnow;
-            otherwise
-              % Do nothing
+        if vcount >= pr.next
+
+          % Throttled progress report
+          pr = fitprogress('update', pr, vcount);
+
+          if verbose == 2 && pr.reported
+            res_str = sprintf('%5.1f%% done', 100 * vcount / nmask);
+            figure(1); clf;
+            subplot(221), imagesc(Sdwn(:,:,1)); axis image off; title('S(0)');
+            subplot(222), imagesc(M0d(:,:,1)); axis image off; title('M(0)');
+            subplot(223), imagesc(T2d(:,:,1)); axis image off; title('T2');
+            subplot(224), plot(TE,Sv,'o',TE,S_fit); axis tight; title(res_str);
+            drawnow;
           end
-          
-        end % Waitbar conditional
+
+        end % Progress conditional
 
       end % Mask conditional
 
     end % x loop
   end % y loop
-  
-  dt = etime(clock,t0);
-  [hr,mn,sc] = hms(dt);
-  fprintf(' %02dh%02dm%0.1fs\n',hr,mn,sc);
-  
-  % Close waitbar
-  close(hwb);
+
+  % Close progress reports for this scale
+  fitprogress('done', pr);
 
   % Restore maps to 2D and save as estimate for next scale
   M0d = reshape(M0d,nxd,nyd);
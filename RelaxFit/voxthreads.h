@@ -0,0 +1,148 @@
+/************************************************************
+ * Voxel-parallel work distribution for MEX fitting engines
+ *
+ * vox_parallel() runs worker(ctx, v0, v1, tid) over chunks
+ * [v0, v1) of nvox voxels on nthreads POSIX threads. Chunks are
+ * handed out from a shared counter, so threads that finish early
+ * take the remaining work from threads stuck on slow voxels.
+ * Chunks start large and shrink towards the end of the volume
+ * (guided self-scheduling) to keep the tail balanced.
+ *
+ * Workers must not call the MEX API. Allocate any per-thread
+ * workspace with malloc() indexed by tid.
+ *
+ * AUTHOR : Mike Tyszka, Ph.D.
+ * PLACE  : Caltech BIC
+ * DATES  : 10/19/2026 JMT From scratch
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Mike Tyszka
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ *   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ *   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ *   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ *   Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ *   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ *   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ************************************************************/
+
+#ifndef VOXTHREADS_H
+#define VOXTHREADS_H
+
+#include <pthread.h>
+#include <unistd.h>
+
+#define VOX_MAXTHREADS 256
+#define VOX_MINCHUNK   16
+
+typedef void (*vox_worker)(void *ctx, int v0, int v1, int tid);
+
+typedef struct {
+  vox_worker worker;
+  void *ctx;
+  int nvox;
+  int nthreads;
+  int next;
+  pthread_mutex_t lock;
+} vox_queue;
+
+typedef struct {
+  vox_queue *q;
+  int tid;
+} vox_thread;
+
+/************************************************************
+ * Default thread count is the number of online processors
+ ************************************************************/
+static int vox_nthreads(int nthreads)
+{
+  long ncpu;
+
+  if (nthreads > 0) return (nthreads > VOX_MAXTHREADS) ? VOX_MAXTHREADS : nthreads;
+
+  ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+  if (ncpu < 1) ncpu = 1;
+  if (ncpu > VOX_MAXTHREADS) ncpu = VOX_MAXTHREADS;
+
+  return (int)ncpu;
+}
+
+/************************************************************
+ * Take the next chunk from the shared queue
+ * Returns 0 when no voxels remain
+ ************************************************************/
+static int vox_take(vox_queue *q, int *v0, int *v1)
+{
+  int n;
+
+  pthread_mutex_lock(&q->lock);
+
+  *v0 = q->next;
+  n = (q->nvox - q->next) / (2 * q->nthreads);
+  if (n < VOX_MINCHUNK) n = VOX_MINCHUNK;
+  *v1 = *v0 + n;
+  if (*v1 > q->nvox) *v1 = q->nvox;
+  q->next = *v1;
+
+  pthread_mutex_unlock(&q->lock);
+
+  return *v1 > *v0;
+}
+
+static void *vox_run(void *arg)
+{
+  vox_thread *th = (vox_thread *)arg;
+  int v0, v1;
+
+  while (vox_take(th->q, &v0, &v1)) {
+    th->q->worker(th->q->ctx, v0, v1, th->tid);
+  }
+
+  return NULL;
+}
+
+/************************************************************
+ * Run worker over all voxels on nthreads threads
+ * The calling thread works as thread 0.
+ ************************************************************/
+static void vox_parallel(int nvox, int nthreads, vox_worker worker, void *ctx)
+{
+  pthread_t pt[VOX_MAXTHREADS];
+  vox_thread th[VOX_MAXTHREADS];
+  vox_queue q;
+  int n, started[VOX_MAXTHREADS];
+
+  q.worker = worker;
+  q.ctx = ctx;
+  q.nvox = nvox;
+  q.nthreads = nthreads;
+  q.next = 0;
+  pthread_mutex_init(&q.lock, NULL);
+
+  for (n = 0; n < nthreads; n++) {
+    th[n].q = &q;
+    th[n].tid = n;
+  }
+
+  /* Fall back to fewer threads if creation fails */
+  for (n = 1; n < nthreads; n++) {
+    started[n] = (pthread_create(&pt[n], NULL, vox_run, &th[n]) == 0);
+  }
+
+  vox_run(&th[0]);
+
+  for (n = 1; n < nthreads; n++) {
+    if (started[n]) pthread_join(pt[n], NULL);
+  }
+
+  pthread_mutex_destroy(&q.lock);
+}
+
+#endif /* VOXTHREADS_H */
@@ -0,0 +1,274 @@
+/************************************************************
+ * C source for spgrfit_mex MEX object
+ *
+ * SYNTAX: [P, resnorm, niter] = spgrfit_mex(TR, TE, alpha, S, P0, lb, ub)
+ *         [P, resnorm, niter] = spgrfit_mex(TR, TE, alpha, S, P0, lb, ub, B1, nthreads)
+ *
+ * Batched bounded Levenberg-Marquardt fit of the ideal spoiled
+ * gradient echo (SPGR) equation, as in spgreq,
+ *
+ *   S = M0 (1 - E1) sin(a) / (1 - E1 cos(a)) exp(-TE/T2*)
+ *
+ * with E1 = exp(-TR/T1) and a = B1 * alpha, to every row of S.
+ * Voxels are distributed over POSIX threads. With two columns in
+ * P0 the T2* decay is absorbed into M0 (single echo time data).
+ *
+ * TR       = repetition times in ms (1 x n)
+ * TE       = echo times in ms (1 x n)
+ * alpha    = nominal flip angles in degrees (1 x n)
+ * S        = signal, one voxel per row (nvox x n)
+ * P0       = starting estimates [M0 T1 T2*] or [M0 T1] (nvox x np)
+ * lb, ub   = parameter bounds (1 x np)
+ * B1       = relative flip angle scale per voxel (nvox x 1) or [] [1]
+ * nthreads = number of threads, 0 for all processors [0]
+ *
+ * P        = fitted parameters (nvox x np)
+ * resnorm  = residual sum of squares (nvox x 1)
+ * niter    = LM iterations used (nvox x 1)
+ *
+ * BUILD  : mex -I../RelaxFit spgrfit_mex.c
+ *
+ * AUTHOR : Mike Tyszka, Ph.D.
+ * PLACE  : Caltech BIC
+ * DATES  : 10/19/2026 JMT Adapt from spgrfit.m
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Mike Tyszka
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ *   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ *   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ *   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ *   Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ *   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ *   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ *   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ************************************************************/
+
+#include <stdlib.h>
+#include <math.h>
+#include "mex.h"
+
+#include "relaxfit.h"
+#include "voxthreads.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* Input Arguments */
+
+#define	TR_IN       prhs[0]
+#define	TE_IN       prhs[1]
+#define	ALPHA_IN    prhs[2]
+#define	S_IN        prhs[3]
+#define	P0_IN       prhs[4]
+#define	LB_IN       prhs[5]
+#define	UB_IN       prhs[6]
+#define	B1_IN       prhs[7]
+#define	NTHREADS_IN prhs[8]
+
+/* Output Arguments */
+
+#define	P_OUT       plhs[0]
+#define	RESNORM_OUT plhs[1]
+#define	NITER_OUT   plhs[2]
+
+typedef struct {
+  const rf_model *m;
+  const double *TR;
+  const double *TE;
+  const double *alpha;
+  const double *S;
+  const double *P0;
+  const double *lb;
+  const double *ub;
+  const double *B1;
+  double *P;
+  double *resnorm;
+  double *niter;
+  int nvox;
+  int n;
+  double *work[VOX_MAXTHREADS];
+} spgr_context;
+
+static void spgr_eval3(const double *, const double *, int, double *, double *);
+static void spgr_eval2(const double *, const double *, int, double *, double *);
+static void spgr_worker(void *, int, int, int);
+
+/* The sample "times" passed to the models are [TR TE a] (3 x n) */
+static const rf_model spgr_model3 = {"spgr", 3, spgr_eval3, 0, 0, 0, NULL, NULL};
+static const rf_model spgr_model2 = {"spgr1te", 2, spgr_eval2, 0, 0, 0, NULL, NULL};
+
+/************************************************************
+ * Entry point for MEX call
+ ************************************************************/
+void mexFunction(int nlhs, mxArray *plhs[],
+		 int nrhs, const mxArray *prhs[])
+{
+  spgr_context ctx;
+  int np, nthreads, t, ok;
+
+  /* Check for proper number of arguments */
+
+  if (nrhs < 7 || nrhs > 9 || nlhs > 3) {
+    mexErrMsgTxt("SYNTAX: [P,resnorm,niter] = spgrfit_mex(TR,TE,alpha,S,P0,lb,ub[,B1,nthreads])");
+  }
+
+  if (!mxIsDouble(S_IN) || mxIsComplex(S_IN) || !mxIsDouble(P0_IN) ||
+      !mxIsDouble(TR_IN) || !mxIsDouble(TE_IN) || !mxIsDouble(ALPHA_IN))
+    mexErrMsgTxt("spgrfit_mex : TR, TE, alpha, S and P0 must be real double");
+
+  ctx.n = (int)mxGetNumberOfElements(TR_IN);
+  ctx.nvox = (int)mxGetM(S_IN);
+  np = (int)mxGetN(P0_IN);
+
+  if ((int)mxGetNumberOfElements(TE_IN) != ctx.n || (int)mxGetNumberOfElements(ALPHA_IN) != ctx.n ||
+      (int)mxGetN(S_IN) != ctx.n)
+    mexErrMsgTxt("spgrfit_mex : TR, TE, alpha and the columns of S must match");
+
+  if ((np != 2 && np != 3) || (int)mxGetM(P0_IN) != ctx.nvox)
+    mexErrMsgTxt("spgrfit_mex : P0 must be nvox x 2 or nvox x 3");
+
+  if ((int)mxGetNumberOfElements(LB_IN) != np || (int)mxGetNumberOfElements(UB_IN) != np)
+    mexErrMsgTxt("spgrfit_mex : lb and ub must have np elements");
+
+  ctx.m = (np == 3) ? &spgr_model3 : &spgr_model2;
+  ctx.TR = mxGetPr(TR_IN);
+  ctx.TE = mxGetPr(TE_IN);
+  ctx.alpha = mxGetPr(ALPHA_IN);
+  ctx.S = mxGetPr(S_IN);
+  ctx.P0 = mxGetPr(P0_IN);
+  ctx.lb = mxGetPr(LB_IN);
+  ctx.ub = mxGetPr(UB_IN);
+
+  ctx.B1 = NULL;
+  if (nrhs > 7 && !mxIsEmpty(B1_IN)) {
+    if (!mxIsDouble(B1_IN) || (int)mxGetNumberOfElements(B1_IN) != ctx.nvox)
+      mexErrMsgTxt("spgrfit_mex : B1 must be a double vector with one value per voxel");
+    ctx.B1 = mxGetPr(B1_IN);
+  }
+
+  nthreads = vox_nthreads((nrhs > 8) ? (int)mxGetScalar(NTHREADS_IN) : 0);
+
+  P_OUT = mxCreateDoubleMatrix(ctx.nvox, np, mxREAL);
+  RESNORM_OUT = mxCreateDoubleMatrix(ctx.nvox, 1, mxREAL);
+  NITER_OUT = mxCreateDoubleMatrix(ctx.nvox, 1, mxREAL);
+
+  ctx.P = mxGetPr(P_OUT);
+  ctx.resnorm = mxGetPr(RESNORM_OUT);
+  ctx.niter = mxGetPr(NITER_OUT);
+
+  if (ctx.nvox < 1 || ctx.n < 1) return;
+
+  if (nthreads > (ctx.nvox + VOX_MINCHUNK - 1) / VOX_MINCHUNK)
+    nthreads = (ctx.nvox + VOX_MINCHUNK - 1) / VOX_MINCHUNK;
+
+  /* Per-thread workspace: sequence, signal and LM workspace */
+  ok = 1;
+  for (t = 0; t < nthreads; t++) {
+    ctx.work[t] = (double *)malloc((size_t)ctx.n * (np + 7) * sizeof(double));
+    if (ctx.work[t] == NULL) ok = 0;
+  }
+
+  if (ok) vox_parallel(ctx.nvox, nthreads, spgr_worker, &ctx);
+
+  for (t = 0; t < nthreads; t++) free(ctx.work[t]);
+
+  if (!ok) mexErrMsgTxt("spgrfit_mex : out of memory");
+
+  return;
+}
+
+/************************************************************
+ * SPGR signal and Jacobian for p = [M0 T1 T2*]
+ * q holds TR, TE and the flip angle in radians (3 x n)
+ ************************************************************/
+static void spgr_eval3(const double *p, const double *q, int n, double *f, double *J)
+{
+  const double *TR = q, *TE = q + n, *a = q + 2 * n;
+  double T1 = (p[1] > RF_TMIN) ? p[1] : RF_TMIN;
+  double T2s = (p[2] > RF_TMIN) ? p[2] : RF_TMIN;
+  double E1, E2, c, s, D, F;
+  int k;
+
+  for (k = 0; k < n; k++) {
+    E1 = exp(-TR[k] / T1);
+    E2 = exp(-TE[k] / T2s);
+    c = cos(a[k]);
+    s = sin(a[k]);
+    D = 1.0 - E1 * c;
+    F = (1.0 - E1) * s / D;
+    f[k] = p[0] * F * E2;
+    if (J) {
+      J[k]       = F * E2;
+      J[k + n]   = p[0] * E2 * s * (c - 1.0) / (D * D) * E1 * TR[k] / (T1 * T1);
+      J[k + 2*n] = f[k] * TE[k] / (T2s * T2s);
+    }
+  }
+}
+
+/************************************************************
+ * SPGR signal and Jacobian for p = [M0 T1], T2* decay in M0
+ ************************************************************/
+static void spgr_eval2(const double *p, const double *q, int n, double *f, double *J)
+{
+  const double *TR = q, *a = q + 2 * n;
+  double T1 = (p[1] > RF_TMIN) ? p[1] : RF_TMIN;
+  double E1, c, s, D, F;
+  int k;
+
+  for (k = 0; k < n; k++) {
+    E1 = exp(-TR[k] / T1);
+    c = cos(a[k]);
+    s = sin(a[k]);
+    D = 1.0 - E1 * c;
+    F = (1.0 - E1) * s / D;
+    f[k] = p[0] * F;
+    if (J) {
+      J[k]     = F;
+      J[k + n] = p[0] * s * (c - 1.0) / (D * D) * E1 * TR[k] / (T1 * T1);
+    }
+  }
+}
+
+/************************************************************
+ * Fit voxels [v0, v1) on thread tid
+ ************************************************************/
+static void spgr_worker(void *arg, int v0, int v1, int tid)
+{
+  spgr_context *ctx = (spgr_context *)arg;
+  int n = ctx->n, nvox = ctx->nvox, np = ctx->m->np;
+  double *q = ctx->work[tid];
+  double *s = q + 3 * n;
+  double p[RF_MAXP], b1;
+  int v, k, i, it;
+
+  for (k = 0; k < n; k++) {
+    q[k] = ctx->TR[k];
+    q[k + n] = ctx->TE[k];
+  }
+
+  for (v = v0; v < v1; v++) {
+
+    /* Effective flip angles for this voxel */
+    b1 = (ctx->B1 != NULL) ? ctx->B1[v] : 1.0;
+    for (k = 0; k < n; k++) {
+      q[k + 2*n] = b1 * ctx->alpha[k] * M_PI / 180.0;
+      s[k] = ctx->S[v + (size_t)k * nvox];
+    }
+
+    for (i = 0; i < np; i++) p[i] = ctx->P0[v + (size_t)i * nvox];
+
+    ctx->resnorm[v] = rf_lm_fit(ctx->m, q, s, n, p, ctx->lb, ctx->ub,
+				100, 1e-6, s + n, &it);
+    ctx->niter[v] = it;
+
+    for (i = 0; i < np; i++) ctx->P[v + (size_t)i * nvox] = p[i];
+  }
+}
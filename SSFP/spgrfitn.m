@@ -0,0 +1,220 @@
+function [M0, T1, T2s, Mask, resnorm] = spgrfitn(S, TR, TE, alpha, B1, opts)
+% [M0, T1, T2s, Mask, resnorm] = spgrfitn(S, TR, TE, alpha, B1, opts)
+%
+% Whole-volume variable flip angle (DESPOT1) T1, T2* and M0 mapping
+% from spoiled gradient echo data, the volume equivalent of spgrfit.
+%
+% A vectorized closed form first pass estimates T2* by log-linear
+% regression over echo times within each (TR, flip angle) group, then
+% T1 and M0 from the linearized DESPOT1 transform of the T2* corrected
+% signal,
+%
+%   S / sin(a) = E1 S / tan(a) + M0 (1 - E1)
+%
+% using the B1 corrected flip angle a = B1 * alpha. These estimates
+% start a bounded nonlinear refinement of the full SPGR equation
+% (spgreq) in one threaded call to spgrfit_mex when compiled, otherwise
+% lsqnonlin voxel by voxel. The linear pass assumes a common TR; with
+% mixed TRs the mean TR is used there and the refinement corrects it.
+%
+% ARGS :
+% S     = N-D signal magnitudes with the SPGR samples as the final dimension
+% TR    = TR (ms) for each sample, or scalar
+% TE    = TE (ms) for each sample, or scalar
+% alpha = nominal flip angle (degrees) for each sample
+% B1    = relative flip angle map (N-D, size of one sample volume) [1]
+% opts  = optional structure with fields
+%   Mask     = voxels to fit [max signal > 10% of maximum]
+%   refine   = nonlinear refinement after the linear pass [1]
+%   lb, ub   = refinement bounds for [M0 T1 T2*] [0 1 0.1] and [Inf 1e5 1e4]
+%   nthreads = number of threads, 0 for all processors [0]
+%   verbose  = progress and timing reports [0]
+%
+% RETURNS :
+% M0      = equilibrium Mz map (AU), including T2* decay at TE if no T2* fit
+% T1      = T1 map (ms)
+% T2s     = T2* map (ms), empty if each (TR, flip angle) has a single TE
+% Mask    = fit mask used
+% resnorm = residual sum of squares map
+%
+% AUTHOR : Mike Tyszka, Ph.D.
+% PLACE  : Caltech BIC
+% DATES  : 10/19/2026 JMT Adapt from spgrfit.m
+% REFS   : Deoni SCL et al. Magn Reson Med 2003; 49:515-526
+%
+% The MIT License (MIT)
+%
+% Copyright (c) 2016 Mike Tyszka
+%
+%   Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+%   documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+%   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+%   permit persons to whom the Software is furnished to do so, subject to the following conditions:
+%
+%   The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+%   Software.
+%
+%   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+%   WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+%   COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+%   OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+% Default args
+if nargin < 5 B1 = []; end
+if nargin < 6 opts = struct(); end
+if ~isfield(opts, 'Mask') opts.Mask = []; end
+if ~isfield(opts, 'refine') opts.refine = 1; end
+if ~isfield(opts, 'lb') opts.lb = [0 1 0.1]; end
+if ~isfield(opts, 'ub') opts.ub = [Inf 1e5 1e4]; end
+if ~isfield(opts, 'nthreads') opts.nthreads = 0; end
+if ~isfield(opts, 'verbose') opts.verbose = 0; end
+
+% Get dimensions
+dims = size(S);
+ndims = length(dims);
+nvox = prod(dims(1:(ndims-1)));
+n = dims(ndims);
+
+% Sequence parameters as row vectors, one per sample
+TR = TR(:)' .* ones(1,n);
+TE = TE(:)' .* ones(1,n);
+alpha = alpha(:)';
+if length(alpha) ~= n
+  error('spgrfitn : alpha does not match final dimension of data');
+end
+
+S = reshape(double(abs(S)), [nvox n]);
+
+% Default mask from the brightest sample
+Mask = opts.Mask;
+if isempty(Mask)
+  Smax = max(S, [], 2);
+  Mask = Smax > max(Smax) * 0.1;
+end
+Mask = Mask(:) ~= 0;
+nmask = sum(Mask);
+
+Sm = S(Mask,:);
+if isempty(B1)
+  b1 = ones(nmask,1);
+else
+  b1 = double(B1(Mask));
+end
+
+pr = fitprogress('start', 'spgrfitn', nmask, opts.verbose > 0);
+
+%------------------------------------------------------------
+% Closed form first pass
+%------------------------------------------------------------
+pr = fitprogress('stage', pr, 'linear');
+
+% Centering within groups of samples sharing TR and flip angle
+[u, ui, g] = unique([TR(:) alpha(:)], 'rows');
+A = double(bsxfun(@eq, g(:), g(:)'));
+H = eye(n) - bsxfun(@rdivide, A, sum(A, 2));
+TEc = TE * H;
+fit_t2s = any(abs(TEc) > 1e-6 * max(abs(TE)));
+
+lb = opts.lb;
+ub = opts.ub;
+
+if fit_t2s
+  % Pooled log-linear T2* slope across groups
+  L = log(max(Sm, realmin));
+  slope = (L * H) * TEc' / (TEc * TEc');
+  T2s_m = -1 ./ slope;
+  T2s_m(~(T2s_m > 0)) = ub(3);
+  T2s_m = min(max(T2s_m, lb(3)), ub(3));
+  Sc = Sm .* exp(bsxfun(@rdivide, TE, T2s_m));
+else
+  lb = lb(1:2);
+  ub = ub(1:2);
+  Sc = Sm;
+end
+
+% DESPOT1 linear regression with B1 corrected flip angles
+a = b1 * (alpha * pi / 180);
+y = Sc ./ sin(a);
+x = Sc ./ tan(a);
+xc = bsxfun(@minus, x, mean(x, 2));
+yc = bsxfun(@minus, y, mean(y, 2));
+E1 = sum(xc .* yc, 2) ./ sum(xc.^2, 2);
+
+TRm = mean(TR);
+E1lo = exp(-TRm / max(lb(2), eps));
+E1hi = exp(-TRm / ub(2));
+E1(~(E1 > E1lo)) = E1lo;
+E1(~(E1 < E1hi)) = E1hi;
+T1_m = -TRm ./ log(E1);
+
+% M0 by linear least squares against the SPGR shape
+F = (1 - exp(-bsxfun(@rdivide, TR, T1_m))) .* sin(a) ./ ...
+  (1 - exp(-bsxfun(@rdivide, TR, T1_m)) .* cos(a));
+if fit_t2s
+  F = F .* exp(-bsxfun(@rdivide, TE, T2s_m));
+end
+M0_m = sum(F .* Sm, 2) ./ max(sum(F.^2, 2), realmin);
+
+if fit_t2s
+  P = [M0_m T1_m T2s_m];
+else
+  P = [M0_m T1_m];
+end
+P = min(max(P, repmat(lb, nmask, 1)), repmat(ub, nmask, 1));
+rn = sum((Sm - bsxfun(@times, P(:,1), F)).^2, 2);
+
+%------------------------------------------------------------
+% Bounded nonlinear refinement
+%------------------------------------------------------------
+pr = fitprogress('stage', pr, 'refine');
+
+if opts.refine && nmask > 0
+
+  if exist('spgrfit_mex','file') == 3
+
+    [P, rn] = spgrfit_mex(TR, TE, alpha, Sm, P, lb, ub, b1, opts.nthreads);
+
+  else
+
+    lsqopts = optimset('lsqnonlin');
+    lsqopts = optimset(lsqopts, 'Display', 'off', 'TolFun', 1e-9, 'TolX', 1e-9);
+    np = size(P, 2);
+
+    for v = 1:nmask
+      Sv = Sm(v,:)';
+      av = alpha(:) * b1(v);
+      if np == 3
+        err = @(p) Sv - spgreq(TR(:), TE(:), av, p(2), p(3), p(1));
+      else
+        err = @(p) Sv - spgreq(TR(:), TE(:), av, p(2), Inf, p(1));
+      end
+      [P(v,:), rn(v)] = lsqnonlin(err, P(v,:), lb, ub, lsqopts);
+      if v >= pr.next, pr = fitprogress('update', pr, v); end
+    end
+
+  end
+
+end
+
+fitprogress('done', pr);
+
+% Scatter back into full maps
+vdims = dims(1:(ndims-1));
+if length(vdims) == 1 vdims = [vdims 1]; end
+
+M0 = zeros(nvox,1); M0(Mask) = P(:,1);
+T1 = zeros(nvox,1); T1(Mask) = P(:,2);
+resnorm = zeros(nvox,1); resnorm(Mask) = rn;
+
+M0 = reshape(M0, vdims);
+T1 = reshape(T1, vdims);
+resnorm = reshape(resnorm, vdims);
+
+if fit_t2s
+  T2s = zeros(nvox,1); T2s(Mask) = P(:,3);
+  T2s = reshape(T2s, vdims);
+else
+  T2s = [];
+end
+
+Mask = reshape(Mask, vdims);